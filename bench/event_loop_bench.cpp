@@ -0,0 +1,221 @@
+/**
+ * @brief Compares the epoll event loop with the old thread per client model.
+ *
+ * Every model runs in its own child process. The child listens on a local port, a thread in the
+ * same process opens the connections and the child reports how fast they were accepted and how
+ * much resident memory and how many threads the idle connections cost.
+ *
+ * Usage: bench_event_loop [connections]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <net/socket.h>
+#include <net/event_loop.h>
+#include <theater/framer.h>
+
+/**
+ * @brief An idle client, holds the same per connection state in both models.
+ */
+class BenchClient : public Net::Socket
+{
+	private:
+		Theater::Framer _framer;
+
+	public:
+		BenchClient(int socket, const sockaddr_in& address)
+		{
+			this->_socket = socket;
+			this->_address = address;
+		}
+
+		bool onReadable() override
+		{
+			while(true)
+			{
+				size_t buffer_size;
+				unsigned char* buffer = this->_framer.GetWriteBuffer(buffer_size);
+				ssize_t recv_size = read(this->_socket, buffer, buffer_size);
+
+				if(recv_size > 0)
+				{
+					this->_framer.Commit(recv_size);
+					continue;
+				}
+
+				return (recv_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+			}
+		}
+
+		/**
+		 * @brief Blocking read loop of the old thread per client model.
+		 */
+		void Listen()
+		{
+			while(true)
+			{
+				std::vector<unsigned char> buffer(4096, 0);
+
+				if(read(this->_socket, &(buffer[0]), 4096) <= 0)
+				{
+					break;
+				}
+			}
+		}
+};
+
+/**
+ * @brief Read a field in kB or a count from /proc/self/status.
+ */
+static long ReadStatus(const std::string& key)
+{
+	std::ifstream file("/proc/self/status");
+	std::string line;
+
+	while(std::getline(file, line))
+	{
+		if(line.compare(0, key.size(), key) == 0 && line[key.size()] == ':')
+		{
+			return std::strtol(line.c_str() + key.size() + 1, nullptr, 10);
+		}
+	}
+
+	return 0;
+}
+
+static void Run(const std::string& model, size_t connections)
+{
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	int option = 1;
+	sockaddr_in address = {};
+
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+
+	if(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 4096) < 0)
+	{
+		perror("listen");
+		exit(EXIT_FAILURE);
+	}
+
+	socklen_t address_size = sizeof(address);
+	getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_size);
+
+	std::unique_ptr<Net::EventLoop> event_loop;
+
+	if(model == "epoll")
+	{
+		event_loop = std::make_unique<Net::EventLoop>(2);
+	}
+
+	long rss_before = ReadStatus("VmRSS");
+	long threads_before = ReadStatus("Threads");
+
+	std::vector<int> client_sockets;
+	std::thread connector([&]() {
+		for(size_t i = 0; i < connections; i++)
+		{
+			int client_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+			if(connect(client_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+			{
+				perror("connect");
+				exit(EXIT_FAILURE);
+			}
+
+			client_sockets.push_back(client_socket);
+		}
+	});
+
+	std::vector<std::shared_ptr<BenchClient>> clients;
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < connections; i++)
+	{
+		sockaddr_in client_address;
+		socklen_t client_address_size = sizeof(client_address);
+		int client_socket = accept(listener, reinterpret_cast<sockaddr*>(&client_address), &client_address_size);
+
+		if(client_socket < 0)
+		{
+			perror("accept");
+			exit(EXIT_FAILURE);
+		}
+
+		std::shared_ptr<BenchClient> client = std::make_shared<BenchClient>(client_socket, client_address);
+
+		if(event_loop)
+		{
+			fcntl(client_socket, F_SETFL, fcntl(client_socket, F_GETFL) | O_NONBLOCK);
+			event_loop->Add(client);
+		}
+		else
+		{
+			std::thread(&BenchClient::Listen, client).detach();
+		}
+
+		clients.push_back(client);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	connector.join();
+
+	// Let the threads settle on their first read
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	long rss = ReadStatus("VmRSS") - rss_before;
+	long threads = ReadStatus("Threads") - threads_before;
+
+	std::printf("%-8s %8zu connections %10.0f accepts/s %8ld kB RSS %6.2f kB/connection %6ld threads\n",
+	            model.c_str(), connections, connections / seconds, rss, static_cast<double>(rss) / connections, threads);
+	std::fflush(stdout);
+
+	// Exit without tearing the blocked threads down
+	_exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t connections = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+	for(const char* model : { "threads", "epoll" })
+	{
+		pid_t pid = fork();
+
+		if(pid == 0)
+		{
+			Run(model, connections);
+		}
+
+		int status;
+		waitpid(pid, &status, 0);
+
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+		{
+			std::cerr << model << " failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/**
+ * @brief Compares the compiled favorites with the old split and find per game.
+ *
+ * Every request carries 50 favorite games and 50 favorite players and is counted against a full
+ * region, every game has 8 players. The old matchmaker split the favorites for every request
+ * and searched every name for every favorite with std::string::find.
+ *
+ * Usage: bench_favorites [requests]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <util.h>
+#include <mohrs/game.h>
+#include <mohrs/player.h>
+#include <mohrs/favorites.h>
+#include <theater/parameter_view.h>
+
+/**
+ * @brief Count the favorites like the old matchmaker did.
+ */
+static void OldCount(const Theater::ParameterView& parameter, const std::vector<MoHRS::GamePtr>& games, int& num_fav_games, int& num_fav_players)
+{
+	std::string_view str_fav_games, str_fav_players;
+
+	if(!parameter.Get("FAV-GAME", str_fav_games) || !parameter.Get("FAV-PLAYER", str_fav_players))
+	{
+		return;
+	}
+
+	std::vector<std::string> fav_games = Util::splitFavorite(std::string(str_fav_games));
+	std::vector<std::string> fav_players = Util::splitFavorite(std::string(str_fav_players));
+
+	for(const MoHRS::GamePtr& game : games)
+	{
+		std::string game_name(game->GetName());
+
+		for(const std::string& fav_game : fav_games)
+		{
+			if(game_name.find(fav_game) != std::string::npos)
+			{
+				num_fav_games++;
+				break;
+			}
+		}
+
+		for(const MoHRS::Player& player : game->GetPlayers())
+		{
+			std::string player_name(player.GetName());
+
+			for(const std::string& fav_player : fav_players)
+			{
+				if(player_name.find(fav_player) != std::string::npos)
+				{
+					num_fav_players++;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Create a full region.
+ */
+static std::vector<MoHRS::GamePtr> MakeRegion(size_t num_games)
+{
+	std::vector<MoHRS::GamePtr> games;
+
+	for(size_t i = 0; i < num_games; i++)
+	{
+		MoHRS::Game game;
+
+		game.SetName("Rising Sun Server " + std::to_string(i));
+		game.SetMaxPlayers(8);
+
+		for(size_t j = 0; j < MoHRS::MAX_PLAYERS; j++)
+		{
+			MoHRS::Player player;
+
+			player.SetName("Soldier_" + std::to_string(i * MoHRS::MAX_PLAYERS + j));
+			game.AddPlayer(player);
+		}
+
+		games.push_back(std::make_shared<const MoHRS::Game>(game));
+	}
+
+	return games;
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t requests = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200;
+	std::string data = "TID=4 LOBBY-ID=1 FAV-GAME=\"";
+
+	// 50 favorite games and players, spread over the region
+	for(size_t i = 0; i < 50; i++)
+	{
+		data += ((i > 0) ? ";" : "") + std::string("Server ") + std::to_string(i * 37);
+	}
+
+	data += "\" FAV-PLAYER=\"";
+
+	for(size_t i = 0; i < 50; i++)
+	{
+		data += ((i > 0) ? ";" : "") + std::string("Soldier_") + std::to_string(i * 131);
+	}
+
+	data += "\"";
+
+	Theater::ParameterView parameter(data);
+
+	for(size_t num_games : { 250, 1000, 4000 })
+	{
+		std::vector<MoHRS::GamePtr> games = MakeRegion(num_games);
+		int old_games = 0, old_players = 0;
+		int new_games = 0, new_players = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for(size_t i = 0; i < requests; i++)
+		{
+			OldCount(parameter, games, old_games, old_players);
+		}
+
+		auto middle = std::chrono::steady_clock::now();
+
+		for(size_t i = 0; i < requests; i++)
+		{
+			MoHRS::Favorites favorites(parameter);
+
+			favorites.Count(games, new_games, new_players);
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		std::printf("%5zu games: split and find %9.1f us/request, Aho-Corasick %9.1f us/request\n", num_games,
+		            std::chrono::duration<double, std::micro>(middle - start).count() / requests,
+		            std::chrono::duration<double, std::micro>(end - middle).count() / requests);
+
+		if(old_games != new_games || old_players != new_players)
+		{
+			std::fprintf(stderr, "old and new found different favorites\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,452 @@
+/**
+ * @brief Compares the inline game layout with the old game that owned its strings and players.
+ *
+ * The old Game held five std::string and a std::vector of players with two std::string each,
+ * and returned the IP, host player and theater session by value. The benchmark reports the
+ * bytes a game takes, inline and on the heap, and how many games per second two region scans
+ * visit:
+ *
+ *  - count: the games of a region and their players, only the hot fields are read.
+ *  - list: the fields of a game listing, the name, IP, host player and player counts.
+ *
+ * The old and inline variants walk the games of all regions in a vector like the old matchmaker
+ * did. The hot column variant keeps id, region and player counts in a separate array next to the
+ * games, the structure of arrays layout that was left out of the game store. The snapshot variant
+ * walks the shared games of a single region like the region snapshots of the matchmaker. Rates
+ * are games of the scanned region per second.
+ *
+ * Usage: bench_game_layout [rounds]
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include <malloc.h>
+
+#include <mohrs/game.h>
+#include <mohrs/player.h>
+#include <mohrs/region.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Heap bytes in use through new, the benchmark is single threaded.
+ */
+static size_t g_allocated = 0;
+
+/**
+ * @brief Keeps the scans from being optimized out.
+ */
+static volatile size_t g_sink = 0;
+
+void* operator new(size_t size)
+{
+	if(void* pointer = std::malloc(size))
+	{
+		g_allocated += malloc_usable_size(pointer);
+
+		return pointer;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	g_allocated -= malloc_usable_size(pointer);
+
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	operator delete(pointer);
+}
+
+/**
+ * @brief The player before the inline layout.
+ */
+class OldPlayer
+{
+	private:
+		std::string _name;
+		std::string _ticket;
+
+	public:
+		const std::string& GetName() const { return this->_name; }
+		std::string GetTicket() const { return this->_ticket; }
+
+		void SetName(const std::string& name) { this->_name = name; }
+		void SetTicket(const std::string& ticket) { this->_ticket = ticket; }
+};
+
+/**
+ * @brief The game before the inline layout.
+ */
+class OldGame
+{
+	private:
+		int                    _id = 0;
+		std::string            _ip;
+		std::string            _name;
+		MoHRS::Regions         _region = MoHRS::Regions::Unknown;
+		uint8_t                _num_players = 0;
+		uint8_t                _max_players = 0;
+		std::string            _host_player;
+		std::string            _theater_session;
+		std::vector<OldPlayer> _players;
+
+	public:
+		int                           GetId() const             { return this->_id;              }
+		std::string                   GetIp() const             { return this->_ip;              }
+		const std::string&            GetName() const           { return this->_name;            }
+		MoHRS::Regions                GetRegion() const         { return this->_region;          }
+		uint8_t                       GetNumPlayers() const     { return this->_num_players;     }
+		uint8_t                       GetMaxPlayers() const     { return this->_max_players;     }
+		std::string                   GetHostPlayer() const     { return this->_host_player;     }
+		std::string                   GetTheaterSession() const { return this->_theater_session; }
+		const std::vector<OldPlayer>& GetPlayers() const        { return this->_players;         }
+
+		void SetId(int id)                                         { this->_id = id;                           }
+		void SetIp(const std::string& ip)                          { this->_ip = ip;                           }
+		void SetName(const std::string& name)                      { this->_name = name;                       }
+		void SetRegion(MoHRS::Regions region)                      { this->_region = region;                   }
+		void SetNumPlayers(uint8_t num_players)                    { this->_num_players = num_players;         }
+		void SetMaxPlayers(uint8_t max_players)                    { this->_max_players = max_players;         }
+		void SetHostPlayer(const std::string& host_player)         { this->_host_player = host_player;         }
+		void SetTheaterSession(const std::string& theater_session) { this->_theater_session = theater_session; }
+		void AddPlayer(const OldPlayer& player)                    { this->_players.push_back(player);         }
+};
+
+/**
+ * @brief The hot fields of a game in a column next to the games.
+ */
+struct HotColumn
+{
+	int            id;
+	MoHRS::Regions region;
+	uint8_t        num_players;
+	uint8_t        max_players;
+};
+
+/**
+ * @brief The values of a game like a PS2 game server sends them.
+ */
+struct GameValues
+{
+	std::string              ip;
+	std::string              name;
+	MoHRS::Regions           region;
+	uint8_t                  num_players;
+	std::string              host_player;
+	std::string              theater_session;
+	std::vector<std::string> players;
+};
+
+static GameValues MakeValues(size_t number)
+{
+	GameValues values;
+
+	values.ip = "10.0." + std::to_string((number >> 8) & 0xFF) + "." + std::to_string(number & 0xFF);
+	values.name = "Pearl Harbor 24/7 Server " + std::to_string(number);
+	values.region = static_cast<MoHRS::Regions>(1 + number % 6);
+	values.num_players = static_cast<uint8_t>(1 + number % 8);
+	values.host_player = "Host" + std::to_string(number);
+	values.theater_session = values.ip + ":" + std::to_string(1024 + number % 60000);
+
+	for(size_t i = 0; i < values.num_players; i++)
+	{
+		values.players.push_back("Soldier" + std::to_string(number * 8 + i));
+	}
+
+	return values;
+}
+
+static OldGame MakeOldGame(size_t number, const GameValues& values)
+{
+	OldGame game;
+
+	game.SetId(static_cast<int>(number));
+	game.SetIp(values.ip);
+	game.SetName(values.name);
+	game.SetRegion(values.region);
+	game.SetNumPlayers(values.num_players);
+	game.SetMaxPlayers(8);
+	game.SetHostPlayer(values.host_player);
+	game.SetTheaterSession(values.theater_session);
+
+	for(const std::string& name : values.players)
+	{
+		OldPlayer player;
+		player.SetName(name);
+		player.SetTicket("1111");
+		game.AddPlayer(player);
+	}
+
+	return game;
+}
+
+static MoHRS::Game MakeGame(size_t number, const GameValues& values)
+{
+	MoHRS::Game game;
+
+	game.SetId(static_cast<int>(number));
+	game.SetIp(values.ip);
+	game.SetName(values.name);
+	game.SetRegion(values.region);
+	game.SetNumPlayers(values.num_players);
+	game.SetMaxPlayers(8);
+	game.SetHostPlayer(values.host_player);
+	game.SetTheaterSession(values.theater_session);
+
+	for(const std::string& name : values.players)
+	{
+		MoHRS::Player player;
+		player.SetName(name);
+		player.SetTicket("1111");
+		game.AddPlayer(player);
+	}
+
+	return game;
+}
+
+/**
+ * @brief Scan every region a number of times.
+ * @param visit Called with the region, returns the number of games in it.
+ * @return Games of the scanned regions per second.
+ */
+template<typename Visit>
+static double Scan(size_t rounds, Visit visit)
+{
+	size_t visited = 0;
+	Clock::time_point start = Clock::now();
+
+	for(size_t i = 0; i < rounds; i++)
+	{
+		visited += visit(static_cast<MoHRS::Regions>(1 + i % 6));
+	}
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	g_sink = g_sink + visited;
+
+	return visited / seconds;
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t rounds = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 600;
+
+	std::printf("sizeof: old game %zu, old player %zu, game %zu, player %zu, hot column %zu\n",
+	            sizeof(OldGame), sizeof(OldPlayer), sizeof(MoHRS::Game), sizeof(MoHRS::Player), sizeof(HotColumn));
+
+	for(size_t num_games : { 6000, 100000 })
+	{
+		std::vector<GameValues> values;
+
+		for(size_t i = 0; i < num_games; i++)
+		{
+			values.push_back(MakeValues(i));
+		}
+
+		std::vector<OldGame> old_games;
+		std::vector<MoHRS::Game> games;
+		std::vector<HotColumn> column;
+
+		old_games.reserve(num_games);
+		games.reserve(num_games);
+		column.reserve(num_games);
+
+		// Heap bytes of the strings and players, the vectors were reserved up front
+		size_t allocated = g_allocated;
+
+		for(size_t i = 0; i < num_games; i++)
+		{
+			old_games.push_back(MakeOldGame(i, values[i]));
+		}
+
+		double old_heap = static_cast<double>(g_allocated - allocated) / num_games;
+
+		allocated = g_allocated;
+
+		for(size_t i = 0; i < num_games; i++)
+		{
+			games.push_back(MakeGame(i, values[i]));
+			column.push_back({ games.back().GetId(), games.back().GetRegion(), games.back().GetNumPlayers(), games.back().GetMaxPlayers() });
+		}
+
+		double heap = static_cast<double>(g_allocated - allocated) / num_games;
+
+		std::array<std::vector<MoHRS::GamePtr>, MoHRS::NUM_REGIONS> snapshots;
+
+		for(const MoHRS::Game& game : games)
+		{
+			snapshots[MoHRS::GetRegionIndex(game.GetRegion())].push_back(std::make_shared<const MoHRS::Game>(game));
+		}
+
+		std::printf("%zu games, 1 to 8 players each\n", num_games);
+		std::printf("  bytes per game: old %zu inline + %.0f heap = %.0f, inline %zu + %.0f heap = %.0f\n",
+		            sizeof(OldGame), old_heap, sizeof(OldGame) + old_heap, sizeof(MoHRS::Game), heap, sizeof(MoHRS::Game) + heap);
+
+		size_t scan_rounds = rounds * 6000 / num_games;
+
+		double old_count = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(const OldGame& game : old_games)
+			{
+				if(game.GetRegion() == region)
+				{
+					sum += game.GetNumPlayers();
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double count = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(const MoHRS::Game& game : games)
+			{
+				if(game.GetRegion() == region)
+				{
+					sum += game.GetNumPlayers();
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double column_count = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(const HotColumn& hot : column)
+			{
+				if(hot.region == region)
+				{
+					sum += hot.num_players;
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double snapshot_count = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			const std::vector<MoHRS::GamePtr>& snapshot = snapshots[MoHRS::GetRegionIndex(region)];
+			uint64_t sum = 0;
+
+			for(const MoHRS::GamePtr& game : snapshot)
+			{
+				sum += game->GetNumPlayers();
+			}
+
+			g_sink = g_sink + sum;
+
+			return snapshot.size();
+		});
+
+		std::printf("  count scan M games/s: old %6.0f, inline %6.0f, hot column %6.0f, snapshot %6.0f\n",
+		            old_count / 1e6, count / 1e6, column_count / 1e6, snapshot_count / 1e6);
+
+		double old_list = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(const OldGame& game : old_games)
+			{
+				if(game.GetRegion() == region)
+				{
+					sum += game.GetName().size() + game.GetIp().size() + game.GetHostPlayer().size() + game.GetNumPlayers() + game.GetMaxPlayers();
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double list = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(const MoHRS::Game& game : games)
+			{
+				if(game.GetRegion() == region)
+				{
+					sum += game.GetName().size() + game.GetIp() + game.GetHostPlayer().size() + game.GetNumPlayers() + game.GetMaxPlayers();
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double column_list = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			size_t found = 0;
+			uint64_t sum = 0;
+
+			for(size_t i = 0; i < column.size(); i++)
+			{
+				if(column[i].region == region)
+				{
+					const MoHRS::Game& game = games[i];
+
+					sum += game.GetName().size() + game.GetIp() + game.GetHostPlayer().size() + column[i].num_players + column[i].max_players;
+					found++;
+				}
+			}
+
+			g_sink = g_sink + sum;
+
+			return found;
+		});
+
+		double snapshot_list = Scan(scan_rounds, [&](MoHRS::Regions region)
+		{
+			const std::vector<MoHRS::GamePtr>& snapshot = snapshots[MoHRS::GetRegionIndex(region)];
+			uint64_t sum = 0;
+
+			for(const MoHRS::GamePtr& game : snapshot)
+			{
+				sum += game->GetName().size() + game->GetIp() + game->GetHostPlayer().size() + game->GetNumPlayers() + game->GetMaxPlayers();
+			}
+
+			g_sink = g_sink + sum;
+
+			return snapshot.size();
+		});
+
+		std::printf("  list scan  M games/s: old %6.0f, inline %6.0f, hot column %6.0f, snapshot %6.0f\n",
+		            old_list / 1e6, list / 1e6, column_list / 1e6, snapshot_list / 1e6);
+	}
+
+	return EXIT_SUCCESS;
+}
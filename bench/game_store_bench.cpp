@@ -0,0 +1,177 @@
+/**
+ * @brief Compares the game store with the old vector of games.
+ *
+ * The store is filled with games spread over the regions, then every round updates a random
+ * game, lists a region and replaces a random game with a new one, like a server that hosts many
+ * games. The old matchmaker searched, updated and erased games with linear scans of a vector.
+ *
+ * Usage: bench_game_store [rounds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mohrs/game.h>
+#include <mohrs/region.h>
+#include <mohrs/game_store.h>
+
+/**
+ * @brief Create the game of a theater session.
+ */
+static MoHRS::Game MakeGame(size_t number)
+{
+	MoHRS::Game game;
+
+	game.SetId(static_cast<int>(number));
+	game.SetTheaterSession("10.0." + std::to_string((number >> 8) & 0xFF) + "." + std::to_string(number & 0xFF) +
+	                       ":" + std::to_string(1024 + number % 60000));
+	game.SetName("Game " + std::to_string(number));
+	game.SetRegion(static_cast<int8_t>(1 + number % 6));
+	game.SetMaxPlayers(8);
+	game.SetNumPlayers(1);
+
+	return game;
+}
+
+/**
+ * @brief Run the rounds on the game store.
+ * @return Nanoseconds per round.
+ */
+static double RunStore(const std::vector<MoHRS::Game>& games, size_t num_games, size_t rounds, size_t& visited)
+{
+	MoHRS::GameStore store;
+	std::vector<std::string> sessions;
+	std::mt19937 random(1);
+	size_t next = 0;
+
+	for(; next < num_games; next++)
+	{
+		store.Insert(games[next]);
+		sessions.push_back(std::string(games[next].GetTheaterSession()));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < rounds; i++)
+	{
+		size_t index = random() % sessions.size();
+
+		store.Update(sessions[index], [i](MoHRS::Game& game)
+		{
+			return game.SetNumPlayers(static_cast<uint8_t>(1 + i % 8));
+		});
+
+		store.ForEach(static_cast<MoHRS::Regions>(1 + i % 6), [&visited](const MoHRS::GamePtr& game)
+		{
+			visited += game->GetNumPlayers();
+		});
+
+		store.Remove(sessions[index]);
+
+		const MoHRS::Game& game = games[next++ % games.size()];
+
+		store.Insert(game);
+		sessions[index] = std::string(game.GetTheaterSession());
+	}
+
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+/**
+ * @brief Run the rounds on a vector like the old Matchmaker::_games.
+ * @return Nanoseconds per round.
+ */
+static double RunVector(const std::vector<MoHRS::Game>& games, size_t num_games, size_t rounds, size_t& visited)
+{
+	std::vector<MoHRS::Game> store;
+	std::vector<std::string> sessions;
+	std::mt19937 random(1);
+	size_t next = 0;
+
+	for(; next < num_games; next++)
+	{
+		store.push_back(games[next]);
+		sessions.push_back(std::string(games[next].GetTheaterSession()));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < rounds; i++)
+	{
+		size_t index = random() % sessions.size();
+		auto find = [&store](const std::string& session)
+		{
+			return std::find_if(store.begin(), store.end(), [&session](const MoHRS::Game& game)
+			{
+				return game.GetTheaterSession() == session;
+			});
+		};
+
+		auto it = find(sessions[index]);
+
+		if(it != store.end())
+		{
+			it->SetNumPlayers(static_cast<uint8_t>(1 + i % 8));
+		}
+
+		MoHRS::Regions region = static_cast<MoHRS::Regions>(1 + i % 6);
+
+		for(const MoHRS::Game& game : store)
+		{
+			if(game.GetRegion() == region)
+			{
+				visited += game.GetNumPlayers();
+			}
+		}
+
+		it = find(sessions[index]);
+
+		if(it != store.end())
+		{
+			store.erase(it);
+		}
+
+		const MoHRS::Game& game = games[next++ % games.size()];
+
+		store.push_back(game);
+		sessions[index] = std::string(game.GetTheaterSession());
+	}
+
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t rounds = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+	for(size_t num_games : { 10000, 30000, 100000 })
+	{
+		std::vector<MoHRS::Game> games;
+		size_t visited_store = 0;
+		size_t visited_vector = 0;
+
+		// Twice as many games as stored so a new game never has the session of a stored one
+		for(size_t i = 0; i < 2 * num_games; i++)
+		{
+			games.push_back(MakeGame(i));
+		}
+
+		double store = RunStore(games, num_games, rounds, visited_store);
+		double vector = RunVector(games, num_games, rounds, visited_vector);
+
+		std::printf("%7zu games: store %10.0f ns/round, vector %10.0f ns/round\n", num_games, store, vector);
+
+		if(visited_store != visited_vector)
+		{
+			std::fprintf(stderr, "store and vector visited different games\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
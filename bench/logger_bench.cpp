@@ -0,0 +1,128 @@
+/**
+ * @brief Compares the queued logger with the old logger that wrote every message under one mutex.
+ *
+ * Every producer thread logs transaction sized messages as fast as it can, like client threads
+ * that log every request. The old logger took a global mutex, formatted the time, wrote the line
+ * and flushed the file for every message. The benchmark reports how long the producers took and,
+ * for the queued logger, how long the writer took to drain and how many messages were dropped.
+ *
+ * Run it from the build directory, the logger writes to ../data/log like the server.
+ *
+ * Usage: bench_logger [producers] [messages per producer]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <util.h>
+#include <logger.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static const std::string MESSAGE = "127.0.0.1:1234 --> UGAM NUM-PLAYERS=2 PLAYER-NAME.1=\"Soldier\" TICKET.1=\"1111\"";
+
+/**
+ * @brief The logger before the queue, writes and flushes every message under a global mutex.
+ */
+class MutexLogger
+{
+	private:
+		std::ofstream _file;
+		std::mutex    _mutex;
+
+	public:
+		MutexLogger(const std::string& path) : _file(path, std::ios::app)
+		{
+
+		}
+
+		void info(const std::string& msg, const std::string& type)
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // logger lock
+
+			std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
+
+			this->_file << "[" << time << "]" << type << "[INFO] " << msg << std::endl;
+			this->_file.flush();
+		}
+};
+
+/**
+ * @brief Run the producers.
+ * @return Seconds till every producer is done.
+ */
+template<typename Log>
+static double Produce(size_t num_producers, size_t num_messages, Log log)
+{
+	std::vector<std::thread> threads;
+	Clock::time_point start = Clock::now();
+
+	for(size_t p = 0; p < num_producers; p++)
+	{
+		threads.emplace_back([num_messages, &log]()
+		{
+			for(size_t i = 0; i < num_messages; i++)
+			{
+				log(MESSAGE);
+			}
+		});
+	}
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t num_producers = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+	size_t num_messages = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 20000;
+	double total = static_cast<double>(num_producers * num_messages);
+
+	std::printf("%zu producers, %zu messages each\n", num_producers, num_messages);
+
+	// Queued logger, writes to data/log like the server
+	Logger::Initialize();
+
+	Clock::time_point start = Clock::now();
+	double produce = Produce(num_producers, num_messages, [](const std::string& msg)
+	{
+		Logger::info(msg, Server::Type::Theater, false);
+	});
+
+	Logger::Flush();
+
+	double drain = std::chrono::duration<double>(Clock::now() - start).count();
+	uint64_t dropped = Logger::GetNumDropped();
+
+	std::printf("queued: producers %8.0f ms, %6.0f ns/message per producer, drained in %8.0f ms, %9.0f written/s, %llu dropped\n",
+	            produce * 1e3, produce * 1e9 / num_messages, drain * 1e3, (total - dropped) / drain,
+	            static_cast<unsigned long long>(dropped));
+
+	// Mutex baseline
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "mohrs-logger-bench.log";
+	MutexLogger* mutex_logger = new MutexLogger(path.string());
+
+	produce = Produce(num_producers, num_messages, [mutex_logger](const std::string& msg)
+	{
+		mutex_logger->info(msg, "[Theater]");
+	});
+
+	std::printf("mutex:  producers %8.0f ms, %6.0f ns/message per producer, %9.0f written/s\n",
+	            produce * 1e3, produce * 1e9 / num_messages, total / produce);
+
+	delete mutex_logger;
+	std::filesystem::remove(path);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,320 @@
+/**
+ * @brief Compares the batched matchmaker with a matchmaker that applies every write under one mutex.
+ *
+ * Producer threads play game servers: every server creates its game with CGAM and then sends
+ * UGAM updates with a changing player count, round after round. The regions are filled with
+ * idle games first so publishing a snapshot has real work to do. The benchmark reports the
+ * writes per second and the latency from sending a CGAM till the game is committed.
+ *
+ * Every matchmaker runs twice. In the flood run the producers send as fast as they can, so the
+ * latency includes the queue that builds up. In the paced run every server waits for its game
+ * to be committed before it sends the next request, like a real game server waits for the CGAM
+ * response.
+ *
+ * The mutex baseline is the matchmaker before the write queue: every CGAM and UGAM takes the
+ * matchmaker lock, changes the game store and publishes a new snapshot of the region.
+ *
+ * Usage: bench_matchmaker [producers] [servers per producer] [rounds]
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+
+#include <globals.h>
+#include <mohrs/event_bus.h>
+#include <mohrs/game_store.h>
+#include <mohrs/matchmaker.h>
+#include <theater/client.h>
+#include <theater/parameter_view.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief The matchmaker before the write queue, a single lock around the store and the snapshots.
+ */
+class MutexMatchmaker
+{
+	private:
+		std::mutex                                                                       _mutex;
+		MoHRS::GameStore                                                                 _games;
+		std::array<std::shared_ptr<const MoHRS::RegionSnapshot>, MoHRS::NUM_REGIONS>     _snapshots;
+		int                                                                              _next_id = 1;
+
+		void _publishSnapshot(MoHRS::Regions region)
+		{
+			size_t index = MoHRS::GetRegionIndex(region);
+			std::shared_ptr<MoHRS::RegionSnapshot> snapshot = std::make_shared<MoHRS::RegionSnapshot>();
+
+			snapshot->version = (this->_snapshots[index] ? this->_snapshots[index]->version : 0) + 1;
+			snapshot->games.reserve(this->_games.Size(region));
+
+			this->_games.ForEach(region, [&snapshot](const MoHRS::GamePtr& game)
+			{
+				snapshot->games.push_back(game);
+			});
+
+			std::atomic_store(&this->_snapshots[index], std::shared_ptr<const MoHRS::RegionSnapshot>(std::move(snapshot)));
+		}
+
+	public:
+		void createGame(const Theater::Client& client, const Theater::ParameterView& parameter, const MoHRS::Matchmaker::CreateCallback& on_created)
+		{
+			MoHRS::Game game;
+			MoHRS::Player player;
+
+			game.SetName(parameter.Get("NAME"));
+			game.SetRegion(parameter.Get("REGION-ID"));
+			game.SetMaxPlayers(parameter.Get("MAX-PLAYERS"));
+			game.SetHostPlayer(parameter.Get("HOST-PLAYER"));
+			game.SetNumPlayers(1);
+			game.SetIp(client.GetIP());
+			game.SetTheaterSession(client.GetAddress());
+			player.SetName(parameter.Get("HOST-PLAYER"));
+			game.AddPlayer(player);
+
+			{
+				std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+				MoHRS::GamePtr old_game = this->_games.Remove(client.GetAddress());
+
+				if(old_game)
+				{
+					this->_publishSnapshot(old_game->GetRegion());
+				}
+
+				game.SetId(this->_next_id++);
+				game = *this->_games.Insert(game);
+				this->_publishSnapshot(game.GetRegion());
+			}
+
+			on_created(game);
+		}
+
+		void updateGame(const Theater::Client& client, const Theater::ParameterView& parameter)
+		{
+			uint8_t num_players = 0;
+
+			std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+			MoHRS::GamePtr game = this->_games.Update(client.GetAddress(), [&](MoHRS::Game& game)
+			{
+				num_players = game.GetNumPlayers();
+
+				return game.SetNumPlayers(parameter.Get("NUM-PLAYERS")) && game.GetNumPlayers() != num_players;
+			});
+
+			if(game)
+			{
+				this->_publishSnapshot(game->GetRegion());
+			}
+		}
+};
+
+/**
+ * @brief A game server that sends requests.
+ */
+struct GameServer
+{
+	Theater::Client*          client;
+	std::string               cgam;
+	std::vector<std::string>  ugam;
+};
+
+/**
+ * @brief Create game servers, the clients are never destroyed since disconnecting needs the theater server.
+ */
+static std::vector<GameServer> MakeServers(size_t first, size_t count)
+{
+	std::vector<GameServer> servers;
+
+	for(size_t i = first; i < first + count; i++)
+	{
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(0x0A000000 | static_cast<uint32_t>(i >> 16));
+		address.sin_port = htons(static_cast<uint16_t>(i & 0xFFFF));
+
+		GameServer server;
+		server.client = new Theater::Client(-1, address);
+		server.cgam = "REGION-ID=" + std::to_string(1 + i % 6) + " NAME=\"Server " + std::to_string(i) +
+		              "\" MAX-PLAYERS=8 HOST-PLAYER=\"Host" + std::to_string(i) + "\"";
+
+		for(int players = 2; players <= 5; players++)
+		{
+			server.ugam.push_back("NUM-PLAYERS=" + std::to_string(players) + " PLAYER-NAME.1=\"Host" + std::to_string(i) + "\" TICKET.1=\"1111\"");
+		}
+
+		servers.push_back(std::move(server));
+	}
+
+	return servers;
+}
+
+/**
+ * @brief Result of a run.
+ */
+struct Result
+{
+	double writes_per_second;
+	double p50;
+	double p99;
+};
+
+/**
+ * @brief Run the producers against a matchmaker.
+ * @param create Sends a CGAM, calls the callback once the game is committed.
+ * @param update Sends a UGAM.
+ * @param writes_done Returns true once every sent write is applied.
+ * @param paced Wait for every CGAM to be committed before sending the next request.
+ */
+template<typename Create, typename Update, typename Done>
+static Result Run(std::vector<std::vector<GameServer>>& producers, size_t rounds, Create create, Update update, Done writes_done, bool paced)
+{
+	size_t num_servers = producers.size() * producers[0].size();
+	std::vector<double> latencies(num_servers * rounds);
+	std::atomic<size_t> committed{0};
+	std::vector<std::thread> threads;
+
+	Clock::time_point start = Clock::now();
+
+	for(size_t p = 0; p < producers.size(); p++)
+	{
+		threads.emplace_back([&, p]()
+		{
+			std::vector<GameServer>& servers = producers[p];
+
+			for(size_t round = 0; round < rounds; round++)
+			{
+				for(size_t s = 0; s < servers.size(); s++)
+				{
+					double* latency = &latencies[(p * servers.size() + s) * rounds + round];
+					Clock::time_point sent = Clock::now();
+					std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+
+					create(*servers[s].client, Theater::ParameterView(servers[s].cgam), [latency, sent, done, &committed](const MoHRS::Game&)
+					{
+						*latency = std::chrono::duration<double, std::micro>(Clock::now() - sent).count();
+						done->store(true, std::memory_order_release);
+						committed.fetch_add(1, std::memory_order_release);
+					});
+
+					while(paced && !done->load(std::memory_order_acquire))
+					{
+						std::this_thread::yield();
+					}
+
+					for(const std::string& ugam : servers[s].ugam)
+					{
+						update(*servers[s].client, Theater::ParameterView(ugam));
+					}
+				}
+			}
+		});
+	}
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	while(committed.load(std::memory_order_acquire) < latencies.size() || !writes_done())
+	{
+		std::this_thread::yield();
+	}
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	size_t writes = latencies.size() * (1 + producers[0][0].ugam.size());
+
+	std::sort(latencies.begin(), latencies.end());
+
+	return { writes / seconds, latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100] };
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t num_producers = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4;
+	size_t num_servers = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 256;
+	size_t rounds = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 20;
+	const size_t num_idle = 6000;
+
+	g_event_bus = new MoHRS::EventBus();
+
+	std::vector<GameServer> idle = MakeServers(0, num_idle);
+	std::vector<std::vector<GameServer>> producers;
+
+	for(size_t p = 0; p < num_producers; p++)
+	{
+		producers.push_back(MakeServers(num_idle + p * num_servers, num_servers));
+	}
+
+	std::printf("%zu producers, %zu servers each, %zu rounds of 1 CGAM and 4 UGAM, %zu idle games\n",
+	            num_producers, num_servers, rounds, num_idle);
+
+	MutexMatchmaker mutex_matchmaker;
+	MoHRS::Matchmaker* matchmaker = new MoHRS::Matchmaker();
+	std::atomic<size_t> idle_created{0};
+
+	for(GameServer& server : idle)
+	{
+		mutex_matchmaker.createGame(*server.client, Theater::ParameterView(server.cgam), [](const MoHRS::Game&) {});
+		matchmaker->createGame(*server.client, Theater::ParameterView(server.cgam), [&idle_created](const MoHRS::Game&)
+		{
+			idle_created++;
+		});
+	}
+
+	while(idle_created < num_idle)
+	{
+		std::this_thread::yield();
+	}
+
+	for(bool paced : { false, true })
+	{
+		const char* mode = paced ? "paced" : "flood";
+
+		Result result = Run(producers, rounds,
+			[&](const Theater::Client& client, const Theater::ParameterView& parameter, MoHRS::Matchmaker::CreateCallback on_created)
+			{
+				mutex_matchmaker.createGame(client, parameter, on_created);
+			},
+			[&](const Theater::Client& client, const Theater::ParameterView& parameter)
+			{
+				mutex_matchmaker.updateGame(client, parameter);
+			},
+			[]() { return true; }, paced);
+
+		std::printf("%s mutex   %9.0f writes/s, CGAM p50 %8.1f us, p99 %8.1f us\n", mode, result.writes_per_second, result.p50, result.p99);
+
+		uint64_t writes_before = matchmaker->GetNumWrites();
+		uint64_t batches_before = matchmaker->GetNumBatches();
+		uint64_t expected = num_producers * num_servers * rounds * 5;
+
+		result = Run(producers, rounds,
+			[&](const Theater::Client& client, const Theater::ParameterView& parameter, MoHRS::Matchmaker::CreateCallback on_created)
+			{
+				matchmaker->createGame(client, parameter, std::move(on_created));
+			},
+			[&](const Theater::Client& client, const Theater::ParameterView& parameter)
+			{
+				matchmaker->updateGame(client, parameter);
+			},
+			[&]() { return matchmaker->GetNumWrites() - writes_before >= expected; }, paced);
+
+		std::printf("%s batched %9.0f writes/s, CGAM p50 %8.1f us, p99 %8.1f us, %.1f writes/batch\n", mode,
+		            result.writes_per_second, result.p50, result.p99,
+		            static_cast<double>(expected) / (matchmaker->GetNumBatches() - batches_before));
+	}
+
+	// The applier threads are detached and keep running, the matchmaker is never destroyed
+	return EXIT_SUCCESS;
+}
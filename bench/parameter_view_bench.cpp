@@ -0,0 +1,142 @@
+/**
+ * @brief Compares the ParameterView parser with the old GetParameter parser.
+ *
+ * Both parsers read the same CGAM and UGAM requests and look up the keys the matchmaker reads.
+ * The requests are the data of frames a game server sends, captured from a local test server.
+ *
+ * Usage: bench_parameter_view [iterations]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <theater/parameter_view.h>
+
+/**
+ * @brief The parser of Theater::Client before ParameterView, as it was.
+ */
+static std::map<std::string, std::string> GetParameter(const std::string& data)
+{
+	std::istringstream iss(data);
+	std::map<std::string, std::string> parameter;
+
+	std::string token;
+	while (std::getline(iss, token, ' '))
+	{
+		// Skip empty tokens
+		if (token.empty()) {
+			continue;
+		}
+
+		// Find the position of '=' in the token
+		size_t equalPos = token.find('=');
+		if (equalPos != std::string::npos) {
+			// Split the token into key and value
+			std::string key = token.substr(0, equalPos);
+			std::string value = token.substr(equalPos + 1);
+
+			// Add key-value pair to the map
+			parameter[key] = value;
+		}
+	}
+
+	return parameter;
+}
+
+static const std::string CGAM =
+	"TID=5 LID=-1 RESERVE-HOST=0 NAME=\"MoH Rising Sun\" PORT=20004 HTTYPE=A TYPE=G QLEN=0 "
+	"DISABLE-AUTO-DEQUEUE=1 HXFR=0 INT-PORT=20004 INT-IP=192.168.1.20 MAX-PLAYERS=8 "
+	"B-maxObservers=0 B-numObservers=0 UGID=\"\" R-U-accountid=0 B-U-map=\"Pearl Harbor\" "
+	"B-U-type=\"DM\" B-U-time=\"20\" B-U-frags=\"50\" REGION-ID=1 HOST-PLAYER=\"Sergeant\"";
+
+static const std::string UGAM =
+	"TID=12 LID=1 GID=3 NAME=\"MoH Rising Sun\" NUM-PLAYERS=4 MAX-PLAYERS=8 "
+	"PLAYER-NAME.1=\"Sergeant\" TICKET.1=\"1111\" PLAYER-NAME.2=\"Private Ryan\" TICKET.2=\"1112\" "
+	"PLAYER-NAME.3=\"Miller\" TICKET.3=\"1113\" PLAYER-NAME.4=\"Upham\" TICKET.4=\"1114\" "
+	"B-U-map=\"Pearl Harbor\" B-U-time=\"14\"";
+
+static const std::vector<std::string> KEYS = {
+	"HOST-PLAYER", "NAME", "REGION-ID", "MAX-PLAYERS", "NUM-PLAYERS",
+	"PLAYER-NAME.1", "TICKET.1", "PLAYER-NAME.2", "TICKET.2",
+	"PLAYER-NAME.3", "TICKET.3", "PLAYER-NAME.4", "TICKET.4", "PLAYER-NAME.5",
+};
+
+/**
+ * @brief Parse every request and look up the keys with the old parser.
+ * @return Nanoseconds per request.
+ */
+static double RunOld(size_t iterations, size_t& found)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < iterations; i++)
+	{
+		for(const std::string& data : { CGAM, UGAM })
+		{
+			std::map<std::string, std::string> parameter = GetParameter(data);
+
+			for(const std::string& key : KEYS)
+			{
+				auto it = parameter.find(key);
+
+				if(it != parameter.end())
+				{
+					found += it->second.size();
+				}
+			}
+		}
+	}
+
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (2 * iterations);
+}
+
+/**
+ * @brief Parse every request and look up the keys with ParameterView.
+ * @return Nanoseconds per request.
+ */
+static double RunView(size_t iterations, size_t& found)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < iterations; i++)
+	{
+		for(std::string_view data : { std::string_view(CGAM), std::string_view(UGAM) })
+		{
+			Theater::ParameterView parameter(data);
+
+			for(const std::string& key : KEYS)
+			{
+				std::string_view value;
+
+				if(parameter.Get(key, value))
+				{
+					found += value.size();
+				}
+			}
+		}
+	}
+
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (2 * iterations);
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+	size_t found_old = 0;
+	size_t found_view = 0;
+
+	std::printf("%zu CGAM and UGAM requests\n", 2 * iterations);
+	std::printf("GetParameter   %8.1f ns/request\n", RunOld(iterations, found_old));
+	std::printf("ParameterView  %8.1f ns/request\n", RunView(iterations, found_view));
+
+	// The old parser cuts quoted values at the first space, so it finds fewer bytes
+	std::printf("bytes found: GetParameter %zu, ParameterView %zu\n", found_old, found_view);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,367 @@
+/**
+ * @brief Measures readers of the game list while writers change the games.
+ *
+ * Reader threads play clients that browse the games: every read picks a region, gets its games
+ * and sums their players like a listing does. Writer threads play game servers that send UGAM
+ * updates with a changing player count and every few rounds remove their game with RGAM and
+ * create it again with CGAM. The regions are filled with games first so a read has real work.
+ *
+ * The mutex baseline is the matchmaker before the snapshots: readers take the matchmaker lock
+ * and walk the games of the region while the writers take the same lock for every write. The
+ * matchmaker loads the snapshot of the region and walks it without waiting for the writers.
+ *
+ * Every configuration of readers and writers runs for a fixed time. The benchmark reports the
+ * reads per second of all readers, the latency of a single read and the writes per second.
+ *
+ * Usage: bench_snapshot [milliseconds per run] [games]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+
+#include <globals.h>
+#include <mohrs/event_bus.h>
+#include <mohrs/game_store.h>
+#include <mohrs/matchmaker.h>
+#include <theater/client.h>
+#include <theater/parameter_view.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Writes a batched writer may have queued before it waits for the appliers.
+ */
+static const uint64_t MAX_PENDING_WRITES = 4096;
+
+/**
+ * @brief The matchmaker before the snapshots, readers and writers share a single lock.
+ */
+class MutexMatchmaker
+{
+	private:
+		std::mutex       _mutex;
+		MoHRS::GameStore _games;
+		int              _next_id = 1;
+
+	public:
+		void createGame(const Theater::Client& client, const Theater::ParameterView& parameter)
+		{
+			MoHRS::Game game;
+			MoHRS::Player player;
+
+			game.SetName(parameter.Get("NAME"));
+			game.SetRegion(parameter.Get("REGION-ID"));
+			game.SetMaxPlayers(parameter.Get("MAX-PLAYERS"));
+			game.SetHostPlayer(parameter.Get("HOST-PLAYER"));
+			game.SetNumPlayers(1);
+			game.SetIp(client.GetIP());
+			game.SetTheaterSession(client.GetAddress());
+			player.SetName(parameter.Get("HOST-PLAYER"));
+			game.AddPlayer(player);
+
+			std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+			this->_games.Remove(client.GetAddress());
+
+			game.SetId(this->_next_id++);
+			this->_games.Insert(game);
+		}
+
+		void updateGame(const Theater::Client& client, const Theater::ParameterView& parameter)
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+			this->_games.Update(client.GetAddress(), [&](MoHRS::Game& game)
+			{
+				uint8_t num_players = game.GetNumPlayers();
+
+				return game.SetNumPlayers(parameter.Get("NUM-PLAYERS")) && game.GetNumPlayers() != num_players;
+			});
+		}
+
+		void removeGame(const std::string& address)
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+			this->_games.Remove(address);
+		}
+
+		uint64_t Read(MoHRS::Regions region)
+		{
+			uint64_t num_players = 0;
+
+			std::lock_guard<std::mutex> guard(this->_mutex); // matchmaker lock
+
+			this->_games.ForEach(region, [&num_players](const MoHRS::GamePtr& game)
+			{
+				num_players += game->GetNumPlayers();
+			});
+
+			return num_players;
+		}
+};
+
+/**
+ * @brief A game server that sends requests.
+ */
+struct GameServer
+{
+	Theater::Client*          client;
+	std::string               cgam;
+	std::vector<std::string>  ugam;
+};
+
+/**
+ * @brief Create game servers, the clients are never destroyed since disconnecting needs the theater server.
+ */
+static std::vector<GameServer> MakeServers(size_t first, size_t count)
+{
+	std::vector<GameServer> servers;
+
+	for(size_t i = first; i < first + count; i++)
+	{
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(0x0A000000 | static_cast<uint32_t>(i >> 16));
+		address.sin_port = htons(static_cast<uint16_t>(i & 0xFFFF));
+
+		GameServer server;
+		server.client = new Theater::Client(-1, address);
+		server.cgam = "REGION-ID=" + std::to_string(1 + i % 6) + " NAME=\"Server " + std::to_string(i) +
+		              "\" MAX-PLAYERS=8 HOST-PLAYER=\"Host" + std::to_string(i) + "\"";
+
+		for(int players = 1; players <= 8; players++)
+		{
+			server.ugam.push_back("NUM-PLAYERS=" + std::to_string(players));
+		}
+
+		servers.push_back(std::move(server));
+	}
+
+	return servers;
+}
+
+/**
+ * @brief Result of a run.
+ */
+struct Result
+{
+	double reads_per_second;
+	double p50;
+	double p99;
+	double max;
+	double writes_per_second;
+};
+
+/**
+ * @brief Run readers and writers against a matchmaker for a while.
+ * @param read Reads a region, returns the sum of its players.
+ * @param create Sends a CGAM.
+ * @param update Sends a UGAM.
+ * @param remove Sends a RGAM.
+ * @param wait Called by a writer after every step with the number of requests it just sent.
+ */
+template<typename Read, typename Create, typename Update, typename Remove, typename Wait>
+static Result Run(size_t num_readers, std::vector<std::vector<GameServer>>& writers, std::chrono::milliseconds duration,
+                  Read read, Create create, Update update, Remove remove, Wait wait)
+{
+	std::vector<std::vector<double>> latencies(num_readers);
+	std::atomic<bool> running{true};
+	std::atomic<uint64_t> num_writes{0};
+	std::atomic<uint64_t> checksum{0};
+	std::vector<std::thread> threads;
+
+	for(size_t r = 0; r < num_readers; r++)
+	{
+		threads.emplace_back([&, r]()
+		{
+			std::vector<double>& samples = latencies[r];
+			uint64_t sum = 0;
+
+			for(size_t i = r; running.load(std::memory_order_relaxed); i++)
+			{
+				Clock::time_point start = Clock::now();
+
+				sum += read(static_cast<MoHRS::Regions>(1 + i % 6));
+
+				samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+			}
+
+			checksum += sum;
+		});
+	}
+
+	for(size_t w = 0; w < writers.size(); w++)
+	{
+		threads.emplace_back([&, w]()
+		{
+			std::vector<GameServer>& servers = writers[w];
+			uint64_t sent = 0;
+
+			for(size_t round = 0; running.load(std::memory_order_relaxed); round++)
+			{
+				for(GameServer& server : servers)
+				{
+					// Every 16th round the server leaves and hosts again
+					if(round % 16 == 15)
+					{
+						remove(std::string(server.client->GetAddress()));
+						create(*server.client, Theater::ParameterView(server.cgam));
+						sent += 2;
+						wait(2);
+					}
+					else
+					{
+						update(*server.client, Theater::ParameterView(server.ugam[round % server.ugam.size()]));
+						sent++;
+						wait(1);
+					}
+				}
+			}
+
+			num_writes += sent;
+		});
+	}
+
+	std::this_thread::sleep_for(duration);
+	running = false;
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	double seconds = std::chrono::duration<double>(duration).count();
+	std::vector<double> samples;
+
+	for(const std::vector<double>& reader : latencies)
+	{
+		samples.insert(samples.end(), reader.begin(), reader.end());
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	// Keeps the reads from being optimized out
+	if(checksum == UINT64_MAX)
+	{
+		std::printf("checksum %llu\n", static_cast<unsigned long long>(checksum.load()));
+	}
+
+	if(samples.empty())
+	{
+		return { 0, 0, 0, 0, num_writes / seconds };
+	}
+
+	return { samples.size() / seconds, samples[samples.size() / 2], samples[samples.size() * 99 / 100], samples.back(), num_writes / seconds };
+}
+
+int main(int argc, char const* argv[])
+{
+	std::chrono::milliseconds duration((argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000);
+	size_t num_games = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 6000;
+	const size_t servers_per_writer = 256;
+
+	g_event_bus = new MoHRS::EventBus();
+
+	std::vector<GameServer> idle = MakeServers(0, num_games);
+	std::vector<std::vector<GameServer>> writers;
+
+	for(size_t w = 0; w < 8; w++)
+	{
+		writers.push_back(MakeServers(num_games + w * servers_per_writer, servers_per_writer));
+	}
+
+	MutexMatchmaker mutex_matchmaker;
+	MoHRS::Matchmaker* matchmaker = new MoHRS::Matchmaker();
+	uint64_t expected = 0;
+
+	for(const std::vector<GameServer>& servers : { idle, writers[0], writers[1], writers[2], writers[3],
+	                                                writers[4], writers[5], writers[6], writers[7] })
+	{
+		for(const GameServer& server : servers)
+		{
+			mutex_matchmaker.createGame(*server.client, Theater::ParameterView(server.cgam));
+			matchmaker->createGame(*server.client, Theater::ParameterView(server.cgam), [](const MoHRS::Game&) {});
+			expected++;
+		}
+	}
+
+	while(matchmaker->GetNumWrites() < expected)
+	{
+		std::this_thread::yield();
+	}
+
+	std::printf("%zu games, %zu servers per writer, %lld ms per run, reads sum the players of a region\n",
+	            num_games, servers_per_writer, static_cast<long long>(duration.count()));
+
+	for(size_t num_readers : { 1, 4, 8 })
+	{
+		for(size_t num_writers : { 0, 1, 4, 8 })
+		{
+			std::vector<std::vector<GameServer>> active(writers.begin(), writers.begin() + num_writers);
+
+			Result result = Run(num_readers, active, duration,
+				[&](MoHRS::Regions region) { return mutex_matchmaker.Read(region); },
+				[&](const Theater::Client& client, const Theater::ParameterView& parameter) { mutex_matchmaker.createGame(client, parameter); },
+				[&](const Theater::Client& client, const Theater::ParameterView& parameter) { mutex_matchmaker.updateGame(client, parameter); },
+				[&](const std::string& address) { mutex_matchmaker.removeGame(address); },
+				[](uint64_t) {});
+
+			std::printf("%zu readers %zu writers mutex    %10.0f reads/s, read p50 %8.1f us, p99 %8.1f us, max %8.1f us, %9.0f writes/s\n",
+			            num_readers, num_writers, result.reads_per_second, result.p50, result.p99, result.max, result.writes_per_second);
+
+			uint64_t writes_before = matchmaker->GetNumWrites();
+			std::atomic<uint64_t> sent{0};
+
+			result = Run(num_readers, active, duration,
+				[&](MoHRS::Regions region)
+				{
+					std::shared_ptr<const MoHRS::RegionSnapshot> snapshot = matchmaker->GetSnapshot(region);
+					uint64_t num_players = 0;
+
+					for(const MoHRS::GamePtr& game : snapshot->games)
+					{
+						num_players += game->GetNumPlayers();
+					}
+
+					return num_players;
+				},
+				[&](const Theater::Client& client, const Theater::ParameterView& parameter)
+				{
+					matchmaker->createGame(client, parameter, [](const MoHRS::Game&) {});
+				},
+				[&](const Theater::Client& client, const Theater::ParameterView& parameter) { matchmaker->updateGame(client, parameter); },
+				[&](const std::string& address) { matchmaker->removeGame(address); },
+				[&](uint64_t num_sent)
+				{
+					// The appliers decide the write rate, a writer does not queue more than they keep up with
+					uint64_t pending = sent.fetch_add(num_sent, std::memory_order_relaxed) + num_sent;
+
+					while(pending > matchmaker->GetNumWrites() - writes_before + MAX_PENDING_WRITES)
+					{
+						std::this_thread::yield();
+					}
+				});
+
+			std::printf("%zu readers %zu writers snapshot %10.0f reads/s, read p50 %8.1f us, p99 %8.1f us, max %8.1f us, %9.0f writes/s\n",
+			            num_readers, num_writers, result.reads_per_second, result.p50, result.p99, result.max, result.writes_per_second);
+
+			// The next run starts without a backlog
+			while(matchmaker->GetNumWrites() - writes_before < sent)
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	// The applier threads are detached and keep running, the matchmaker is never destroyed
+	return EXIT_SUCCESS;
+}
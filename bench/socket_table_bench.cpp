@@ -0,0 +1,128 @@
+/**
+ * @brief Compares the socket table with the old vector of clients under connection churn.
+ *
+ * The table is filled with idle sockets, then every round disconnects a random client and
+ * accepts a new one, like clients that come and go on a busy server. The old model removed a
+ * client with a linear find_if and erase on a vector.
+ *
+ * Usage: bench_socket_table [connections] [rounds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <net/socket.h>
+#include <net/socket_table.h>
+
+/**
+ * @brief Run the churn on the socket table.
+ * @return Nanoseconds per disconnect and accept.
+ */
+static double RunTable(const std::vector<std::shared_ptr<Net::Socket>>& sockets, size_t connections, size_t rounds)
+{
+	Net::SocketTable table;
+	std::vector<Net::SocketTable::Handle> handles;
+	std::mt19937 random(1);
+	size_t next = 0;
+
+	for(; next < connections; next++)
+	{
+		handles.push_back(table.Insert(sockets[next]));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < rounds; i++)
+	{
+		size_t index = random() % handles.size();
+
+		table.Remove(handles[index]);
+		handles[index] = table.Insert(sockets[next++ % sockets.size()]);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	if(table.Size() != connections || table.Find(handles[0]) == nullptr)
+	{
+		std::fprintf(stderr, "socket table lost a socket\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+/**
+ * @brief Run the churn on a vector like the old Server::_clients.
+ * @return Nanoseconds per disconnect and accept.
+ */
+static double RunVector(const std::vector<std::shared_ptr<Net::Socket>>& sockets, size_t connections, size_t rounds)
+{
+	std::vector<std::shared_ptr<Net::Socket>> clients;
+	std::vector<Net::Socket*> handles;
+	std::mt19937 random(1);
+	size_t next = 0;
+
+	for(; next < connections; next++)
+	{
+		clients.push_back(sockets[next]);
+		handles.push_back(sockets[next].get());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < rounds; i++)
+	{
+		size_t index = random() % handles.size();
+
+		auto it = std::find_if(clients.begin(), clients.end(),
+			[rawPtrToSearch = handles[index]](const std::shared_ptr<Net::Socket>& ptr)
+			{
+				return ptr.get() == rawPtrToSearch;
+			}
+		);
+
+		if(it != clients.end())
+		{
+			clients.erase(it);
+		}
+
+		const std::shared_ptr<Net::Socket>& socket = sockets[next++ % sockets.size()];
+
+		clients.push_back(socket);
+		handles[index] = socket.get();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	if(clients.size() != connections)
+	{
+		std::fprintf(stderr, "vector lost a socket\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+int main(int argc, char const* argv[])
+{
+	size_t connections = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+	size_t rounds = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 200000;
+	std::vector<std::shared_ptr<Net::Socket>> sockets;
+
+	// Twice as many sockets as connections so new clients are never in the table already
+	for(size_t i = 0; i < 2 * connections; i++)
+	{
+		sockets.push_back(std::make_shared<Net::Socket>());
+	}
+
+	std::printf("%zu connections, %zu disconnects and accepts\n", connections, rounds);
+	std::printf("socket table %10.1f ns/churn\n", RunTable(sockets, connections, rounds));
+	std::printf("vector       %10.1f ns/churn\n", RunVector(sockets, connections, rounds));
+
+	return EXIT_SUCCESS;
+}
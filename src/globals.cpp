@@ -0,0 +1,16 @@
+#include <globals.h>
+
+// Globals, created by main
+MoHRS::Matchmaker*           g_matchmaker;
+MoHRS::EventBus*             g_event_bus;
+Theater::ListCache*          g_list_cache;
+Theater::TransactionLog*     g_transaction_log = nullptr;
+Theater::FlightRecorder*     g_flight_recorder;
+
+Server*                      g_theater_server;
+Server*                      g_webserver_server;
+
+Net::TimerWheel*             g_timer_wheel;
+
+class Service::File_System*  g_file_system;
+class Service::Discord*      g_discord;
@@ -13,6 +13,19 @@ namespace Service
 namespace MoHRS
 {
 	class Matchmaker;
+	class EventBus;
+}
+
+namespace Net
+{
+	class TimerWheel;
+}
+
+namespace Theater
+{
+	class ListCache;
+	class TransactionLog;
+	class FlightRecorder;
 }
 
 /**
@@ -20,6 +33,26 @@ namespace MoHRS
  */
 extern MoHRS::Matchmaker*           g_matchmaker;
 
+/**
+ * @brief Pointer to the global stream of matchmaker events.
+ */
+extern MoHRS::EventBus*             g_event_bus;
+
+/**
+ * @brief Pointer to the global cache of encoded list responses.
+ */
+extern Theater::ListCache*          g_list_cache;
+
+/**
+ * @brief Pointer to the global binary log of Theater frames, nullptr when it is disabled.
+ */
+extern Theater::TransactionLog*     g_transaction_log;
+
+/**
+ * @brief Pointer to the global ring of the last Theater frames of all connections.
+ */
+extern Theater::FlightRecorder*     g_flight_recorder;
+
 /**
  * @brief Pointer to the global Theater Server instance.
  */
@@ -30,6 +63,11 @@ extern Server*                      g_theater_server;
  */
 extern Server*                      g_webserver_server;
 
+/**
+ * @brief Pointer to the global TimerWheel instance that expires idle connections.
+ */
+extern Net::TimerWheel*             g_timer_wheel;
+
 /**
  * @brief Pointer to the global File_System instance.
  */
@@ -1,5 +1,12 @@
 #include <iostream>
 #include <filesystem>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #include <util.h>
 
@@ -7,13 +14,322 @@
 
 // Global
 std::ofstream g_logger;
-std::mutex    g_logger_mutex;
 Logger::Mode  g_logger_mode = Logger::Mode::Development;
 
-void Logger::Initialize()
+/**
+ * @brief A queued log message.
+ */
+struct Record
+{
+	Logger::Level level;
+	bool          show_console;
+	std::time_t   time;         /**< Seconds since the epoch when the message was logged. */
+	std::string   type;
+	std::string   msg;
+	std::function<std::string()> format; /**< Builds the message on the writer thread, empty if msg is set. */
+};
+
+/**
+ * @brief Bounded lock-free queue of records, filled by any thread and drained by the writer thread.
+ * @details Every cell carries a sequence number. A producer claims a position with a compare and swap
+ * when the cell is free for it, the writer takes the cell when the producer published it. A full queue
+ * rejects the record instead of waiting.
+ */
+class RecordQueue
+{
+	private:
+		static constexpr size_t CAPACITY = 16384;
+
+		struct Cell
+		{
+			std::atomic<size_t> sequence; /**< Position the cell is free for, or that position + 1 once it holds a record. */
+			Record              record;
+		};
+
+		std::unique_ptr<Cell[]> _cells;          /**< The ring. */
+		alignas(64) std::atomic<size_t> _tail{0}; /**< Next position to claim by a producer. */
+		alignas(64) size_t              _head = 0; /**< Next position to take by the writer. */
+
+	public:
+		RecordQueue() : _cells(std::make_unique<Cell[]>(CAPACITY))
+		{
+			for(size_t i = 0; i < CAPACITY; i++)
+			{
+				this->_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		bool Push(Record&& record)
+		{
+			size_t position = this->_tail.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			while(true)
+			{
+				cell = &this->_cells[position & (CAPACITY - 1)];
+
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if(diff == 0)
+				{
+					if(this->_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if(diff < 0)
+				{
+					// Full, the writer did not take the record of the previous round yet
+					return false;
+				}
+				else
+				{
+					position = this->_tail.load(std::memory_order_relaxed);
+				}
+			}
+
+			cell->record = std::move(record);
+			cell->sequence.store(position + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		/**
+		 * @brief Check whether the writer would find a record, only called by the writer.
+		 */
+		bool IsEmpty() const
+		{
+			return this->_cells[this->_head & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) != this->_head + 1;
+		}
+
+		bool Pop(Record& record)
+		{
+			Cell& cell = this->_cells[this->_head & (CAPACITY - 1)];
+
+			if(cell.sequence.load(std::memory_order_acquire) != this->_head + 1)
+			{
+				return false;
+			}
+
+			record = std::move(cell.record);
+			cell.sequence.store(this->_head + CAPACITY, std::memory_order_release);
+			this->_head++;
+
+			return true;
+		}
+};
+
+// The detached writer thread outlives main, so what it touches is never destroyed
+static RecordQueue&             logger_queue = *new RecordQueue();
+static std::mutex&              logger_mutex = *new std::mutex();                   /**< Protects the waits on the condition variables. */
+static std::condition_variable& logger_cv = *new std::condition_variable();         /**< Wakes the writer. */
+static std::condition_variable& logger_flushed_cv = *new std::condition_variable(); /**< Wakes Flush once the writer flushed. */
+static std::atomic<uint64_t>    logger_dropped{0};                                  /**< Records dropped because the queue was full. */
+static std::atomic<bool>        logger_running{false};                              /**< The writer thread was started. */
+static std::atomic<bool>        logger_waiting{false};                              /**< The writer found the queue empty and waits for a record. */
+static std::atomic<bool>        logger_flush_requested{false};                      /**< Set by Flush, cleared by the writer once it flushed. */
+
+static constexpr std::chrono::seconds FLUSH_INTERVAL{1};
+
+/**
+ * @brief Wake the writer thread.
+ */
+static void WakeWriter()
+{
+	std::lock_guard<std::mutex> guard(logger_mutex); // logger lock
+
+	logger_cv.notify_one();
+}
+
+/**
+ * @brief Queue a record for the writer thread.
+ */
+static void Enqueue(Record&& record)
+{
+	record.time = std::time(nullptr);
+
+	if(!logger_queue.Push(std::move(record)))
+	{
+		logger_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// Only the first record that finds the writer waiting pays for the wake up. The fence pairs
+	// with the one of the writer: either it sees this record or this thread sees it waiting.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if(logger_waiting.load(std::memory_order_relaxed) && logger_waiting.exchange(false, std::memory_order_relaxed))
+	{
+		WakeWriter();
+	}
+}
+
+/**
+ * @brief Queue a message for the writer thread.
+ */
+static void LogMessage(Logger::Level level, const std::string& msg, const std::string& type, bool show_console)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
+	Record record;
+	record.level = level;
+	record.show_console = show_console;
+	record.type = type;
+	record.msg = msg;
+
+	Enqueue(std::move(record));
+}
+
+/**
+ * @brief Add a record to the lines for the console and the log file.
+ * @param time The cached timestamp of the record.
+ * @param console[out] Lines for the console.
+ * @param file[out] Lines for the log file.
+ * @return True if the record must be flushed right away.
+ */
+static bool Write(Record& record, const std::string& time, std::string& console, std::string& file)
+{
+	// Lazily logged messages are formatted here, off the thread that logged them
+	if(record.format)
+	{
+		record.msg = record.format();
+		record.format = nullptr;
+	}
+
+
+	const char* console_level = "";
+	const char* file_level = "";
+
+	switch(record.level)
+	{
+		case Logger::Level::Debug:
+			// Debug messages only go to the console
+			console.append("[").append(time).append("][DEBUG] ").append(record.msg).append("\n");
+			return false;
+
+		case Logger::Level::Transaction:
+		case Logger::Level::Info:     console_level = "[INFO] ";                     file_level = "[INFO] ";     break;
+		case Logger::Level::Warning:  console_level = "[\e[1;33mWARNING\e[0m] ";   file_level = "[WARNING] ";  break;
+		case Logger::Level::Error:    console_level = "[\e[1;31mERROR\e[0m] ";     file_level = "[ERROR] ";    break;
+		case Logger::Level::Critical: console_level = "[\e[1;31mCRITICAL\e[0m] ";  file_level = "[CRITICAL] "; break;
+	}
+
+	if(record.show_console)
+	{
+		console.append("[").append(time).append("]").append(record.type).append(console_level).append(record.msg).append("\n");
+	}
+
+	file.append("[").append(time).append("]").append(record.type).append(file_level).append(record.msg).append("\n");
+
+	return record.level >= Logger::Level::Error;
+}
+
+/**
+ * @brief Write the queued records in batches, runs on the writer thread.
+ * @details A batch is joined into one buffer per stream and written with a single call. When the
+ * queue is empty the writer waits on a condition variable, the next record wakes it up.
+ */
+static void Run()
+{
+	Record record;
+	std::time_t cached_second = -1;
+	std::string cached_time;
+	std::string console;
+	std::string file;
+	bool dirty = false;
+	std::chrono::steady_clock::time_point last_flush = std::chrono::steady_clock::now();
+
+	while(true)
+	{
+		bool flush = false;
+		uint64_t written = 0;
+
+		// Read before the queue, so every record queued before Flush asked is written by this batch
+		bool flush_requested = logger_flush_requested.load(std::memory_order_acquire);
+
+		while(logger_queue.Pop(record))
+		{
+			// Format the time once per second
+			if(record.time != cached_second)
+			{
+				char buffer[16];
+				std::tm time_info;
+
+				localtime_r(&record.time, &time_info);
+				std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &time_info);
+
+				cached_second = record.time;
+				cached_time = buffer;
+			}
+
+			flush |= Write(record, cached_time, console, file);
+			written++;
+		}
+
+		if(!console.empty())
+		{
+			std::cout.write(console.data(), console.size());
+			console.clear();
+		}
+
+		if(!file.empty())
+		{
+			g_logger.write(file.data(), file.size());
+			file.clear();
+		}
+
+		dirty |= (written > 0);
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		if(dirty && (flush || flush_requested || now - last_flush >= FLUSH_INTERVAL))
+		{
+			std::cout.flush();
+			g_logger.flush();
+
+			dirty = false;
+			last_flush = now;
+		}
+
+		if(flush_requested)
+		{
+			std::lock_guard<std::mutex> guard(logger_mutex); // logger lock
+
+			logger_flush_requested.store(false, std::memory_order_release);
+			logger_flushed_cv.notify_all();
+		}
+
+		if(written > 0)
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(logger_mutex); // logger lock
 
+		// The fence pairs with the one of Enqueue, a record queued after the check wakes the writer
+		logger_waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		auto ready = []()
+		{
+			return !logger_queue.IsEmpty() || logger_flush_requested.load(std::memory_order_acquire);
+		};
+
+		// Unflushed lines are flushed after a second even when nothing else is logged
+		if(dirty)
+		{
+			logger_cv.wait_until(lock, last_flush + FLUSH_INTERVAL, ready);
+		}
+		else
+		{
+			logger_cv.wait(lock, ready);
+		}
+
+		logger_waiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+void Logger::Initialize()
+{
 	std::string path = "../data/log";
 
 	// Check if the directory already exists
@@ -31,6 +347,62 @@ void Logger::Initialize()
 	}
 
 	g_logger.open(path + "/mohrs-" + Util::Time::GetNowDateTime("%Y%m%d-%H%M%S") + ".log", std::ios::app);
+
+	logger_running.store(true, std::memory_order_release);
+
+	std::thread t_writer(&Run);
+	t_writer.detach();
+}
+
+void Logger::Flush()
+{
+	// Nothing would ever write the queue, tools and tests log without a writer
+	if(!logger_running.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(logger_mutex); // logger lock
+
+	logger_flush_requested.store(true, std::memory_order_release);
+	logger_cv.notify_one();
+
+	// The writer writes everything queued so far, flushes and clears the request
+	logger_flushed_cv.wait(lock, []()
+	{
+		return !logger_flush_requested.load(std::memory_order_acquire);
+	});
+}
+
+uint64_t Logger::GetNumDropped()
+{
+	return logger_dropped.load(std::memory_order_relaxed);
+}
+
+bool Logger::IsEnabled(Logger::Level level)
+{
+	if(level <= Logger::Level::Transaction)
+	{
+		return (g_logger_mode & Logger::Mode::Development) != 0;
+	}
+
+	return true;
+}
+
+void Logger::Push(Logger::Level level, const std::string& type, bool show_console, std::function<std::string()> format)
+{
+	Record record;
+	record.level = level;
+	record.show_console = show_console;
+	record.type = type;
+	record.format = std::move(format);
+
+	Enqueue(std::move(record));
+}
+
+void Logger::Append(std::string& msg, const Logger::Frame& frame)
+{
+	msg += Util::Buffer::ToString(frame.data);
 }
 
 std::string Logger::ToString(enum Server::Type type)
@@ -59,62 +431,22 @@ std::string Logger::ToString(enum Service::Type type)
 
 void Logger::info(const std::string& msg, const std::string& type, bool show_console)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
-
-	std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
-	
-	if(show_console)
-	{
-		std::cout << "[" << time << "]" << type << "[INFO] " << msg << std::endl;
-	}
-	
-	g_logger  << "[" << time << "]" << type << "[INFO] " << msg << std::endl;
-	g_logger.flush();
+	LogMessage(Logger::Level::Info, msg, type, show_console);
 }
 
 void Logger::warning(const std::string& msg, const std::string& type, bool show_console)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
-	
-	std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
-	
-	if(show_console)
-	{
-		std::cout << "[" << time << "]" << type << "[\e[1;33mWARNING\e[0m] " << msg << std::endl;
-	}
-	
-	g_logger  << "[" << time << "]" << type << "[WARNING] " << msg << std::endl;
-	g_logger.flush();
+	LogMessage(Logger::Level::Warning, msg, type, show_console);
 }
 
 void Logger::error(const std::string& msg, const std::string& type, bool show_console)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
-	
-	std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
-	
-	if(show_console)
-	{
-		std::cout << "[" << time << "]" << type << "[\e[1;31mERROR\e[0m] " << msg << std::endl;
-	}
-	
-	g_logger  << "[" << time << "]" << type << "[ERROR] " << msg << std::endl;
-	g_logger.flush();
+	LogMessage(Logger::Level::Error, msg, type, show_console);
 }
 
 void Logger::critical(const std::string& msg, const std::string& type, bool show_console)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
-	
-	std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
-	
-	if(show_console)
-	{
-		std::cout << "[" << time << "]" << type << "[\e[1;31mCRITICAL\e[0m] " << msg << std::endl;
-	}
-	
-	g_logger  << "[" << time << "]" << type << "[CRITICAL] " << msg << std::endl;
-	g_logger.flush();
+	LogMessage(Logger::Level::Critical, msg, type, show_console);
 }
 
 void Logger::info(const std::string& msg, enum Server::Type type, bool show_console)
@@ -175,12 +507,6 @@ void Logger::critical(const std::string& msg, enum Service::Type type, bool show
 
 void Logger::debug(const std::string& msg)
 {
-	std::lock_guard<std::mutex> guard(g_logger_mutex); // logger lock
-	
-	std::string time = Util::Time::GetNowDateTime("%H:%M:%S");
-	
-	std::cout << "[" << time << "][DEBUG] " << msg << std::endl;
-	//g_logger  << "[" << Util::Time::GetNowTime() << "][DEBUG] " << msg << std::endl;
-	//g_logger.flush();
+	LogMessage(Logger::Level::Debug, msg, "", true);
 }
 
@@ -2,11 +2,47 @@
 #define LOGGER_H
 
 #include <fstream>
-#include <mutex>
+#include <string>
+#include <tuple>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
 
 #include <server.h>
 #include <service.h>
 
+/**
+ * @brief Lowest log level that is compiled in, see Logger::Level.
+ * @details Set by the build, release builds leave out debug and transaction logging.
+ */
+#ifndef MOHRS_LOG_LEVEL
+#define MOHRS_LOG_LEVEL 0
+#endif
+
+/**
+ * @brief True if messages of a level are compiled in and enabled by the logging mode.
+ * @details The compile-time part is a constant, so the compiler removes the guarded code of disabled levels.
+ */
+#define MOHRS_LOG_ENABLED(level) \
+	(static_cast<int>(level) >= MOHRS_LOG_LEVEL && Logger::IsEnabled(level))
+
+/**
+ * @brief Log a message of a level, the arguments are only evaluated when the level is enabled.
+ * @details The arguments are joined into the message on the writer thread, see Logger::Log.
+ */
+#define MOHRS_LOG(level, type, show_console, ...) \
+	do \
+	{ \
+		if(MOHRS_LOG_ENABLED(level)) \
+		{ \
+			Logger::Log(level, type, show_console, __VA_ARGS__); \
+		} \
+	} while(false)
+
+#define LOG_DEBUG(...)                              MOHRS_LOG(Logger::Level::Debug, Server::Type::None, true, __VA_ARGS__)
+#define LOG_TRANSACTION(type, show_console, ...)    MOHRS_LOG(Logger::Level::Transaction, type, show_console, __VA_ARGS__)
+#define LOG_INFO(type, show_console, ...)           MOHRS_LOG(Logger::Level::Info, type, show_console, __VA_ARGS__)
+
 namespace Logger
 {
 	/**
@@ -19,10 +55,91 @@ namespace Logger
 		Deployment = 0x4   ///< Minimal logging mode.
 	};
 	
+	/**
+	 * @brief Severity of a log message.
+	 */
+	enum class Level : uint8_t
+	{
+		Debug,       ///< Developer output, only shown on the console.
+		Transaction, ///< Every request and response of a client.
+		Info,
+		Warning,
+		Error,
+		Critical
+	};
+
+	/**
+	 * @brief Frame data that is made printable by the writer thread.
+	 */
+	struct Frame
+	{
+		std::string data; /**< The raw frame. */
+	};
+
 	/**
 	 * @brief Initializes the logger.
+	 * @details Opens the log file and starts the writer thread. Messages are queued by the calling
+	 * thread and written by the writer thread, so logging never waits on the console or the disk.
+	 * The writer sleeps while the queue is empty, the first message queued after that wakes it.
 	 */
 	void Initialize();
+
+	/**
+	 * @brief Waits till the writer thread wrote all queued messages and flushed them.
+	 * @details Returns at once when Initialize was not called, since no thread would write the messages.
+	 */
+	void Flush();
+
+	/**
+	 * @brief Gets the number of messages dropped because the queue was full.
+	 * @return The number of messages.
+	 */
+	uint64_t GetNumDropped();
+
+	/**
+	 * @brief Checks whether the logging mode shows messages of a level.
+	 * @details Debug and transaction messages are only logged in development mode.
+	 * @param level The level.
+	 * @return True if messages of the level are logged.
+	 */
+	bool IsEnabled(Level level);
+
+	/**
+	 * @brief Queues a message that is formatted by the writer thread.
+	 * 
+	 * @param level The level of the message.
+	 * @param type The type of the log message.
+	 * @param show_console Whether to display the message in the console.
+	 * @param format Builds the message, called on the writer thread.
+	 */
+	void Push(Level level, const std::string& type, bool show_console, std::function<std::string()> format);
+
+	/**
+	 * @brief Appends a value to a message.
+	 * 
+	 * @param msg The message.
+	 * @param value A string or a number.
+	 */
+	template<typename T>
+	void Append(std::string& msg, const T& value)
+	{
+		if constexpr(std::is_arithmetic_v<T>)
+		{
+			msg += std::to_string(value);
+		}
+		else
+		{
+			msg += value;
+		}
+	}
+
+	/**
+	 * @brief Appends frame data to a message, non-printable bytes are escaped.
+	 * 
+	 * @param msg The message.
+	 * @param frame The frame.
+	 */
+	void Append(std::string& msg, const Frame& frame);
 	
 	/**
 	 * @brief Converts Server::Type enum values to string.
@@ -39,6 +156,34 @@ namespace Logger
 	 * @return A string representation of the Service type.
 	 */
 	std::string ToString(enum Service::Type type);
+
+	/**
+	 * @brief Logs a message that is joined from its arguments on the writer thread.
+	 * 
+	 * The arguments are copied into the queued record, so the caller does no formatting at all.
+	 * Use it through the MOHRS_LOG macros, which skip the call when the level is disabled.
+	 * 
+	 * @param level The level of the message.
+	 * @param type The Server::Type or Service::Type enum value.
+	 * @param show_console Whether to display the message in the console.
+	 * @param args Strings, numbers and frames, joined in order.
+	 */
+	template<typename Type, typename... Args>
+	void Log(Level level, Type type, bool show_console, Args&&... args)
+	{
+		static_assert((!std::is_same_v<std::decay_t<Args>, std::string_view> && ...),
+			"A view can dangle before the writer thread formats it, pass a std::string");
+
+		Logger::Push(level, Logger::ToString(type), show_console,
+			[values = std::make_tuple(std::decay_t<Args>(std::forward<Args>(args))...)]()
+			{
+				std::string msg;
+
+				std::apply([&msg](const auto&... value) { (Logger::Append(msg, value), ...); }, values);
+
+				return msg;
+			});
+	}
 	
 	/**
 	 * @brief Logs an informational message.
@@ -156,8 +301,7 @@ namespace Logger
 	void debug(const std::string& msg);
 }
 
-extern std::ofstream g_logger; /**< The global logger output stream. */
-extern std::mutex    g_logger_mutex; /**< Mutex for thread-safe logging. */
+extern std::ofstream g_logger; /**< The global logger output stream, only written by the writer thread. */
 extern Logger::Mode  g_logger_mode; /**< The current logging mode. */
 
 #endif // LOGGER_H
@@ -3,55 +3,164 @@
 #include <thread>
 #include <fstream>
 #include <filesystem>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <poll.h>
+#include <sys/inotify.h>
 
 #include <version.h>
 #include <logger.h>
 #include <settings.h>
 #include <globals.h>
 #include <server.h>
+#include <net/timer_wheel.h>
 #include <mohrs/matchmaker.h>
+#include <mohrs/event_bus.h>
 #include <theater/client.h>
+#include <theater/list_cache.h>
+#include <theater/transaction_log.h>
+#include <theater/flight_recorder.h>
 #include <webserver/client.h>
 #include <service/file_system.h>
 #include <service/discord.h>
 
-// Globals
-MoHRS::Matchmaker*           g_matchmaker;
+// Settings
+// Readers keep a plain reference only while they handle a request, so a replaced snapshot
+// is freed once it was replaced longer ago than this
+static const std::chrono::seconds SETTINGS_GRACE_PERIOD(60);
 
-Server*                      g_theater_server;
-Server*                      g_webserver_server;
+// The published settings snapshot
+static std::unique_ptr<const Settings> settings_current;
 
-class Service::File_System*  g_file_system;
-class Service::Discord*      g_discord;
+// Replaced settings snapshots with the time they were replaced, oldest first
+static std::deque<std::pair<std::chrono::steady_clock::time_point, std::unique_ptr<const Settings>>> settings_retired;
 
-// Settings
-Json::Value                  g_settings;
-std::shared_mutex            g_settings_mutex;
+// Set by SIGHUP, the main thread reloads the settings
+static volatile sig_atomic_t settings_reload_requested = 0;
 
-void load_settings()
+bool load_settings()
 {
-	std::unique_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read/write)
-	Json::CharReaderBuilder builder;
+	Settings settings;
+	std::string error;
 	
 	std::ifstream ifs;
 	ifs.open("../data/settings.json");
 	
 	if(ifs.is_open())
 	{
-		if(!parseFromStream(builder, ifs, &g_settings, nullptr))
+		Json::CharReaderBuilder builder;
+		Json::Value json;
+		
+		if(!parseFromStream(builder, ifs, &json, &error))
 		{
-			Logger::error("Cant parse settings.json.");
-			Logger::error("load_settings() at parseFromStream");
-			exit(EXIT_FAILURE);
+			Logger::error("Cant parse settings.json: " + error);
+			return false;
 		}
 		
 		ifs.close();
+		
+		// A broken file never replaces working settings
+		if(!Settings::FromJson(json, settings, error))
+		{
+			Logger::error("Invalid settings.json: " + error);
+			return false;
+		}
+	}
+	else if(g_settings.load(std::memory_order_acquire) != nullptr)
+	{
+		Logger::error("Cant open settings.json, keeping the current settings.");
+		return false;
+	}
+	
+	std::unique_ptr<const Settings> snapshot = std::make_unique<const Settings>(settings);
+	
+	g_settings.store(snapshot.get(), std::memory_order_release);
+	
+	if(settings_current)
+	{
+		settings_retired.emplace_back(std::chrono::steady_clock::now(), std::move(settings_current));
+	}
+	
+	settings_current = std::move(snapshot);
+	
+	return true;
+}
+
+void free_retired_settings()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	
+	while(!settings_retired.empty() && now - settings_retired.front().first >= SETTINGS_GRACE_PERIOD)
+	{
+		settings_retired.pop_front();
+	}
+}
+
+void settings_signal_callback(int signum)
+{
+	settings_reload_requested = 1;
+}
+
+int start_settings_watch()
+{
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	
+	// Editors often replace the file, so the directory is watched
+	if(fd == -1 || inotify_add_watch(fd, "../data", IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+	{
+		Logger::warning("Can't watch settings.json, reload with SIGHUP");
+		
+		if(fd != -1)
+		{
+			close(fd);
+		}
+		
+		return -1;
+	}
+	
+	return fd;
+}
+
+bool settings_changed(int fd)
+{
+	alignas(struct inotify_event) char buffer[4096];
+	bool changed = false;
+	ssize_t size;
+	
+	while((size = read(fd, buffer, sizeof(buffer))) > 0)
+	{
+		for(ssize_t offset = 0; offset < size; )
+		{
+			const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+			
+			if(event->len > 0 && std::string(event->name) == "settings.json")
+			{
+				changed = true;
+			}
+			
+			offset += sizeof(struct inotify_event) + event->len;
+		}
+	}
+	
+	return changed;
+}
+
+void start_transaction_log()
+{
+	const Settings& settings = GetSettings();
+	
+	if(settings.theater.binary_log)
+	{
+		g_transaction_log = new Theater::TransactionLog("../data/log", settings.theater.binary_log_segment_size);
 	}
 }
 
 void start_theater_server()
 {
 	g_matchmaker = new MoHRS::Matchmaker();
+	g_list_cache = new Theater::ListCache();
 	g_theater_server = new Server(Server::Type::Theater);
 
 	// Wait till discord has a chance to start
@@ -103,7 +212,61 @@ void start_discord()
 	g_discord->Start();
 }
 
+// Set by SIGUSR1, the main thread dumps the global flight recorder and the ring of every connection
+static volatile sig_atomic_t flight_recorder_dump_requested = 0;
+
+void flight_recorder_signal_callback(int signum)
+{
+	flight_recorder_dump_requested = 1;
+}
+
+void write_flight_recorder_dump(const std::string& name, const std::vector<Theater::FlightRecorder::Frame>& frames)
+{
+	std::string path = Theater::FlightRecorder::GetDumpPath(name);
+	
+	if(Theater::FlightRecorder::WritePcap(path, frames))
+	{
+		Logger::info("Flight recorder dumped " + std::to_string(frames.size()) + " frames to \"" + path + "\"", Server::Type::Theater);
+	}
+	else
+	{
+		Logger::error("Can't write flight recorder dump \"" + path + "\"", Server::Type::Theater);
+	}
+}
+
+void dump_flight_recorder()
+{
+	write_flight_recorder_dump("all", g_flight_recorder->Snapshot());
+	
+	// Files are written after the server lock is released
+	std::vector<std::shared_ptr<Net::Socket>> clients;
+	
+	g_theater_server->ForEachClient([&clients](const std::shared_ptr<Net::Socket>& client)
+	{
+		clients.push_back(client);
+	});
+	
+	// One file per connection, a connection that never sent a frame has no ring
+	for(const std::shared_ptr<Net::Socket>& client : clients)
+	{
+		std::vector<Theater::FlightRecorder::Frame> frames = static_cast<Theater::Client*>(client.get())->GetRecordedFrames();
+		
+		if(!frames.empty())
+		{
+			write_flight_recorder_dump(std::to_string(client->GetHandle()), frames);
+		}
+	}
+}
+
+// Set by SIGINT, SIGTERM, SIGQUIT and SIGTSTP to the signal number, the main thread shuts down within a second
+static volatile sig_atomic_t shutdown_requested = 0;
+
 void signal_callback(int signum)
+{
+	shutdown_requested = signum;
+}
+
+void shutdown_server(int signum)
 {
 	Logger::info("Caught signal " + std::to_string(signum));
 	
@@ -115,6 +278,9 @@ void signal_callback(int signum)
 	
 	g_file_system->UnLoadAll();
 
+	// Write the queued log messages
+	Logger::Flush();
+
 	// Exit application
 	exit(signum);
 }
@@ -122,7 +288,11 @@ void signal_callback(int signum)
 int main(int argc, char const* argv[])
 {
 	Logger::Initialize();
-	load_settings();
+	
+	if(!load_settings())
+	{
+		exit(EXIT_FAILURE);
+	}
 	
 	Logger::info("--- PROJECT INFO ---");
 	Logger::info("Project name     = " + std::string(PROJECT_GIT_NAME));
@@ -136,27 +306,74 @@ int main(int argc, char const* argv[])
 	signal(SIGTERM, signal_callback);
 	signal(SIGQUIT, signal_callback);
 	signal(SIGTSTP, signal_callback);
-	signal(SIGKILL, signal_callback);
+	signal(SIGUSR1, flight_recorder_signal_callback);
+	signal(SIGHUP, settings_signal_callback);
+	
+	// Expire idle connections
+	g_timer_wheel = new Net::TimerWheel();
+
+	// Subscribers attach while their services start
+	g_event_bus = new MoHRS::EventBus();
+	
+	// Theater clients log to it once they connect
+	start_transaction_log();
+	g_flight_recorder = new Theater::FlightRecorder(Theater::FlightRecorder::GLOBAL_CAPACITY);
 	
 	// Start servers
+	std::thread t_timer_wheel(&Net::TimerWheel::Run, g_timer_wheel);
 	std::thread t_theater(&start_theater_server);
-	std::thread t_theater_heartbeat(&Theater::Client::Heartbeat);
 	std::thread t_webserver(&start_webserver_server);
-	std::thread t_webserver_heartbeat(&Webserver::Client::Heartbeat);
 	std::thread t_file_system(&start_file_system);
 	std::thread t_discord(&start_discord);
 
+	t_timer_wheel.detach();
 	t_theater.detach();
-	t_theater_heartbeat.detach();
 	t_webserver.detach();
-	t_webserver_heartbeat.detach();
 	t_file_system.detach();
 	t_discord.detach();
 
+	// Reload the settings when settings.json changes
+	struct pollfd settings_watch;
+	settings_watch.fd = start_settings_watch();
+	settings_watch.events = POLLIN;
+	
 	// Sleep ZZZZZZzzzzzZZZZZ
 	while(true)
 	{
-		sleep(1);
+		settings_watch.revents = 0;
+		
+		if(settings_watch.fd == -1)
+		{
+			sleep(1);
+		}
+		else
+		{
+			poll(&settings_watch, 1, 1000);
+		}
+		
+		if(shutdown_requested)
+		{
+			shutdown_server(shutdown_requested);
+		}
+		
+		if(((settings_watch.revents & POLLIN) != 0 && settings_changed(settings_watch.fd)) || settings_reload_requested)
+		{
+			settings_reload_requested = 0;
+			
+			if(load_settings())
+			{
+				Logger::info("Settings reloaded");
+			}
+		}
+		
+		free_retired_settings();
+		
+		if(flight_recorder_dump_requested)
+		{
+			flight_recorder_dump_requested = 0;
+			
+			dump_flight_recorder();
+		}
 	}
 	
 	return EXIT_SUCCESS;
@@ -0,0 +1,51 @@
+#include <mohrs/event_bus.h>
+
+MoHRS::Event MoHRS::Event::FromGame(Type type, const MoHRS::Game& game)
+{
+	MoHRS::Event event;
+
+	event.type = type;
+	event.game_id = game.GetId();
+	event.region = game.GetRegion();
+	event.num_players = game.GetNumPlayers();
+	event.theater_session.Assign(game.GetTheaterSession());
+	event.name.Assign(game.GetName());
+	event.host_player.Assign(game.GetHostPlayer());
+
+	return event;
+}
+
+MoHRS::Event MoHRS::Event::FromClient(Type type, const std::string& theater_session)
+{
+	MoHRS::Event event;
+
+	event.type = type;
+	event.theater_session.Assign(theater_session);
+
+	return event;
+}
+
+MoHRS::EventBus::EventBus() : _slots(std::make_unique<Slot[]>(CAPACITY))
+{
+
+}
+
+void MoHRS::EventBus::Publish(const MoHRS::Event& event)
+{
+	uint64_t position = this->_head.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = this->_slots[position & (CAPACITY - 1)];
+
+	// Readers that see the odd sequence skip the slot till it is complete
+	slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.event = event;
+
+	slot.sequence.store(2 * position + 2, std::memory_order_release);
+}
+
+MoHRS::EventBus::Subscriber::Subscriber(const EventBus& bus, EventBus::Overflow overflow) :
+	_bus(bus), _overflow(overflow), _cursor(bus._head.load(std::memory_order_acquire))
+{
+
+}
@@ -0,0 +1,199 @@
+#ifndef MOHRS_EVENT_BUS_H
+#define MOHRS_EVENT_BUS_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include <mohrs/game.h>
+#include <mohrs/region.h>
+#include <mohrs/fixed_string.h>
+
+/**
+    Medal of Honor - Rising Sun
+*/
+namespace MoHRS
+{
+	/**
+	 * @brief Something that happened to a game or a client.
+	 * @details Events are plain data, so publishing one never allocates.
+	 */
+	struct Event
+	{
+		enum class Type : uint8_t
+		{
+			GameCreated,        /**< A game was created, the fields describe the new game. */
+			GameUpdated,        /**< The players of a game changed. */
+			GameRemoved,        /**< A game was removed, the fields describe the removed game. */
+			ClientConnected,    /**< A theater client connected, only theater_session is set. */
+			ClientDisconnected, /**< A theater client disconnected, only theater_session is set. */
+		};
+
+		Type                                           type;
+		int                                            game_id = -1;
+		MoHRS::Regions                                 region = MoHRS::Regions::Unknown;
+		uint8_t                                        num_players = 0;
+		MoHRS::FixedString<MoHRS::MAX_THEATER_SESSION> theater_session;
+		MoHRS::FixedString<MoHRS::MAX_GAME_NAME>       name;
+		MoHRS::FixedString<MoHRS::MAX_PLAYER_NAME>     host_player;
+
+		/**
+		 * @brief Create an event about a game.
+		 * @param type The type of the event.
+		 * @param game The game.
+		 * @return The event.
+		 */
+		static Event FromGame(Type type, const MoHRS::Game& game);
+
+		/**
+		 * @brief Create an event about a client.
+		 * @param type The type of the event.
+		 * @param theater_session The address of the client.
+		 * @return The event.
+		 */
+		static Event FromClient(Type type, const std::string& theater_session);
+	};
+
+	/**
+	 * @brief In-process stream of matchmaker events.
+	 *
+	 * All subscribers read from one ring of events, every subscriber with its own cursor. Publishing
+	 * claims the next position with a single atomic add and copies the event in, it never waits and
+	 * costs the same however many subscribers there are. Every slot carries a sequence number that
+	 * tells a reader whether the event in it is complete, still being written or already overwritten.
+	 * A subscriber that falls more than a ring behind loses events, how it catches up is its overflow policy.
+	 */
+	class EventBus
+	{
+		public:
+			/**
+			 * @brief Number of events in the ring, a power of two.
+			 */
+			static constexpr uint64_t CAPACITY = 4096;
+
+			/**
+			 * @brief What a subscriber does when it fell behind more than the ring holds.
+			 */
+			enum class Overflow
+			{
+				DropOldest, /**< Continue at the oldest event that is still in the ring. */
+				DropAll,    /**< Skip everything that is queued and continue with new events. */
+			};
+
+			class Subscriber;
+
+		private:
+			/**
+			 * @brief A position in the ring.
+			 */
+			struct alignas(64) Slot
+			{
+				std::atomic<uint64_t> sequence{0}; /**< Odd while the event is written, 2 * position + 2 once it is complete. */
+				MoHRS::Event          event;       /**< The event. */
+			};
+
+			std::unique_ptr<Slot[]> _slots;   /**< The ring. */
+			std::atomic<uint64_t>   _head{0}; /**< Next position to publish. */
+
+		public:
+			EventBus();
+
+			/**
+			 * @brief Publish an event to all subscribers.
+			 * @param event The event.
+			 */
+			void Publish(const MoHRS::Event& event);
+
+			/**
+			 * @brief Get the number of published events.
+			 * @return The number of events.
+			 */
+			uint64_t GetNumPublished() const { return this->_head.load(std::memory_order_relaxed); }
+	};
+
+	/**
+	 * @brief Reads the events published after it was created.
+	 * @details A subscriber is polled from a single thread.
+	 */
+	class EventBus::Subscriber
+	{
+		private:
+			const EventBus&       _bus;        /**< The bus to read from. */
+			EventBus::Overflow    _overflow;   /**< What to do when the subscriber fell behind. */
+			uint64_t              _cursor;     /**< Next position to read. */
+			std::atomic<uint64_t> _dropped{0}; /**< Events that were lost because the subscriber fell behind. */
+
+		public:
+			/**
+			 * @brief Subscribe to a bus.
+			 * @param bus The bus.
+			 * @param overflow What to do when the subscriber fell behind.
+			 */
+			Subscriber(const EventBus& bus, EventBus::Overflow overflow);
+
+			/**
+			 * @brief Handle the events that were published since the last poll.
+			 * @param func Called with a const reference to every event, in publish order.
+			 * @return The number of handled events.
+			 */
+			template<typename Func>
+			size_t Poll(Func&& func)
+			{
+				size_t count = 0;
+				uint64_t head = this->_bus._head.load(std::memory_order_acquire);
+
+				while(this->_cursor < head)
+				{
+					// Fell behind, the oldest events are overwritten
+					if(head - this->_cursor > EventBus::CAPACITY)
+					{
+						uint64_t cursor = (this->_overflow == EventBus::Overflow::DropOldest) ? head - EventBus::CAPACITY : head;
+
+						this->_dropped.fetch_add(cursor - this->_cursor, std::memory_order_relaxed);
+						this->_cursor = cursor;
+
+						continue;
+					}
+
+					const Slot& slot = this->_bus._slots[this->_cursor & (EventBus::CAPACITY - 1)];
+					uint64_t expected = 2 * this->_cursor + 2;
+					uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+					// Still being written, try again on the next poll
+					if(sequence < expected)
+					{
+						break;
+					}
+
+					MoHRS::Event event = slot.event;
+
+					std::atomic_thread_fence(std::memory_order_acquire);
+
+					// Overwritten by a newer event before or while copying
+					if(sequence != expected || slot.sequence.load(std::memory_order_relaxed) != expected)
+					{
+						this->_dropped.fetch_add(1, std::memory_order_relaxed);
+						this->_cursor++;
+
+						continue;
+					}
+
+					this->_cursor++;
+					count++;
+
+					func(event);
+				}
+
+				return count;
+			}
+
+			/**
+			 * @brief Get the number of events that were lost because the subscriber fell behind.
+			 * @return The number of events.
+			 */
+			uint64_t GetNumDropped() const { return this->_dropped.load(std::memory_order_relaxed); }
+	};
+}
+
+#endif // MOHRS_EVENT_BUS_H
@@ -0,0 +1,182 @@
+#include <queue>
+
+#include <mohrs/favorites.h>
+
+MoHRS::FavoriteMatcher::FavoriteMatcher(std::string_view patterns)
+{
+	std::vector<std::string_view> split_patterns;
+	size_t total_size = 0;
+
+	// Split on ';' like Util::splitFavorite
+	while(!patterns.empty())
+	{
+		size_t end = patterns.find(';');
+		std::string_view pattern = patterns.substr(0, end);
+
+		// An empty pattern is found in every text
+		if(pattern.empty())
+		{
+			this->_match_all = true;
+		}
+
+		split_patterns.push_back(pattern);
+		total_size += pattern.size();
+
+		patterns.remove_prefix(end == std::string_view::npos ? patterns.size() : end + 1);
+	}
+
+	if(this->_match_all || split_patterns.empty() || total_size >= UINT16_MAX)
+	{
+		return;
+	}
+
+	// Give every byte that is used in a pattern its own column
+	for(std::string_view pattern : split_patterns)
+	{
+		for(unsigned char c : pattern)
+		{
+			if(this->_classes[c] == 0)
+			{
+				this->_classes[c] = this->_num_classes++;
+			}
+		}
+	}
+
+	// Build the trie, 0 is the root so it marks a missing child
+	size_t num_states = 1;
+
+	this->_transitions.assign((total_size + 1) * this->_num_classes, 0);
+	this->_matches.assign(total_size + 1, false);
+
+	for(std::string_view pattern : split_patterns)
+	{
+		size_t state = 0;
+
+		for(unsigned char c : pattern)
+		{
+			uint16_t& next = this->_transitions[state * this->_num_classes + this->_classes[c]];
+
+			if(next == 0)
+			{
+				next = num_states++;
+			}
+
+			state = next;
+		}
+
+		this->_matches[state] = true;
+	}
+
+	// Fill in the missing transitions in breadth-first order with the transitions of the failure state
+	std::vector<uint16_t> failures(num_states, 0);
+	std::queue<uint16_t> states;
+
+	for(size_t c = 0; c < this->_num_classes; c++)
+	{
+		uint16_t next = this->_transitions[c];
+
+		if(next != 0)
+		{
+			states.push(next);
+		}
+	}
+
+	while(!states.empty())
+	{
+		uint16_t state = states.front();
+		uint16_t failure = failures[state];
+
+		states.pop();
+
+		this->_matches[state] = this->_matches[state] || this->_matches[failure];
+
+		for(size_t c = 0; c < this->_num_classes; c++)
+		{
+			uint16_t& next = this->_transitions[state * this->_num_classes + c];
+			uint16_t failure_next = this->_transitions[failure * this->_num_classes + c];
+
+			if(next != 0)
+			{
+				failures[next] = failure_next;
+				states.push(next);
+			}
+			else
+			{
+				next = failure_next;
+			}
+		}
+	}
+
+	this->_transitions.resize(num_states * this->_num_classes);
+	this->_matches.resize(num_states);
+}
+
+bool MoHRS::FavoriteMatcher::Matches(std::string_view text) const
+{
+	if(this->_match_all)
+	{
+		return true;
+	}
+
+	if(this->_transitions.empty())
+	{
+		return false;
+	}
+
+	size_t state = 0;
+
+	for(unsigned char c : text)
+	{
+		state = this->_transitions[state * this->_num_classes + this->_classes[c]];
+
+		if(this->_matches[state])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+MoHRS::Favorites::Favorites(const Theater::ParameterView& parameter) :
+	_enabled(parameter.Has("FAV-GAME") && parameter.Has("FAV-PLAYER")),
+	_games(parameter.Get("FAV-GAME")),
+	_players(parameter.Get("FAV-PLAYER"))
+{
+
+}
+
+void MoHRS::Favorites::Count(const MoHRS::Game& game, int& num_fav_games, int& num_fav_players) const
+{
+	if(!this->_enabled)
+	{
+		return;
+	}
+
+	if(this->_games.Matches(game.GetName()))
+	{
+		num_fav_games++;
+	}
+
+	for(const MoHRS::Player& player : game.GetPlayers())
+	{
+		if(this->_players.Matches(player.GetName()))
+		{
+			num_fav_players++;
+		}
+	}
+}
+
+void MoHRS::Favorites::Count(const std::vector<MoHRS::GamePtr>& games, int& num_fav_games, int& num_fav_players) const
+{
+	// Without favorites the games are not visited at all
+	if(!this->_enabled)
+	{
+		return;
+	}
+
+	for(const MoHRS::GamePtr& game : games)
+	{
+		this->Count(*game, num_fav_games, num_fav_players);
+	}
+}
@@ -0,0 +1,88 @@
+#ifndef MOHRS_FAVORITES_H
+#define MOHRS_FAVORITES_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include <mohrs/game.h>
+#include <theater/parameter_view.h>
+
+/**
+    Medal of Honor - Rising Sun
+*/
+namespace MoHRS
+{
+	/**
+	 * @brief Finds if a text contains any of a list of patterns in a single pass.
+	 *
+	 * The patterns are compiled into an Aho-Corasick automaton with every transition filled in,
+	 * so matching reads each byte of the text once and never backtracks. Bytes that are not in
+	 * any pattern share a single column of the transition table to keep it small.
+	 */
+	class FavoriteMatcher
+	{
+		private:
+			std::array<uint8_t, 256> _classes{};         /**< Column of every byte in the transition table, 0 for bytes in no pattern. */
+			size_t                   _num_classes = 1;   /**< Number of columns in the transition table. */
+			std::vector<uint16_t>    _transitions;       /**< Next state for every state and column. */
+			std::vector<bool>        _matches;           /**< A pattern ends in the state or in one of its suffixes. */
+			bool                     _match_all = false; /**< An empty pattern matches every text. */
+
+		public:
+			/**
+			 * @brief Compile a list of patterns.
+			 *
+			 * @param patterns The patterns separated by ';', as sent in FAV-GAME and FAV-PLAYER.
+			 */
+			explicit FavoriteMatcher(std::string_view patterns);
+
+			/**
+			 * @brief Check if a text contains any of the patterns.
+			 *
+			 * @param text The text to search.
+			 * @return True if at least one pattern is found.
+			 */
+			bool Matches(std::string_view text) const;
+	};
+
+	/**
+	 * @brief Favorite games and players of a client, compiled once per request.
+	 */
+	class Favorites
+	{
+		private:
+			bool                   _enabled; /**< The client sent both FAV-GAME and FAV-PLAYER. */
+			MoHRS::FavoriteMatcher _games;   /**< Matches game names. */
+			MoHRS::FavoriteMatcher _players; /**< Matches player names. */
+
+		public:
+			/**
+			 * @brief Compile the favorites of a request.
+			 *
+			 * @param parameter The parameters of the request.
+			 */
+			explicit Favorites(const Theater::ParameterView& parameter);
+
+			/**
+			 * @brief Count the favorites in a game.
+			 *
+			 * @param game The game.
+			 * @param num_fav_games[in,out] Increased by one when the name of the game is a favorite.
+			 * @param num_fav_players[in,out] Increased by the number of players that are a favorite.
+			 */
+			void Count(const MoHRS::Game& game, int& num_fav_games, int& num_fav_players) const;
+
+			/**
+			 * @brief Count the favorites in a list of games.
+			 *
+			 * @param games The games.
+			 * @param num_fav_games[in,out] Increased by the number of games that are a favorite.
+			 * @param num_fav_players[in,out] Increased by the number of players that are a favorite.
+			 */
+			void Count(const std::vector<MoHRS::GamePtr>& games, int& num_fav_games, int& num_fav_players) const;
+	};
+}
+
+#endif // MOHRS_FAVORITES_H
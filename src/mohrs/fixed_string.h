@@ -0,0 +1,56 @@
+#ifndef MOHRS_FIXED_STRING_H
+#define MOHRS_FIXED_STRING_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+    Medal of Honor - Rising Sun
+*/
+namespace MoHRS
+{
+	/**
+	 * @brief String stored inline with a fixed capacity.
+	 * @details Longer values are rejected, never cut. Keeping the characters inside the owning object
+	 * means copying a game is a single memcpy-like copy and reading a name never follows a pointer.
+	 */
+	template<size_t N>
+	class FixedString
+	{
+		static_assert(N <= UINT8_MAX, "FixedString stores its size in a byte");
+
+		private:
+			std::array<char, N> _data;     /**< The characters, not terminated. */
+			uint8_t             _size = 0; /**< Number of characters in use. */
+
+		public:
+			/**
+			 * @brief Replace the value.
+			 * @param value The new value.
+			 * @return False if the value is longer than N characters, the current value is kept.
+			 */
+			bool Assign(std::string_view value)
+			{
+				if(value.size() > N)
+				{
+					return false;
+				}
+
+				this->_size = value.size();
+
+				std::memcpy(this->_data.data(), value.data(), this->_size);
+
+				return true;
+			}
+
+			/**
+			 * @brief Get the value.
+			 * @return View of the characters, valid as long as the object.
+			 */
+			std::string_view View() const { return std::string_view(this->_data.data(), this->_size); }
+	};
+}
+
+#endif // MOHRS_FIXED_STRING_H
@@ -1,7 +1,28 @@
+#include <arpa/inet.h>
+#include <charconv>
+
 #include <util.h>
 
 #include <mohrs/game.h>
 
+/**
+ * @brief Parse a number into a byte without throwing.
+ * @details Like the std::stoul() it replaces, digits after the number are ignored and the value wraps.
+ */
+static bool ParseByte(std::string_view str, uint8_t& value)
+{
+	unsigned long number = 0;
+
+	if(std::from_chars(str.data(), str.data() + str.size(), number).ec != std::errc())
+	{
+		return false;
+	}
+
+	value = static_cast<uint8_t>(number);
+
+	return true;
+}
+
 MoHRS::Game::Game()
 {
 
@@ -36,20 +57,25 @@ bool MoHRS::Game::SetId(const std::string& str_id)
 	return false;
 }
 
+std::string MoHRS::Game::GetIpString() const
+{
+	char ip[INET_ADDRSTRLEN];
+
+	inet_ntop(AF_INET, &this->_ip, ip, INET_ADDRSTRLEN);
+
+	return std::string(ip);
+}
+
 bool MoHRS::Game::SetIp(const std::string& ip)
 {
-	if(ip.find("10.10.10.") == 0)
-		this->_ip = "86.87.139.235";
-	else
-		this->_ip = ip;
-	
-	return true;
+	const std::string& public_ip = (ip.find("10.10.10.") == 0) ? "86.87.139.235" : ip;
+
+	return inet_pton(AF_INET, public_ip.c_str(), &this->_ip) == 1;
 }
 
-bool MoHRS::Game::SetName(const std::string& name)
+bool MoHRS::Game::SetName(std::string_view name)
 {
-	this->_name = Util::removeQuote(name);
-	return true;
+	return this->_name.Assign(Util::removeQuote(name));
 }
 
 bool MoHRS::Game::SetRegion(const MoHRS::Regions region)
@@ -70,17 +96,16 @@ bool MoHRS::Game::SetRegion(int8_t int_region)
 	return this->SetRegion(MoHRS::Regions::Unknown);
 }
 
-bool MoHRS::Game::SetRegion(const std::string& str_region)
+bool MoHRS::Game::SetRegion(std::string_view str_region)
 {
-	try
+	uint8_t int_region = 0;
+
+	if(!ParseByte(str_region, int_region))
 	{
-		uint8_t int_region = static_cast<uint8_t>(std::stoul(str_region));
-		
-		return this->SetRegion(int_region);
+		return false;
 	}
-	catch(...) {};
-	
-	return false;
+
+	return this->SetRegion(int_region);
 }
 
 bool MoHRS::Game::SetNumPlayers(uint8_t num_players)
@@ -89,17 +114,16 @@ bool MoHRS::Game::SetNumPlayers(uint8_t num_players)
 	return true;
 }
 
-bool MoHRS::Game::SetNumPlayers(const std::string& str_num_players)
+bool MoHRS::Game::SetNumPlayers(std::string_view str_num_players)
 {
-	try
+	uint8_t num_players = 0;
+
+	if(!ParseByte(str_num_players, num_players))
 	{
-		uint8_t num_players = static_cast<uint8_t>(std::stoul(str_num_players));
-		
-		return this->SetNumPlayers(num_players);
+		return false;
 	}
-	catch(...) {};
-	
-	return false;
+
+	return this->SetNumPlayers(num_players);
 }
 
 bool MoHRS::Game::SetMaxPlayers(uint8_t max_players)
@@ -108,41 +132,69 @@ bool MoHRS::Game::SetMaxPlayers(uint8_t max_players)
 	return true;
 }
 
-bool MoHRS::Game::SetMaxPlayers(const std::string& str_max_players)
+bool MoHRS::Game::SetMaxPlayers(std::string_view str_max_players)
 {
-	try
+	uint8_t max_players = 0;
+
+	if(!ParseByte(str_max_players, max_players))
 	{
-		uint8_t max_players = static_cast<uint8_t>(std::stoul(str_max_players));
-		
-		return this->SetMaxPlayers(max_players);
+		return false;
 	}
-	catch(...) {};
-	
-	return false;
+
+	return this->SetMaxPlayers(max_players);
 }
 
-bool MoHRS::Game::SetHostPlayer(const std::string& host_player)
+bool MoHRS::Game::SetHostPlayer(std::string_view host_player)
 {
-	this->_host_player = Util::removeQuote(host_player);
-	return true;
+	return this->_host_player.Assign(Util::removeQuote(host_player));
 }
 
-bool MoHRS::Game::SetTheaterSession(const std::string& theater_session)
+bool MoHRS::Game::SetTheaterSession(std::string_view theater_session)
 {
-	this->_theater_session = theater_session;
-	return true;
+	return this->_theater_session.Assign(theater_session);
 }
 
-bool MoHRS::Game::SetPlayers(const MoHRS::Players& players)
+bool MoHRS::Game::SetPlayers(Util::Span<MoHRS::Player> players)
 {
-	this->_players = players;
+	this->_num_listed = 0;
+
+	for(const MoHRS::Player& player : players)
+	{
+		if(!this->AddPlayer(player))
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
 
+bool MoHRS::Game::HasPlayers(Util::Span<MoHRS::Player> players) const
+{
+	if(players.size() != this->_num_listed)
+	{
+		return false;
+	}
+
+	for(size_t i = 0; i < players.size(); i++)
+	{
+		if(!(players[i] == this->_players[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
 
 bool MoHRS::Game::AddPlayer(const MoHRS::Player& player)
 {
-	this->_players.push_back(player);
+	if(this->_num_listed >= MoHRS::MAX_PLAYERS)
+	{
+		return false;
+	}
+
+	this->_players[this->_num_listed++] = player;
 
 	return true;
 }
@@ -1,10 +1,15 @@
 #ifndef MOHRS_GAME_H
 #define MOHRS_GAME_H
 
+#include <array>
 #include <vector>
 #include <string>
+#include <memory>
+#include <string_view>
+#include <util.h>
 #include <mohrs/region.h>
 #include <mohrs/player.h>
+#include <mohrs/fixed_string.h>
 
 /**
     Medal of Honor - Rising Sun
@@ -15,53 +20,86 @@ namespace MoHRS
 
 	typedef std::vector<Game> Games;
 
+	/**
+	 * @brief Shared immutable game, as published in the snapshots of the matchmaker.
+	 */
+	typedef std::shared_ptr<const Game> GamePtr;
+
+	/**
+	 * @brief Maximum number of players in a game.
+	 */
+	const size_t MAX_PLAYERS = 8;
+
+	/**
+	 * @brief Maximum length of a game name.
+	 * @details The Theater protocol sets no limit, this server chose it to store names inline.
+	 * A CGAM with a longer name is rejected, see Matchmaker::createGame().
+	 */
+	const size_t MAX_GAME_NAME = 64;
+
+	/**
+	 * @brief Maximum length of a theater session, the longest address "255.255.255.255:65535" is 21 characters.
+	 */
+	const size_t MAX_THEATER_SESSION = 24;
+
 	/**
 	 * @brief Represents a game.
+	 * @details All data is stored inline, so a game is a single block of memory without allocations.
+	 * The fields that are read on every scan come first and share the first cache line.
 	 */
 	class Game
 	{
 		private:
-			int            _id              = -1;                      /**< The ID of the game. */
-			std::string    _ip              = "";                      /**< The IP address of the game server. */
-			std::string    _name            = "";                      /**< The name of the game. */
-			MoHRS::Regions _region          = MoHRS::Regions::Unknown; /**< The region of the game. */
-			uint8_t        _num_players     = 0;                       /**< The number of players currently in the game. */
-			uint8_t        _max_players     = 8;                       /**< The maximum number of players allowed in the game. */
-			std::string    _host_player     = "";                      /**< The host player of the game. */
-			Players        _players;                                   /**< The players currently in the game. */
-			std::string    _theater_session = "";                      /**< The theater session associated with the game. */
+			int                                     _id              = -1;                      /**< The ID of the game. */
+			MoHRS::Regions                          _region          = MoHRS::Regions::Unknown; /**< The region of the game. */
+			uint8_t                                 _num_players     = 0;                       /**< The number of players currently in the game. */
+			uint8_t                                 _max_players     = 8;                       /**< The maximum number of players allowed in the game. */
+			uint8_t                                 _num_listed      = 0;                       /**< The number of players in _players. */
+			uint32_t                                _ip              = 0;                       /**< The IPv4 address of the game server in network byte order. */
+			MoHRS::FixedString<MAX_GAME_NAME>       _name;                                      /**< The name of the game. */
+			MoHRS::FixedString<MAX_PLAYER_NAME>     _host_player;                               /**< The host player of the game. */
+			MoHRS::FixedString<MAX_THEATER_SESSION> _theater_session;                           /**< The theater session associated with the game. */
+			std::array<Player, MAX_PLAYERS>         _players;                                   /**< The players currently in the game. */
 
 		public:
 			Game();
 			~Game();
 
-			int            GetId() const             { return this->_id;              }
-			std::string    GetIp() const             { return this->_ip;              }
-			std::string    GetName() const           { return this->_name;            }
-			MoHRS::Regions GetRegion() const         { return this->_region;          }
-			std::string    GetRegionString() const;
-			uint8_t        GetNumPlayers() const     { return this->_num_players;     }
-			uint8_t        GetMaxPlayers() const     { return this->_max_players;     }
-			std::string    GetHostPlayer() const     { return this->_host_player;     }
-			std::string    GetTheaterSession() const { return this->_theater_session; }
-			Players        GetPlayers() const        { return this->_players;         }
+			int                 GetId() const             { return this->_id;                                       }
+			uint32_t            GetIp() const             { return this->_ip;                                       }
+			std::string         GetIpString() const;
+			std::string_view    GetName() const           { return this->_name.View();                              }
+			MoHRS::Regions      GetRegion() const         { return this->_region;                                   }
+			std::string         GetRegionString() const;
+			uint8_t             GetNumPlayers() const     { return this->_num_players;                              }
+			uint8_t             GetMaxPlayers() const     { return this->_max_players;                              }
+			std::string_view    GetHostPlayer() const     { return this->_host_player.View();                       }
+			std::string_view    GetTheaterSession() const { return this->_theater_session.View();                   }
+			Util::Span<Player>  GetPlayers() const        { return Util::Span<Player>(this->_players.data(), this->_num_listed); }
 
 			bool SetId(int id);
 			bool SetId(const std::string& str_id);
 			bool SetIp(const std::string& ip);
-			bool SetName(const std::string& name);
+			bool SetName(std::string_view name);
 			bool SetRegion(const MoHRS::Regions region);
 			bool SetRegion(int8_t int_region);
-			bool SetRegion(const std::string& str_region);
+			bool SetRegion(std::string_view str_region);
 			bool SetNumPlayers(uint8_t num_players);
-			bool SetNumPlayers(const std::string& str_num_players);
+			bool SetNumPlayers(std::string_view str_num_players);
 			bool SetMaxPlayers(uint8_t max_players);
-			bool SetMaxPlayers(const std::string& str_max_players);
-			bool SetHostPlayer(const std::string& host_player);
-			bool SetTheaterSession(const std::string& theater_session);
-			bool SetPlayers(const MoHRS::Players& players);
+			bool SetMaxPlayers(std::string_view str_max_players);
+			bool SetHostPlayer(std::string_view host_player);
+			bool SetTheaterSession(std::string_view theater_session);
+			bool SetPlayers(Util::Span<Player> players);
 			
 			bool AddPlayer(const Player& player);
+
+			/**
+			 * @brief Check if the game lists exactly these players.
+			 * @param players The players, in order.
+			 * @return True if the names and tickets are the same, false otherwise.
+			 */
+			bool HasPlayers(Util::Span<Player> players) const;
 	};
 }
 
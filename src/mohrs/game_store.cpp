@@ -0,0 +1,72 @@
+#include <mohrs/game_store.h>
+
+MoHRS::GamePtr MoHRS::GameStore::Insert(MoHRS::Game game)
+{
+	uint32_t index;
+
+	if(this->_free_head != NO_SLOT)
+	{
+		// Reuse a free slot
+		index = this->_free_head;
+		this->_free_head = this->_slots[index].next_free;
+	}
+	else
+	{
+		index = this->_slots.size();
+		this->_slots.emplace_back();
+	}
+
+	Slot& slot = this->_slots[index];
+	std::vector<uint32_t>& region = this->_regions[MoHRS::GetRegionIndex(game.GetRegion())];
+
+	slot.game = std::make_shared<const MoHRS::Game>(std::move(game));
+	slot.region_position = region.size();
+
+	region.push_back(index);
+	this->_sessions[std::string(slot.game->GetTheaterSession())] = index;
+
+	return slot.game;
+}
+
+MoHRS::GamePtr MoHRS::GameStore::Find(const std::string& theater_session) const
+{
+	auto it = this->_sessions.find(theater_session);
+
+	if(it == this->_sessions.end())
+	{
+		return nullptr;
+	}
+
+	return this->_slots[it->second].game;
+}
+
+MoHRS::GamePtr MoHRS::GameStore::Remove(const std::string& theater_session)
+{
+	auto it = this->_sessions.find(theater_session);
+
+	if(it == this->_sessions.end())
+	{
+		return nullptr;
+	}
+
+	uint32_t index = it->second;
+	Slot& slot = this->_slots[index];
+	std::vector<uint32_t>& region = this->_regions[MoHRS::GetRegionIndex(slot.game->GetRegion())];
+
+	// Close the gap so the region keeps its games in the order they were inserted
+	region.erase(region.begin() + slot.region_position);
+
+	for(uint32_t position = slot.region_position; position < region.size(); position++)
+	{
+		this->_slots[region[position]].region_position = position;
+	}
+
+	this->_sessions.erase(it);
+
+	MoHRS::GamePtr game = std::move(slot.game);
+	slot.game.reset();
+	slot.next_free = this->_free_head;
+	this->_free_head = index;
+
+	return game;
+}
@@ -0,0 +1,155 @@
+#ifndef MOHRS_GAME_STORE_H
+#define MOHRS_GAME_STORE_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <memory>
+
+#include <mohrs/game.h>
+#include <mohrs/region.h>
+
+/**
+    Medal of Honor - Rising Sun
+*/
+namespace MoHRS
+{
+	/**
+	 * @brief Games in stable slots with an index by theater session and by region.
+	 *
+	 * Creating and finding a game by its theater session are O(1). Every region keeps the slots
+	 * of its games in the order they were inserted, so a region query only visits the games of
+	 * that region and lists them oldest first. Removing a game closes the gap in its region, that
+	 * is linear in the games of the region, but games are removed far less often than listed.
+	 * Games keep the id the owner gave them. Stored games are immutable, an update replaces the
+	 * game with a changed copy, so snapshots that share a game never see it change.
+	 * The store is not thread-safe, the owner must lock it.
+	 */
+	class GameStore
+	{
+		private:
+			/**
+			 * @brief A slot that holds a game or is on the free list.
+			 */
+			struct Slot
+			{
+				MoHRS::GamePtr game;            /**< The game, empty when the slot is free. */
+				uint32_t       region_position; /**< Position of the slot in the list of its region. */
+				uint32_t       next_free;       /**< Next slot on the free list. */
+			};
+
+			static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+			std::vector<Slot>                                     _slots;               /**< The slots. */
+			uint32_t                                              _free_head = NO_SLOT; /**< First free slot. */
+			std::unordered_map<std::string, uint32_t>             _sessions;            /**< Theater session to slot. */
+			std::array<std::vector<uint32_t>, MoHRS::NUM_REGIONS> _regions;             /**< Slots of the games in every region, oldest first. */
+
+		public:
+			/**
+			 * @brief Insert a game.
+			 *
+			 * @param game The game, its theater session must not be in the store yet.
+			 * @return The stored game.
+			 */
+			MoHRS::GamePtr Insert(MoHRS::Game game);
+
+			/**
+			 * @brief Find the game of a theater session.
+			 *
+			 * @param theater_session The theater session.
+			 * @return The game, empty when the session has no game.
+			 */
+			MoHRS::GamePtr Find(const std::string& theater_session) const;
+
+			/**
+			 * @brief Replace the game of a theater session with a changed copy.
+			 *
+			 * The copy is changed on the stack first, the stored game is only replaced when func
+			 * reports a change. An update without changes does not allocate and keeps the game.
+			 *
+			 * @param theater_session The theater session.
+			 * @param func Called with a reference to the copy to change it, returns true if it changed anything.
+			 * @return The current game, empty when the session has no game.
+			 */
+			template<typename Func>
+			MoHRS::GamePtr Update(const std::string& theater_session, Func&& func)
+			{
+				auto it = this->_sessions.find(theater_session);
+
+				if(it == this->_sessions.end())
+				{
+					return nullptr;
+				}
+
+				MoHRS::GamePtr& game = this->_slots[it->second].game;
+				MoHRS::Game updated_game = *game;
+
+				if(func(updated_game))
+				{
+					game = std::make_shared<const MoHRS::Game>(updated_game);
+				}
+
+				return game;
+			}
+
+			/**
+			 * @brief Remove the game of a theater session.
+			 *
+			 * @param theater_session The theater session.
+			 * @return The removed game, empty when the session has no game.
+			 */
+			MoHRS::GamePtr Remove(const std::string& theater_session);
+
+			/**
+			 * @brief Get the number of games in the store.
+			 *
+			 * @return The number of games.
+			 */
+			size_t Size() const { return this->_sessions.size(); }
+
+			/**
+			 * @brief Get the number of games in a region.
+			 *
+			 * @param region The region.
+			 * @return The number of games.
+			 */
+			size_t Size(MoHRS::Regions region) const { return this->_regions[MoHRS::GetRegionIndex(region)].size(); }
+
+			/**
+			 * @brief Visit every game.
+			 *
+			 * @param func Called with a const reference to the pointer of each game.
+			 */
+			template<typename Func>
+			void ForEach(Func&& func) const
+			{
+				for(const Slot& slot : this->_slots)
+				{
+					if(slot.game)
+					{
+						func(slot.game);
+					}
+				}
+			}
+
+			/**
+			 * @brief Visit the games of a region in the order they were inserted.
+			 *
+			 * @param region The region.
+			 * @param func Called with a const reference to the pointer of each game.
+			 */
+			template<typename Func>
+			void ForEach(MoHRS::Regions region, Func&& func) const
+			{
+				for(uint32_t index : this->_regions[MoHRS::GetRegionIndex(region)])
+				{
+					func(this->_slots[index].game);
+				}
+			}
+	};
+}
+
+#endif // MOHRS_GAME_STORE_H
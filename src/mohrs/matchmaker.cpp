@@ -1,12 +1,38 @@
 #include <globals.h>
+#include <logger.h>
+#include <server.h>
 #include <mohrs/game.h>
-#include <service/discord.h>
+#include <mohrs/event_bus.h>
 
 #include <mohrs/matchmaker.h>
 
+static const std::string_view PLAYER_NAME_KEYS[MoHRS::MAX_PLAYERS] =
+{
+	"PLAYER-NAME.1", "PLAYER-NAME.2", "PLAYER-NAME.3", "PLAYER-NAME.4",
+	"PLAYER-NAME.5", "PLAYER-NAME.6", "PLAYER-NAME.7", "PLAYER-NAME.8",
+};
+
+static const std::string_view TICKET_KEYS[MoHRS::MAX_PLAYERS] =
+{
+	"TICKET.1", "TICKET.2", "TICKET.3", "TICKET.4",
+	"TICKET.5", "TICKET.6", "TICKET.7", "TICKET.8",
+};
+
 MoHRS::Matchmaker::Matchmaker()
 {
+	for(const auto& region : MoHRS::RegionNames)
+	{
+		std::unique_ptr<Shard>& shard = this->_shards[MoHRS::GetRegionIndex(region.first)];
 
+		shard = std::make_unique<Shard>();
+		shard->region = region.first;
+
+		// Readers always find a snapshot
+		shard->snapshot = std::make_shared<const MoHRS::RegionSnapshot>();
+
+		shard->thread = std::thread(&MoHRS::Matchmaker::_runShard, this, shard.get());
+		shard->thread.detach();
+	}
 }
 
 MoHRS::Matchmaker::~Matchmaker()
@@ -14,189 +40,368 @@ MoHRS::Matchmaker::~Matchmaker()
 	
 }
 
-bool MoHRS::Matchmaker::createGame(const Theater::Client& client, const Theater::Parameter& parameter, MoHRS::Game& game)
+bool MoHRS::Matchmaker::createGame(const Theater::Client& client, const Theater::ParameterView& parameter, CreateCallback on_created)
 {
-	try
-	{
-		MoHRS::Player player;
-		std::string host_player = parameter.at("HOST-PLAYER");
-
-		// Set game server information
-		game.SetName(parameter.at("NAME"));
-		game.SetRegion(parameter.at("REGION-ID"));
-		game.SetMaxPlayers(parameter.at("MAX-PLAYERS"));
-		game.SetHostPlayer(host_player);
-		game.SetNumPlayers(1);
-		
-		// Set server information
-		game.SetIp(client.GetIP());
-		game.SetTheaterSession(client.GetAddress());
-
-		// Set Player
-		player.SetName(host_player);
-		game.AddPlayer(player);
-		
-		{
-			std::unique_lock<std::shared_mutex> guard(this->_mutex); // matchmaker lock (read/write)
+	std::string_view host_player, name, region_id, max_players;
+	
+	if(!parameter.Get("HOST-PLAYER", host_player) || !parameter.Get("NAME", name) ||
+		!parameter.Get("REGION-ID", region_id) || !parameter.Get("MAX-PLAYERS", max_players))
+	{
+		return false;
+	}
+	
+	Write write;
+	write.type = Write::Type::Create;
+	write.theater_session = client.GetAddress();
+	write.on_created = std::move(on_created);
+
+	MoHRS::Game& game = write.game;
+	MoHRS::Player player;
+
+	// Set game server information, names that do not fit are rejected instead of cut
+	if(!game.SetName(name) || !game.SetHostPlayer(host_player) || !player.SetName(host_player))
+	{
+		this->_reject(client, "CGAM");
+		return false;
+	}
+
+	game.SetRegion(region_id);
+	game.SetMaxPlayers(max_players);
+	game.SetNumPlayers(1);
+	
+	// Set server information
+	game.SetIp(client.GetIP());
+	game.SetTheaterSession(client.GetAddress());
+
+	// Set Player
+	game.AddPlayer(player);
+
+	MoHRS::Regions region = game.GetRegion();
+	MoHRS::Regions old_region = region;
+	bool has_game;
+
+	{
+		std::lock_guard<std::mutex> guard(this->_routes_mutex); // routes lock
+
+		auto it = this->_routes.find(write.theater_session);
 
-			// Generate new game id
-			int new_id = (this->_games.size() > 0) ? this->_games.back().GetId() + 1 : 1;
-			game.SetId(new_id);
+		has_game = (it != this->_routes.end());
 
-			// Save new game
-			this->_games.push_back(game);
+		if(has_game)
+		{
+			old_region = it->second;
+			it->second = region;
+		}
+		else
+		{
+			this->_routes.emplace(write.theater_session, region);
 		}
 	}
-	catch(const std::exception& e)
+
+	// A client hosts a single game, the shard of the new game replaces a game in the same region
+	if(has_game && old_region != region)
 	{
-		return false;
+		Write remove;
+		remove.type = Write::Type::Remove;
+		remove.theater_session = write.theater_session;
+
+		this->_pushWrite(old_region, std::move(remove));
 	}
 
-	// Send discord message
-	g_discord->Send("Player \"" + game.GetHostPlayer() + "\" created server called \"" + game.GetName() + "\" in region \"" + game.GetRegionString() + "\"");
+	this->_pushWrite(region, std::move(write));
 
 	return true;
 }
 
-bool MoHRS::Matchmaker::updateGame(const Theater::Client& client, const Theater::Parameter& parameter)
+void MoHRS::Matchmaker::updateGame(const Theater::Client& client, const Theater::ParameterView& parameter)
 {
-	MoHRS::Players players;
-	std::string num_players = "1";
+	Write write;
+	write.type = Write::Type::Update;
+	write.theater_session = client.GetAddress();
 
-	try
-	{
-		num_players = parameter.at("NUM-PLAYERS");
+	std::string_view num_players = "1";
 
-		for(int i = 1; i <= 8; i++)
+	if(parameter.Get("NUM-PLAYERS", num_players))
+	{
+		for(size_t i = 0; i < MoHRS::MAX_PLAYERS; i++)
 		{
+			std::string_view name, ticket;
+			
+			// Players are numbered from 1 without gaps
+			if(!parameter.Get(PLAYER_NAME_KEYS[i], name) || !parameter.Get(TICKET_KEYS[i], ticket))
+			{
+				break;
+			}
+			
 			MoHRS::Player player;
 
-			player.SetName(parameter.at("PLAYER-NAME." + std::to_string(i)));
-			player.SetTicket(parameter.at("TICKET." + std::to_string(i)));
+			if(!player.SetName(name) || !player.SetTicket(ticket))
+			{
+				this->_reject(client, "UGAM");
+				return;
+			}
 
-			players.push_back(player);
+			write.game.AddPlayer(player);
 		}
 	}
-	catch(const std::exception& e) {}
 
-	std::unique_lock<std::shared_mutex> guard(this->_mutex); // matchmaker lock (read/write)
+	write.has_num_players = write.game.SetNumPlayers(num_players);
 
-	MoHRS::Games::iterator game_it;
-	std::string address = client.GetAddress();
+	MoHRS::Regions region;
 
-	for(game_it = this->_games.begin(); game_it != this->_games.end(); ++game_it)
 	{
-		if(game_it->GetTheaterSession() == address)
-		{
-			game_it->SetNumPlayers(num_players);
-			game_it->SetPlayers(players);
+		std::lock_guard<std::mutex> guard(this->_routes_mutex); // routes lock
 
-			return true;
+		auto it = this->_routes.find(write.theater_session);
+
+		// Client has no game
+		if(it == this->_routes.end())
+		{
+			return;
 		}
+
+		region = it->second;
 	}
 
-	return false;
+	this->_pushWrite(region, std::move(write));
 }
 
-bool MoHRS::Matchmaker::removeGame(const std::string& address)
+void MoHRS::Matchmaker::removeGame(const std::string& address)
 {
-	std::unique_lock<std::shared_mutex> guard(this->_mutex); // matchmaker lock (read/write)
+	MoHRS::Regions region;
 
-	MoHRS::Games::const_iterator game_it;
-
-	for(game_it = this->_games.begin(); game_it != this->_games.end(); ++game_it)
 	{
-		if(game_it->GetTheaterSession() == address)
-		{
-			// Send discord message
-			g_discord->Send("Player \"" + game_it->GetHostPlayer() + "\" closed server called \"" + game_it->GetName() + "\" in region \"" + game_it->GetRegionString() + "\"");
+		std::lock_guard<std::mutex> guard(this->_routes_mutex); // routes lock
 
-			// Remove the game server out of the list
-			this->_games.erase(game_it);
+		auto it = this->_routes.find(address);
 
-			// Go back one item value
-			game_it--;
+		// Client has no game
+		if(it == this->_routes.end())
+		{
+			return;
 		}
+
+		region = it->second;
+		this->_routes.erase(it);
 	}
 
-	return true;
+	Write write;
+	write.type = Write::Type::Remove;
+	write.theater_session = address;
+
+	this->_pushWrite(region, std::move(write));
 }
 
-bool MoHRS::Matchmaker::findGamesByRegion(MoHRS::Regions region, MoHRS::Games& games) const
+MoHRS::Games MoHRS::Matchmaker::GetGames() const
 {
-	std::shared_lock<std::shared_mutex> guard(this->_mutex); // matchmaker lock (read)
+	MoHRS::Games games;
 
-	for(const MoHRS::Game& game : this->_games)
+	for(const auto& region : MoHRS::RegionNames)
 	{
-		if(game.GetRegion() == region)
-			games.push_back(game);
+		std::shared_ptr<const MoHRS::RegionSnapshot> snapshot = this->GetSnapshot(region.first);
+
+		for(const MoHRS::GamePtr& game : snapshot->games)
+		{
+			games.push_back(*game);
+		}
 	}
 
-	return true;
+	return games;
 }
 
-bool MoHRS::Matchmaker::findFavoritesByGame(const Theater::Parameter& parameter, const MoHRS::Game& game, int& num_fav_games, int& num_fav_players) const
+std::shared_ptr<const MoHRS::RegionSnapshot> MoHRS::Matchmaker::GetSnapshot(MoHRS::Regions region) const
+{
+	return std::atomic_load(&this->_shards[MoHRS::GetRegionIndex(region)]->snapshot);
+}
+
+//	Private functions
+
+void MoHRS::Matchmaker::_runShard(Shard* shard)
 {
-	if(parameter.find("FAV-GAME") != parameter.end() && parameter.find("FAV-PLAYER") != parameter.end())
+	std::vector<Write> batch;
+
+	while(true)
 	{
-		// Collect favorites
-		std::vector<std::string> fav_games = Util::splitFavorite(parameter.at("FAV-GAME"));
-		std::vector<std::string> fav_players = Util::splitFavorite(parameter.at("FAV-PLAYER"));
+		{
+			std::unique_lock<std::mutex> lock(shard->mutex); // shard lock
+
+			shard->cv.wait(lock, [shard] { return !shard->queue.empty(); });
 
-		this->_checkFavoriteGame(game, fav_games, num_fav_games);
-		this->_checkFavoritePlayers(game, fav_players, num_fav_players);
+			// Take everything that was queued, writers fill the other buffer meanwhile
+			batch.swap(shard->queue);
+		}
+
+		this->_applyBatch(*shard, batch);
+
+		batch.clear();
 	}
+}
 
-	return true;
+void MoHRS::Matchmaker::_reject(const Theater::Client& client, const std::string& action)
+{
+	uint64_t count = this->_num_rejected.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	// Only log on powers of two, so a misbehaving client can not flood the log
+	if((count & (count - 1)) == 0)
+	{
+		Logger::warning("Client " + client.GetAddress() + " sent " + action + " with a value that is too long, request ignored (" +
+			std::to_string(count) + " rejected requests)", Server::Type::Theater);
+	}
 }
 
-bool MoHRS::Matchmaker::findFavoritesByGames(const Theater::Parameter& parameter, const MoHRS::Games& games, int& num_fav_games, int& num_fav_players) const
+void MoHRS::Matchmaker::_pushWrite(MoHRS::Regions region, Write&& write)
 {
-	if(parameter.find("FAV-GAME") != parameter.end() && parameter.find("FAV-PLAYER") != parameter.end())
+	Shard& shard = *this->_shards[MoHRS::GetRegionIndex(region)];
+
 	{
-		// Collect favorites
-		std::vector<std::string> fav_games = Util::splitFavorite(parameter.at("FAV-GAME"));
-		std::vector<std::string> fav_players = Util::splitFavorite(parameter.at("FAV-PLAYER"));
-		
-		for(const MoHRS::Game& game : games)
-		{
-			this->_checkFavoriteGame(game, fav_games, num_fav_games);
-			this->_checkFavoritePlayers(game, fav_players, num_fav_players);
-		}
+		std::lock_guard<std::mutex> guard(shard.mutex); // shard lock
+
+		shard.queue.push_back(std::move(write));
 	}
 
-	return true;
+	shard.cv.notify_one();
 }
 
-//	Private functions
-
-void MoHRS::Matchmaker::_checkFavoriteGame(const MoHRS::Game& game, const std::vector<std::string>& fav_games, int& num_fav_games) const
+void MoHRS::Matchmaker::_applyBatch(Shard& shard, std::vector<Write>& batch)
 {
-	std::string game_name = game.GetName();
+	std::vector<MoHRS::Event> events;
+	bool dirty = false;
+
+	for(Write& write : batch)
+	{
+		dirty |= this->_applyWrite(shard, write, events);
+	}
+
+	// The region is published once per batch, however many of its games changed
+	if(dirty)
+	{
+		this->_publishSnapshot(shard);
+	}
+
+	this->_num_batches.fetch_add(1, std::memory_order_relaxed);
+	this->_num_writes.fetch_add(batch.size(), std::memory_order_relaxed);
 
-	for(const std::string& fav_game : fav_games)
+	// Acknowledge the created games now that readers can see them
+	for(const Write& write : batch)
 	{
-		if(game_name.find(fav_game) != std::string::npos)
+		if(write.type == Write::Type::Create && write.on_created)
 		{
-			num_fav_games++;
-			break;
+			write.on_created(write.game);
 		}
 	}
+
+	// Subscribers see the changes once readers can
+	for(const MoHRS::Event& event : events)
+	{
+		g_event_bus->Publish(event);
+	}
 }
 
-void MoHRS::Matchmaker::_checkFavoritePlayers(const MoHRS::Game& game, const std::vector<std::string>& fav_players, int& num_fav_players) const
+bool MoHRS::Matchmaker::_applyWrite(Shard& shard, Write& write, std::vector<MoHRS::Event>& events)
 {
-	for(const MoHRS::Player& player : game.GetPlayers())
+	switch(write.type)
 	{
-		std::string player_name = player.GetName();
+		case Write::Type::Create:
+		{
+			// A client hosts a single game
+			MoHRS::GamePtr old_game = shard.games.Remove(write.theater_session);
+
+			if(old_game)
+			{
+				shard.num_players -= old_game->GetNumPlayers();
+			}
 
-		for(const std::string& fav_player : fav_players)
+			// Save new game with a new id, the write gets the stored game for the acknowledgement
+			write.game.SetId(this->_next_id.fetch_add(1, std::memory_order_relaxed));
+			write.game = *shard.games.Insert(write.game);
+			shard.num_players += write.game.GetNumPlayers();
+
+			events.push_back(MoHRS::Event::FromGame(MoHRS::Event::Type::GameCreated, write.game));
+
+			return true;
+		}
+
+		case Write::Type::Update:
 		{
-			if(player_name.find(fav_player) != std::string::npos)
+			uint8_t old_num_players = 0;
+			bool changed = false;
+			Util::Span<MoHRS::Player> players = write.game.GetPlayers();
+
+			// Hosts send their state every few seconds, most of the time nothing changed
+			MoHRS::GamePtr game = shard.games.Update(write.theater_session, [&](MoHRS::Game& game)
 			{
-				num_fav_players++;
-				break;
+				old_num_players = game.GetNumPlayers();
+
+				if(write.has_num_players && write.game.GetNumPlayers() != old_num_players)
+				{
+					game.SetNumPlayers(write.game.GetNumPlayers());
+					changed = true;
+				}
+
+				if(!game.HasPlayers(players))
+				{
+					game.SetPlayers(players);
+					changed = true;
+				}
+
+				return changed;
+			});
+
+			if(!game)
+			{
+				return false;
+			}
+
+			this->_num_updates.fetch_add(1, std::memory_order_relaxed);
+
+			if(!changed)
+			{
+				this->_num_noop_updates.fetch_add(1, std::memory_order_relaxed);
+
+				return false;
 			}
+
+			shard.num_players = shard.num_players - old_num_players + game->GetNumPlayers();
+
+			events.push_back(MoHRS::Event::FromGame(MoHRS::Event::Type::GameUpdated, *game));
+
+			return true;
+		}
+
+		case Write::Type::Remove:
+		{
+			MoHRS::GamePtr game = shard.games.Remove(write.theater_session);
+
+			if(!game)
+			{
+				return false;
+			}
+
+			shard.num_players -= game->GetNumPlayers();
+
+			events.push_back(MoHRS::Event::FromGame(MoHRS::Event::Type::GameRemoved, *game));
+
+			return true;
 		}
 	}
-}
\ No newline at end of file
+
+	return false;
+}
+
+void MoHRS::Matchmaker::_publishSnapshot(Shard& shard)
+{
+	std::shared_ptr<MoHRS::RegionSnapshot> snapshot = std::make_shared<MoHRS::RegionSnapshot>();
+
+	snapshot->version = shard.snapshot->version + 1;
+	snapshot->num_players = shard.num_players;
+	snapshot->games.reserve(shard.games.Size(shard.region));
+
+	// The region lists its games in the order they were created, so the ids are ascending
+	shard.games.ForEach(shard.region, [&snapshot](const MoHRS::GamePtr& game)
+	{
+		snapshot->games.push_back(game);
+	});
+
+	// Readers that still hold the old snapshot keep it alive till they are done
+	std::atomic_store(&shard.snapshot, std::shared_ptr<const MoHRS::RegionSnapshot>(std::move(snapshot)));
+}
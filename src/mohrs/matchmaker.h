@@ -2,8 +2,16 @@
 #define MOHRS_MATCHMAKER_H
 
 #include <mohrs/game.h>
+#include <mohrs/game_store.h>
 #include <theater/client.h>
-#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <memory>
+#include <array>
+#include <atomic>
 
 /**
     Medal of Honor - Rising Sun
@@ -11,90 +19,188 @@
 namespace MoHRS
 {
 	class Game;
+	struct Event;
+
+	/**
+	 * @brief Immutable view of the games in a region.
+	 */
+	struct RegionSnapshot
+	{
+		uint64_t                    version = 0;     /**< Bumped every time the games of the region change. */
+		std::vector<MoHRS::GamePtr> games;           /**< The games in the region, ordered by id. */
+		uint64_t                    num_players = 0; /**< Sum of the players of the games in the region. */
+	};
 
 	/**
 	 * @brief Represents a matchmaker for managing games.
+	 * @details The games are split in one shard per region, every shard has its own game store, write
+	 * queue and applier thread. Client threads parse their requests and push the resulting writes on
+	 * the queue of the shard of the game. The applier of a shard drains its queue in batches, applies
+	 * every write of a batch to the game store and then publishes one new snapshot of the region. Only
+	 * the applier touches the game store of its shard, so a busy region never holds up another one.
+	 * Writes that only know the session of the client find the shard through the routing index.
+	 * The changes of a batch are published on the event bus once the batch is committed.
+	 * Readers copy the shared pointer to the snapshot of a region and never wait for a batch to be applied.
+	 * The copy is not lock-free: std::atomic_load and std::atomic_store on a shared_ptr take a mutex from
+	 * a small pool inside libstdc++, held only for the copy or swap of the pointer. Readers of different
+	 * regions, and other users of the pool, may wait on each other for that moment.
+	 * A snapshot stays valid as long as a reader holds it, the games in it are shared and never change.
 	 */
 	class Matchmaker
 	{
+		public:
+			/**
+			 * @brief Called on the applier thread once a created game is committed.
+			 */
+			typedef std::function<void(const MoHRS::Game& game)> CreateCallback;
+
 		private:
-			MoHRS::Games               _games;    /**< The list of games managed by the matchmaker. */
-			mutable std::shared_mutex  _mutex;    /**< The mutex for thread-safe access to the games list. */
+			/**
+			 * @brief A queued change of the game store.
+			 */
+			struct Write
+			{
+				enum class Type
+				{
+					Create, /**< Insert game, replacing the game of the session. */
+					Update, /**< Apply the player count and players of game. */
+					Remove, /**< Remove the game of the session. */
+				};
+
+				Type           type;
+				std::string    theater_session;           /**< The session that sent the write. */
+				MoHRS::Game    game;                      /**< The new game or the new state of the game. */
+				bool           has_num_players = false;   /**< The update carries a valid player count. */
+				CreateCallback on_created;                /**< Acknowledges a create. */
+			};
+
+			/**
+			 * @brief The games of a single region with the thread that applies their writes.
+			 */
+			struct Shard
+			{
+				MoHRS::Regions                               region;          /**< The region of the games. */
+				MoHRS::GameStore                             games;           /**< The games, only touched by the applier thread. */
+				std::vector<Write>                           queue;           /**< Writes waiting for the applier. */
+				std::mutex                                   mutex;           /**< Mutex for thread-safe access to the queue. */
+				std::condition_variable                      cv;              /**< Wakes the applier when the queue fills. */
+				std::thread                                  thread;          /**< The applier thread. */
+				std::shared_ptr<const MoHRS::RegionSnapshot> snapshot;        /**< Latest snapshot of the region, only accessed with std::atomic_load and std::atomic_store. */
+				uint64_t                                     num_players = 0; /**< Players in the region, kept up to date by the applier. */
+			};
+
+			std::array<std::unique_ptr<Shard>, MoHRS::NUM_REGIONS> _shards; /**< One shard per region. */
+
+			std::unordered_map<std::string, MoHRS::Regions> _routes;       /**< Theater session to the region of its game. */
+			std::mutex                                      _routes_mutex; /**< Mutex for thread-safe access to the routes. */
+
+			std::atomic<int>      _next_id{1};          /**< Id of the next game, shared by all shards. */
+			std::atomic<uint64_t> _num_batches{0};      /**< Batches applied. */
+			std::atomic<uint64_t> _num_writes{0};       /**< Writes applied. */
+			std::atomic<uint64_t> _num_updates{0};      /**< Game updates of existing games. */
+			std::atomic<uint64_t> _num_noop_updates{0}; /**< Game updates that did not change the game. */
+			std::atomic<uint64_t> _num_rejected{0};     /**< Creates and updates with a value longer than its field. */
 
 		public:
+			/**
+			 * @brief Constructor for the Matchmaker class, starts the applier thread of every shard.
+			 */
 			Matchmaker();
 			~Matchmaker();
 
-			Games GetGames() const { return this->_games; }
+			/**
+			 * @brief Gets a copy of all games.
+			 * @return The games.
+			 */
+			Games GetGames() const;
 
 			/**
 			 * @brief Creates a new game.
+			 * @details A game that the client created before is replaced, also when it is in another region.
+			 * The game is created by the applier, on_created is called with the game and its new id once the
+			 * batch is committed.
 			 * @param client The client associated with the game creation.
 			 * @param parameter The parameters for creating the game.
-			 * @param game[out] Reference to the created game.
-			 * @return True if the game was created successfully, false otherwise.
+			 * @param on_created Called on the applier thread with the created game.
+			 * @return True if the game was queued, false if the parameters are incomplete or a name is too long.
 			 */
-			bool createGame(const Theater::Client& client, const Theater::Parameter& parameter, MoHRS::Game& game);
+			bool createGame(const Theater::Client& client, const Theater::ParameterView& parameter, CreateCallback on_created);
 
 			/**
 			 * @brief Updates an existing game.
+			 * @details Only fields that differ from the stored game are written. An update that changes
+			 * nothing keeps the current snapshot, so the list cache and the region totals stay valid.
+			 * The update is applied by the applier, an update without a game or with a player name or
+			 * ticket that is too long is dropped.
 			 * @param client The client associated with the game update.
 			 * @param parameter The parameters for updating the game.
-			 * @return True if the game was updated successfully, false otherwise.
 			 */
-			bool updateGame(const Theater::Client& client, const Theater::Parameter& parameter);
+			void updateGame(const Theater::Client& client, const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Removes a game.
+			 * @details The game is removed by the applier, removing a game that does not exist does nothing.
 			 * @param address The address of the game to be removed.
-			 * @return True if the game was removed successfully, false otherwise.
 			 */
-			bool removeGame(const std::string& address);
+			void removeGame(const std::string& address);
+
+			/**
+			 * @brief Gets the latest snapshot of a region.
+			 * @details Only locks for the copy of the pointer, never while a batch is applied.
+			 * @param region The region.
+			 * @return The snapshot, never empty.
+			 */
+			std::shared_ptr<const MoHRS::RegionSnapshot> GetSnapshot(MoHRS::Regions region) const;
+
+			uint64_t GetNumBatches() const     { return this->_num_batches.load(std::memory_order_relaxed);      }
+			uint64_t GetNumWrites() const      { return this->_num_writes.load(std::memory_order_relaxed);       }
+			uint64_t GetNumUpdates() const     { return this->_num_updates.load(std::memory_order_relaxed);      }
+			uint64_t GetNumNoopUpdates() const { return this->_num_noop_updates.load(std::memory_order_relaxed); }
+			uint64_t GetNumRejected() const    { return this->_num_rejected.load(std::memory_order_relaxed);     }
+
+		private:
+			/**
+			 * @brief Apply the queued writes of a shard in batches, runs on the applier thread of the shard.
+			 * @param shard The shard.
+			 */
+			void _runShard(Shard* shard);
 
 			/**
-			 * @brief Finds games by region.
-			 * @param region The region to search for games.
-			 * @param games[out] Reference to the vector to store found games.
-			 * @return True if games were found, false otherwise.
+			 * @brief Queue a write for the applier of a shard.
+			 * @param region The region of the shard.
+			 * @param write The write.
 			 */
-			bool findGamesByRegion(MoHRS::Regions region, MoHRS::Games& games) const;
-			
+			void _pushWrite(MoHRS::Regions region, Write&& write);
+
 			/**
-			 * @brief Finds favorite games and players by a single game.
-			 * @param parameter The parameters associated with the search.
-			 * @param game The game to search for favorites.
-			 * @param num_fav_game[out] Number of favorite games found.
-			 * @param num_fav_players[out] Number of favorite players found.
-			 * @return True if favorites were found, false otherwise.
+			 * @brief Count and log a request with a value that does not fit its field.
+			 * @param client The client that sent the request.
+			 * @param action The action of the request.
 			 */
-			bool findFavoritesByGame(const Theater::Parameter& parameter, const MoHRS::Game& game, int& num_fav_game, int& num_fav_players) const;
+			void _reject(const Theater::Client& client, const std::string& action);
 
 			/**
-			 * @brief Finds favorite games and players by multiple games.
-			 * @param parameter The parameters associated with the search.
-			 * @param games The games to search for favorites.
-			 * @param num_fav_game[out] Number of favorite games found.
-			 * @param num_fav_players[out] Number of favorite players found.
-			 * @return True if favorites were found, false otherwise.
+			 * @brief Apply a batch of writes and publish the region if it changed.
+			 * @param shard The shard.
+			 * @param batch The writes, in the order they were queued.
 			 */
-			bool findFavoritesByGames(const Theater::Parameter& parameter, const MoHRS::Games& games, int& num_fav_game, int& num_fav_players) const;
+			void _applyBatch(Shard& shard, std::vector<Write>& batch);
 
-		private:
 			/**
-			 * @brief Checks if a game is a favorite.
-			 * @param game The game to check.
-			 * @param fav_games The list of favorite games.
-			 * @param num_fav_games[out] Number of favorite games found.
+			 * @brief Apply a single write to the game store of a shard.
+			 * @param shard The shard.
+			 * @param write The write.
+			 * @param events[out] Events to publish after the batch.
+			 * @return True if the games of the shard changed, false otherwise.
 			 */
-			void _checkFavoriteGame(const MoHRS::Game& game, const std::vector<std::string>& fav_games, int& num_fav_games) const;
+			bool _applyWrite(Shard& shard, Write& write, std::vector<MoHRS::Event>& events);
 
 			/**
-			 * @brief Checks if players in a game are favorites.
-			 * @param game The game to check.
-			 * @param fav_players The list of favorite players.
-			 * @param num_fav_players[out] Number of favorite players found.
+			 * @brief Publishes a new snapshot of the region of a shard.
+			 * @param shard The shard.
+			 * @details Only called by the applier of the shard.
 			 */
-			void _checkFavoritePlayers(const MoHRS::Game& game, const std::vector<std::string>& fav_players, int& num_fav_players) const;
+			void _publishSnapshot(Shard& shard);
 	};
 }
 
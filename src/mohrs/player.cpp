@@ -12,15 +12,13 @@ MoHRS::Player::~Player()
 	
 }
 
-bool MoHRS::Player::SetName(const std::string& name)
+bool MoHRS::Player::SetName(std::string_view name)
 {
-    this->_name = Util::removeQuote(name);
-	return true;
+    return this->_name.Assign(Util::removeQuote(name));
 }
 
-bool MoHRS::Player::SetTicket(const std::string& ticket)
+bool MoHRS::Player::SetTicket(std::string_view ticket)
 {
-    this->_ticket = Util::removeQuote(ticket);
-	return true;
+    return this->_ticket.Assign(Util::removeQuote(ticket));
 }
 
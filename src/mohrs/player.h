@@ -1,17 +1,27 @@
 #ifndef MOHRS_PLAYER_H
 #define MOHRS_PLAYER_H
 
-#include <vector>
-#include <string>
+#include <string_view>
+#include <mohrs/fixed_string.h>
 
 /**
     Medal of Honor - Rising Sun
 */
 namespace MoHRS 
 {
-	class Player;
+	/**
+	 * @brief Maximum length of a player name.
+	 * @details The Theater protocol sets no limit, this server chose it to store names inline.
+	 * A CGAM or UGAM with a longer name is rejected.
+	 */
+	const size_t MAX_PLAYER_NAME = 32;
 
-	typedef std::vector<Player> Players;
+	/**
+	 * @brief Maximum length of a ticket.
+	 * @details Chosen by this server, the tickets it hands out in USER are 4 digits.
+	 * A UGAM with a longer ticket is rejected.
+	 */
+	const size_t MAX_TICKET = 32;
 
 	/**
      * @brief Represents a player in the game.
@@ -19,18 +29,20 @@ namespace MoHRS
 	class Player
 	{
 		private:
-			std::string _name;    /**< The name of the player. */
-			std::string _ticket;  /**< The ticket associated with the player. */
+			MoHRS::FixedString<MAX_PLAYER_NAME> _name;    /**< The name of the player. */
+			MoHRS::FixedString<MAX_TICKET>      _ticket;  /**< The ticket associated with the player. */
 
 		public:
 			Player();
 			~Player();
 
-			std::string GetName() const   { return this->_name;   }
-			std::string GetTicket() const { return this->_ticket; }
+			std::string_view GetName() const   { return this->_name.View();   }
+			std::string_view GetTicket() const { return this->_ticket.View(); }
+
+			bool SetName(std::string_view name);
+			bool SetTicket(std::string_view ticket);
 
-			bool SetName(const std::string& name);
-			bool SetTicket(const std::string& ticket);
+			bool operator==(const Player& other) const { return this->GetName() == other.GetName() && this->GetTicket() == other.GetTicket(); }
 	};
 }
 
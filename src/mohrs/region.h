@@ -30,6 +30,21 @@ namespace MoHRS
 	 * @details This map associates each region enum value with its corresponding string name.
 	 */
 	extern std::map<Regions, std::string> RegionNames;
+
+	/**
+	 * @brief Number of regions, Unknown included.
+	 */
+	const size_t NUM_REGIONS = 9;
+
+	/**
+	 * @brief Get the index of a region in a per-region array.
+	 * @param region The region.
+	 * @return 0 for Unknown, otherwise the region code.
+	 */
+	constexpr size_t GetRegionIndex(Regions region)
+	{
+		return (region == Regions::Unknown) ? 0 : static_cast<size_t>(region);
+	}
 }
 
 #endif // MOHRS_REGION_H
@@ -0,0 +1,119 @@
+#include <sys/epoll.h>
+#include <errno.h>
+
+#include <logger.h>
+#include <net/socket.h>
+
+#include <net/event_loop.h>
+
+Net::EventLoop::EventLoop(size_t num_threads) : _next_loop(0)
+{
+	if(num_threads == 0)
+	{
+		num_threads = 1;
+	}
+
+	for(size_t i = 0; i < num_threads; i++)
+	{
+		std::unique_ptr<Loop> loop = std::make_unique<Loop>();
+
+		if((loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+		{
+			Logger::error("Net::EventLoop::EventLoop() at epoll_create1");
+			exit(EXIT_FAILURE);
+		}
+
+		loop->thread = std::thread(&Net::EventLoop::_Run, this, loop.get());
+		loop->thread.detach();
+
+		this->_loops.push_back(std::move(loop));
+	}
+}
+
+bool Net::EventLoop::Add(const std::shared_ptr<Net::Socket>& socket)
+{
+	Loop* loop = this->_loops[this->_next_loop++ % this->_loops.size()].get();
+
+	// Register before arming epoll so the first event always finds the socket
+	{
+		std::lock_guard<std::mutex> guard(loop->mutex); // loop lock
+
+		loop->sockets.insert({ socket.get(), socket });
+	}
+
+	struct epoll_event event = {};
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.ptr = socket.get();
+
+	if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, socket->GetSocket(), &event) < 0)
+	{
+		std::lock_guard<std::mutex> guard(loop->mutex); // loop lock
+
+		loop->sockets.erase(socket.get());
+
+		return false;
+	}
+
+	return true;
+}
+
+void Net::EventLoop::_Run(Loop* loop)
+{
+	std::vector<struct epoll_event> events(64);
+
+	while(true)
+	{
+		int num_events = epoll_wait(loop->epoll_fd, &(events[0]), events.size(), -1);
+
+		if(num_events < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			Logger::error("Net::EventLoop::_Run() at epoll_wait");
+			return;
+		}
+
+		for(int i = 0; i < num_events; i++)
+		{
+			std::shared_ptr<Net::Socket> socket;
+
+			{
+				std::lock_guard<std::mutex> guard(loop->mutex); // loop lock
+
+				auto it = loop->sockets.find(static_cast<Net::Socket*>(events[i].data.ptr));
+				if(it == loop->sockets.end())
+				{
+					continue;
+				}
+
+				socket = it->second;
+			}
+
+			bool keep = true;
+			
+			// Flush queued data the socket did not accept before
+			if(events[i].events & EPOLLOUT)
+			{
+				keep = socket->onWritable();
+			}
+			
+			// Read until the socket is drained or the connection is gone
+			if(keep && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+			{
+				keep = socket->onReadable();
+			}
+			
+			if(!keep)
+			{
+				socket->Disconnect();
+
+				std::lock_guard<std::mutex> guard(loop->mutex); // loop lock
+
+				loop->sockets.erase(socket.get());
+			}
+		}
+	}
+}
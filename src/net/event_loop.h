@@ -0,0 +1,66 @@
+#ifndef NET_EVENT_LOOP_H
+#define NET_EVENT_LOOP_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+
+namespace Net
+{
+	class Socket;
+
+	/**
+	 * @brief Edge-triggered epoll reactor that drives client sockets from readiness events.
+	 *
+	 * The event loop runs a small fixed set of threads, each with its own epoll instance.
+	 * New sockets are spread round-robin over the threads and stay on the same thread
+	 * for their whole lifetime, so a client is never driven by two threads at once.
+	 * Writable events flush the send queue of a socket that could not take all its data before.
+	 */
+	class EventLoop
+	{
+		private:
+			/**
+			 * @brief A single loop thread with its epoll instance and the sockets it drives.
+			 */
+			struct Loop
+			{
+				int                                                            epoll_fd = -1; /**< The epoll file descriptor. */
+				std::thread                                                    thread;        /**< The thread running the loop. */
+				std::unordered_map<Net::Socket*, std::shared_ptr<Net::Socket>> sockets;       /**< Sockets registered on this loop. */
+				std::mutex                                                     mutex;         /**< Mutex for thread-safe access to the sockets. */
+			};
+
+			std::vector<std::unique_ptr<Loop>> _loops;     /**< The loop threads. */
+			std::atomic<size_t>                _next_loop; /**< Round-robin index for the next socket. */
+
+		public:
+			/**
+			 * @brief Constructor for the EventLoop class.
+			 *
+			 * @param num_threads The number of loop threads to start.
+			 */
+			EventLoop(size_t num_threads);
+
+			/**
+			 * @brief Register a non-blocking socket on one of the loop threads.
+			 *
+			 * @param socket The socket to drive from readiness events.
+			 * @return True if the socket was registered, false otherwise.
+			 */
+			bool Add(const std::shared_ptr<Net::Socket>& socket);
+
+		private:
+			/**
+			 * @brief Wait for readiness events and dispatch them to the sockets.
+			 *
+			 * @param loop The loop to run.
+			 */
+			void _Run(Loop* loop);
+	};
+}
+
+#endif // NET_EVENT_LOOP_H
@@ -1,11 +1,13 @@
 #include <vector>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <net/socket.h>
 #include <logger.h>
+#include <util.h>
 
-Net::Socket::Socket()
+Net::Socket::Socket() : _recieved_time(0)
 {
 	
 }
@@ -22,6 +24,21 @@ void Net::Socket::Close()
 	}
 }
 
+void Net::Socket::Shutdown()
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+
+	if(this->_socket != -1)
+	{
+		shutdown(this->_socket, SHUT_RDWR);
+	}
+}
+
+int Net::Socket::GetSocket() const
+{
+	return this->_socket;
+}
+
 std::string Net::Socket::GetIP() const
 {
 	char ip[INET_ADDRSTRLEN];
@@ -72,23 +89,109 @@ std::string Net::Socket::GetSocketType() const
 
 std::chrono::system_clock::time_point Net::Socket::GetLastRecievedTime() const
 {
-	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	int64_t idle = Util::Time::GetMonotonicSeconds() - this->_recieved_time;
+
+	return std::chrono::system_clock::now() - std::chrono::seconds(idle);
+}
 
+int64_t Net::Socket::GetLastRecievedSeconds() const
+{
 	return this->_recieved_time;
 }
 
 void Net::Socket::Send(const std::string& msg) const
+{
+	this->Send(msg.c_str(), msg.size());
+}
+
+void Net::Socket::Send(const std::vector<unsigned char>& msg) const
+{
+	this->Send(msg.data(), msg.size());
+}
+
+void Net::Socket::Send(const void* data, size_t size) const
 {
 	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
 	
-	ssize_t size = send(this->_socket, msg.c_str(), msg.size(), 0);
+	if(this->_send_failed)
+	{
+		return;
+	}
+	
+	// Slow consumer, stop queueing and drop the client
+	if(this->_send_buffer.size() + size > this->_send_queue_limit)
+	{
+		this->_Drop("exceeded the send queue limit of " + std::to_string(this->_send_queue_limit) + " bytes");
+		return;
+	}
+	
+	const unsigned char* ptr = static_cast<const unsigned char*>(data);
+	
+	this->_send_buffer.insert(this->_send_buffer.end(), ptr, ptr + size);
+	
+	if(this->_batch_depth == 0)
+	{
+		this->_Flush();
+	}
 }
 
-void Net::Socket::Send(const std::vector<unsigned char>& msg) const
+void Net::Socket::BeginBatch() const
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	
+	this->_batch_depth++;
+}
+
+void Net::Socket::EndBatch() const
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	
+	if(this->_batch_depth > 0 && --this->_batch_depth == 0)
+	{
+		this->_Flush();
+	}
+}
+
+void Net::Socket::SetSendQueueLimit(size_t limit)
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	
+	this->_send_queue_limit = limit;
+}
+
+size_t Net::Socket::GetSendQueueSize() const
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	
+	return this->_send_buffer.size();
+}
+
+bool Net::Socket::CloseWhenSent()
 {
 	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
 	
-	ssize_t size = send(this->_socket, &(msg[0]), msg.size(), 0);
+	this->_close_when_sent = true;
+	
+	return !this->_send_failed && this->_send_buffer.size() > 0;
+}
+
+bool Net::Socket::onWritable()
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	
+	this->_Flush();
+	
+	if(this->_send_failed)
+	{
+		return false;
+	}
+	
+	return !(this->_close_when_sent && this->_send_buffer.empty());
+}
+
+uint64_t Net::Socket::GetSendCalls() const
+{
+	return this->_send_calls;
 }
 
 void Net::Socket::UDPSend(const std::string& msg) const
@@ -111,8 +214,58 @@ void Net::Socket::UDPSend(const std::vector<unsigned char>& msg) const
 
 void Net::Socket::UpdateLastRecievedTime()
 {
-	std::lock_guard<std::mutex> guard(this->_mutex); // socket lock
+	this->_recieved_time = Util::Time::GetMonotonicSeconds();
+}
+
+// Private functions
 
-	this->_recieved_time = std::chrono::system_clock::now();
+void Net::Socket::_Flush() const
+{
+	size_t offset = 0;
+	
+	while(offset < this->_send_buffer.size() && this->_socket != -1)
+	{
+		ssize_t sent = send(this->_socket, &(this->_send_buffer[offset]), this->_send_buffer.size() - offset, MSG_NOSIGNAL);
+		
+		this->_send_calls++;
+		
+		if(sent < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			
+			// Socket buffer is full, the event loop flushes the rest when it is writable again
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				break;
+			}
+			
+			// Connection is gone
+			this->_Drop("");
+			return;
+		}
+		
+		offset += sent;
+	}
+	
+	this->_send_buffer.erase(this->_send_buffer.begin(), this->_send_buffer.begin() + offset);
 }
 
+void Net::Socket::_Drop(const std::string& reason) const
+{
+	if(!reason.empty())
+	{
+		Logger::warning("Client " + this->GetAddress() + " " + reason + ", disconnecting.");
+	}
+	
+	this->_send_failed = true;
+	this->_send_buffer.clear();
+	
+	// The event loop sees the hang-up and disconnects the client
+	if(this->_socket != -1)
+	{
+		shutdown(this->_socket, SHUT_RDWR);
+	}
+}
@@ -5,6 +5,8 @@
 #include <mutex>
 #include <netinet/in.h>
 #include <chrono>
+#include <vector>
+#include <atomic>
 
 namespace Net
 {
@@ -16,8 +18,17 @@ namespace Net
 		protected:
 			int                                   _socket;        /**< The socket file descriptor. */
 			struct sockaddr_in                    _address;       /**< The socket address information. */
-			std::chrono::system_clock::time_point _recieved_time; /**< Time when data was last received. */
+			std::atomic<int64_t>                  _recieved_time; /**< Monotonic second when data was last received. */
 			mutable std::mutex                    _mutex;         /**< Mutex for thread safety. */
+			uint64_t                              _handle = 0;    /**< Handle of the socket in the client table of its server. */
+
+		private:
+			mutable std::vector<unsigned char>    _send_buffer;                   /**< Outbound data not written to the socket yet. */
+			size_t                                _send_queue_limit = 256 * 1024; /**< Maximum number of queued bytes before the client is dropped. */
+			mutable int                           _batch_depth = 0;               /**< Number of open batches. */
+			mutable bool                          _send_failed = false;           /**< The connection broke or the queue overflowed. */
+			bool                                  _close_when_sent = false;       /**< Close the connection once the queue is empty. */
+			mutable std::atomic<uint64_t>         _send_calls{0};                 /**< Number of send syscalls done on the socket. */
 
 		public:
 			Socket();
@@ -26,7 +37,32 @@ namespace Net
 			 * @brief Closes the socket.
 			 */
 			void Close();
+
+			/**
+			 * @brief Shuts down both directions of the socket without closing it.
+			 *
+			 * The event loop that drives the socket will see the hang-up and disconnect the client.
+			 */
+			void Shutdown();
+
+			/**
+			 * @brief Gets the socket file descriptor.
+			 * @return The socket file descriptor.
+			 */
+			int GetSocket() const;
 			
+			/**
+			 * @brief Gets the handle of the socket in the client table of its server.
+			 * @return The handle.
+			 */
+			uint64_t GetHandle() const { return this->_handle; }
+
+			/**
+			 * @brief Sets the handle of the socket in the client table of its server.
+			 * @param handle The handle.
+			 */
+			void SetHandle(uint64_t handle) { this->_handle = handle; }
+
 			/**
 			 * @brief Gets the IP address associated with the socket.
 			 * @return The IP address as a string.
@@ -63,6 +99,12 @@ namespace Net
 			 */
 			std::chrono::system_clock::time_point GetLastRecievedTime() const;
 
+			/**
+			 * @brief Gets the monotonic second when the socket last received data.
+			 * @return The last received time in seconds of the coarse monotonic clock.
+			 */
+			int64_t GetLastRecievedSeconds() const;
+
 			/**
 			 * @brief Sends a message over the socket.
 			 * @param msg The message to send as a string.
@@ -75,6 +117,50 @@ namespace Net
 			 */
 			void Send(const std::vector<unsigned char>& msg) const;
 			
+			/**
+			 * @brief Sends a message over the socket.
+			 * @param data The message to send.
+			 * @param size The size of the message in bytes.
+			 */
+			void Send(const void* data, size_t size) const;
+
+			/**
+			 * @brief Starts gathering sent messages instead of writing them one by one.
+			 * @details Batches can be nested, the gathered data is written with a single
+			 * send when the outer batch ends.
+			 */
+			void BeginBatch() const;
+
+			/**
+			 * @brief Ends a batch and writes the gathered messages when it was the outer batch.
+			 */
+			void EndBatch() const;
+
+			/**
+			 * @brief Sets the maximum number of bytes that may wait in the send queue.
+			 * @param limit The limit in bytes.
+			 * @details A client that goes over the limit is too slow to keep up and gets disconnected.
+			 */
+			void SetSendQueueLimit(size_t limit);
+
+			/**
+			 * @brief Gets the number of bytes waiting in the send queue.
+			 * @return The number of queued bytes.
+			 */
+			size_t GetSendQueueSize() const;
+
+			/**
+			 * @brief Close the connection as soon as all queued data is written.
+			 * @return True if data is still queued, false if the connection can be closed right away.
+			 */
+			bool CloseWhenSent();
+
+			/**
+			 * @brief Gets the number of send syscalls done on the socket.
+			 * @return The number of send syscalls.
+			 */
+			uint64_t GetSendCalls() const;
+
 			/**
 			 * @brief Sends a UDP message over the socket.
 			 * @param msg The message to send as a string.
@@ -88,10 +174,30 @@ namespace Net
 			void UDPSend(const std::vector<unsigned char>& msg) const;
 			
 			/**
-			 * @brief Updates the last received time to the current system time.
+			 * @brief Updates the last received time to the current monotonic time.
+			 * @details Lock free, called for every read.
 			 */
 			void UpdateLastRecievedTime();
 
+			/**
+			 * @brief Called by the event loop when the socket is readable.
+			 * @return False when the connection must be closed, true otherwise.
+			 * @details Sockets are edge-triggered, so the socket must be read until it would block.
+			 */
+			virtual bool onReadable() { return false; }
+
+			/**
+			 * @brief Called by the event loop when the socket accepts data again.
+			 * @return False when the connection must be closed, true otherwise.
+			 * @details Writes as much of the send queue as the socket accepts.
+			 */
+			bool onWritable();
+
+			/**
+			 * @brief Disconnect the client.
+			 */
+			virtual void Disconnect() { this->Close(); }
+
 			/**
 			 * @brief Empty virtual function required for static_cast in C++.
 			 *
@@ -100,6 +206,21 @@ namespace Net
 			 * least one virtual function). This is because static_cast requires a polymorphic base class for a safe cast.
 			 */
 			virtual void WTF_WHY_AM_I_HERE_1337() { /* Empty virtual function */ }
+
+		private:
+			/**
+			 * @brief Writes as much of the send queue as the socket accepts without blocking.
+			 * @details Unsent data stays queued till the socket is writable again.
+			 * Must be called with the socket lock held.
+			 */
+			void _Flush() const;
+
+			/**
+			 * @brief Stops sending and hangs up the connection.
+			 * @param reason Why the connection is dropped, logged when not empty.
+			 * @details Must be called with the socket lock held.
+			 */
+			void _Drop(const std::string& reason) const;
 	};
 }
 
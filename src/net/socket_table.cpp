@@ -0,0 +1,71 @@
+#include <net/socket_table.h>
+
+Net::SocketTable::Handle Net::SocketTable::Insert(const std::shared_ptr<Net::Socket>& socket)
+{
+	uint32_t index;
+
+	if(this->_free_head != NO_SLOT)
+	{
+		// Reuse a free slot
+		index = this->_free_head;
+		this->_free_head = this->_slots[index].next_free;
+	}
+	else
+	{
+		index = this->_slots.size();
+		this->_slots.emplace_back();
+	}
+
+	Slot& slot = this->_slots[index];
+	slot.socket = socket;
+	this->_size++;
+
+	return (static_cast<Handle>(slot.generation) << 32) | index;
+}
+
+std::shared_ptr<Net::Socket> Net::SocketTable::Find(Handle handle) const
+{
+	uint32_t index = handle & 0xFFFFFFFF;
+	uint32_t generation = handle >> 32;
+
+	if(index >= this->_slots.size() || this->_slots[index].generation != generation)
+	{
+		return nullptr;
+	}
+
+	return this->_slots[index].socket;
+}
+
+std::shared_ptr<Net::Socket> Net::SocketTable::Remove(Handle handle)
+{
+	uint32_t index = handle & 0xFFFFFFFF;
+	uint32_t generation = handle >> 32;
+
+	if(index >= this->_slots.size())
+	{
+		return nullptr;
+	}
+
+	Slot& slot = this->_slots[index];
+
+	// Stale handle, the slot was freed or reused
+	if(slot.generation != generation || !slot.socket)
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<Net::Socket> socket = std::move(slot.socket);
+	slot.socket.reset();
+
+	// Generation 0 would make INVALID_HANDLE valid
+	if(++slot.generation == 0)
+	{
+		slot.generation = 1;
+	}
+
+	slot.next_free = this->_free_head;
+	this->_free_head = index;
+	this->_size--;
+
+	return socket;
+}
@@ -0,0 +1,101 @@
+#ifndef NET_SOCKET_TABLE_H
+#define NET_SOCKET_TABLE_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace Net
+{
+	class Socket;
+
+	/**
+	 * @brief Slab of sockets addressed by generation-checked handles.
+	 *
+	 * Inserting and removing a socket are O(1): removed slots go on a free list and are reused.
+	 * Every reuse bumps the generation of the slot, so a handle of a removed socket never matches
+	 * the socket that took its place. The table is not thread-safe, the owner must lock it.
+	 */
+	class SocketTable
+	{
+		public:
+			/**
+			 * @brief Handle of a socket in the table. The generation is in the upper 32 bits and the slot index in the lower 32 bits.
+			 */
+			typedef uint64_t Handle;
+
+			/**
+			 * @brief Handle that never refers to a socket.
+			 */
+			static constexpr Handle INVALID_HANDLE = 0;
+
+		private:
+			/**
+			 * @brief A slot that holds a socket or is on the free list.
+			 */
+			struct Slot
+			{
+				std::shared_ptr<Net::Socket> socket;         /**< The socket, empty when the slot is free. */
+				uint32_t                     generation = 1; /**< Bumped every time the slot is freed. */
+				uint32_t                     next_free;      /**< Next slot on the free list. */
+			};
+
+			static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+			std::vector<Slot> _slots;               /**< The slots. */
+			uint32_t          _free_head = NO_SLOT; /**< First free slot. */
+			size_t            _size = 0;            /**< Number of sockets in the table. */
+
+		public:
+			/**
+			 * @brief Insert a socket.
+			 *
+			 * @param socket The socket to insert.
+			 * @return The handle of the socket.
+			 */
+			Handle Insert(const std::shared_ptr<Net::Socket>& socket);
+
+			/**
+			 * @brief Remove a socket.
+			 *
+			 * @param handle The handle of the socket.
+			 * @return The removed socket, empty when the handle is stale.
+			 * @details The socket is returned so the caller can release it after unlocking.
+			 */
+			std::shared_ptr<Net::Socket> Remove(Handle handle);
+
+			/**
+			 * @brief Find a socket.
+			 *
+			 * @param handle The handle of the socket.
+			 * @return The socket, empty when the handle is stale.
+			 */
+			std::shared_ptr<Net::Socket> Find(Handle handle) const;
+
+			/**
+			 * @brief Get the number of sockets in the table.
+			 *
+			 * @return The number of sockets.
+			 */
+			size_t Size() const { return this->_size; }
+
+			/**
+			 * @brief Visit every socket in the table.
+			 *
+			 * @param func Called with a reference to the shared pointer of each socket.
+			 */
+			template<typename Func>
+			void ForEach(Func&& func) const
+			{
+				for(const Slot& slot : this->_slots)
+				{
+					if(slot.socket)
+					{
+						func(slot.socket);
+					}
+				}
+			}
+	};
+}
+
+#endif // NET_SOCKET_TABLE_H
@@ -0,0 +1,102 @@
+#include <thread>
+
+#include <logger.h>
+#include <util.h>
+#include <net/socket.h>
+
+#include <net/timer_wheel.h>
+
+Net::TimerWheel::TimerWheel(size_t num_slots) : _slots(num_slots > 0 ? num_slots : 1)
+{
+	this->_current = Util::Time::GetMonotonicSeconds();
+}
+
+void Net::TimerWheel::Add(const std::shared_ptr<Net::Socket>& socket, int64_t time_out)
+{
+	int64_t deadline = socket->GetLastRecievedSeconds() + time_out;
+
+	std::lock_guard<std::mutex> guard(this->_mutex); // timer wheel lock
+
+	// Never schedule in a slot that was already processed
+	if(deadline <= this->_current)
+	{
+		deadline = this->_current + 1;
+	}
+
+	this->_slots[deadline % this->_slots.size()].push_back({ socket, time_out, deadline });
+}
+
+void Net::TimerWheel::Run()
+{
+	Logger::info("Timer wheel started");
+
+	while(true)
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+
+		int64_t now = Util::Time::GetMonotonicSeconds();
+
+		// Catch up on every second that passed
+		while(this->_current < now)
+		{
+			this->_Tick(this->_current + 1);
+		}
+	}
+}
+
+void Net::TimerWheel::_Tick(int64_t now)
+{
+	std::vector<Entry> entries;
+	std::vector<std::shared_ptr<Net::Socket>> expired;
+
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // timer wheel lock
+
+		this->_current = now;
+
+		std::vector<Entry>& slot = this->_slots[now % this->_slots.size()];
+
+		for(Entry& entry : slot)
+		{
+			// Belongs to a later round of the wheel
+			if(entry.deadline > now)
+			{
+				entries.push_back(std::move(entry));
+				continue;
+			}
+
+			std::shared_ptr<Net::Socket> socket = entry.socket.lock();
+
+			// Connection is already gone
+			if(!socket)
+			{
+				continue;
+			}
+
+			entry.deadline = socket->GetLastRecievedSeconds() + entry.time_out;
+
+			if(entry.deadline <= now)
+			{
+				expired.push_back(socket);
+			}
+			else
+			{
+				entries.push_back(std::move(entry));
+			}
+		}
+
+		slot.clear();
+
+		// Move the rescheduled connections to the slot of their new deadline
+		for(Entry& entry : entries)
+		{
+			this->_slots[entry.deadline % this->_slots.size()].push_back(std::move(entry));
+		}
+	}
+
+	// The event loop sees the hang-up and disconnects the client
+	for(std::shared_ptr<Net::Socket>& socket : expired)
+	{
+		socket->Shutdown();
+	}
+}
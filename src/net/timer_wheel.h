@@ -0,0 +1,67 @@
+#ifndef NET_TIMER_WHEEL_H
+#define NET_TIMER_WHEEL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace Net
+{
+	class Socket;
+
+	/**
+	 * @brief Hashed timer wheel that expires idle connections.
+	 *
+	 * Every connection sits in the slot of the second its deadline falls in. Reading data only
+	 * stores a new timestamp in the socket, the wheel looks at it when the slot comes around and
+	 * either hangs up the connection or moves it to the slot of its new deadline.
+	 */
+	class TimerWheel
+	{
+		private:
+			/**
+			 * @brief A connection waiting for its deadline.
+			 */
+			struct Entry
+			{
+				std::weak_ptr<Net::Socket> socket;    /**< The watched connection. */
+				int64_t                    time_out;  /**< Seconds of silence before it expires. */
+				int64_t                    deadline;  /**< Monotonic second the connection expires. */
+			};
+
+			std::vector<std::vector<Entry>> _slots;   /**< One slot per second, wrapping around. */
+			int64_t                         _current; /**< The last second that was processed. */
+			std::mutex                      _mutex;   /**< Mutex for thread-safe access to the slots. */
+
+		public:
+			/**
+			 * @brief Constructor for the TimerWheel class.
+			 *
+			 * @param num_slots The number of one second slots in the wheel.
+			 */
+			TimerWheel(size_t num_slots = 64);
+
+			/**
+			 * @brief Start watching a connection.
+			 *
+			 * @param socket The connection to expire.
+			 * @param time_out Seconds without recieved data before the connection is closed.
+			 */
+			void Add(const std::shared_ptr<Net::Socket>& socket, int64_t time_out);
+
+			/**
+			 * @brief Advance the wheel once per second and expire idle connections.
+			 */
+			void Run();
+
+		private:
+			/**
+			 * @brief Expire or reschedule the connections in the slot of a second.
+			 *
+			 * @param now The second to process.
+			 */
+			void _Tick(int64_t now);
+	};
+}
+
+#endif // NET_TIMER_WHEEL_H
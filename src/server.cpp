@@ -3,14 +3,16 @@
 #include <string>
 #include <iostream>
 #include <unistd.h>
-#include <thread>
+#include <errno.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
-#include <algorithm>
  
 #include <logger.h>
 #include <settings.h>
+#include <globals.h>
+#include <net/timer_wheel.h>
+#include <mohrs/event_bus.h>
 #include <theater/client.h>
 #include <webserver/client.h>
 
@@ -18,9 +20,12 @@
 
 Server::Server(Server::Type type)
 {
-	std::shared_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read)
+	const Settings& settings = GetSettings();
 	
 	int port = -1;
+	int threads = 1;
+	int send_queue_limit = 256 * 1024;
+	int connection_time_out = 60;
 	int socket_type = SOCK_STREAM;
 
 	// socket options
@@ -32,13 +37,23 @@ Server::Server(Server::Type type)
 	switch(type)
 	{
 		case Server::Type::Theater:
-			port = g_settings["theater"]["port"].asInt();
+			port = settings.theater.port;
+			threads = settings.theater.threads;
+			send_queue_limit = settings.theater.send_queue_limit;
+			connection_time_out = settings.theater.connection_time_out;
 		break;
 		case Server::Type::Webserver:
-			port = g_settings["webserver"]["port"].asInt();
+			port = settings.webserver.port;
+			threads = settings.webserver.threads;
+			send_queue_limit = settings.webserver.send_queue_limit;
+			connection_time_out = settings.webserver.connection_time_out;
 		break;
 	}
 	
+	this->_threads = (threads > 0) ? threads : 1;
+	this->_send_queue_limit = (send_queue_limit > 0) ? send_queue_limit : 256 * 1024;
+	this->_connection_time_out = (connection_time_out > 0) ? connection_time_out : 60;
+	
 	if ((this->_socket = socket(AF_INET, socket_type, 0)) < 0)
 	{
 		Logger::error("Server::Server() at socket", this->_type);
@@ -62,77 +77,100 @@ Server::Server(Server::Type type)
 	}
 }
 
-std::vector<std::shared_ptr<Net::Socket>> Server::GetClients()
+std::shared_ptr<Net::Socket> Server::GetClient(Net::SocketTable::Handle handle) const
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // server lock
+	
+	return this->_clients.Find(handle);
+}
+
+size_t Server::GetNumClients() const
 {
 	std::lock_guard<std::mutex> guard(this->_mutex); // server lock
 	
-	return this->_clients;
+	return this->_clients.Size();
 }
 
 void Server::Listen()
 {
 	int client_socket;
 	struct sockaddr_in client_address;
-	socklen_t client_address_len = sizeof(client_address);
+	socklen_t client_address_len;
 	
-	if (listen(this->_socket, 3) < 0)
+	if (listen(this->_socket, SOMAXCONN) < 0)
 	{
 		Logger::error("Server::Listen() on listen", this->_type);
 		return;
 	}
 	
+	this->_event_loop = std::make_unique<Net::EventLoop>(this->_threads);
+	
 	this->onServerListen();
 
 	while(true)
 	{
-		if ((client_socket = accept(this->_socket, (struct sockaddr*)&client_address, &client_address_len)) < 0)
-		{	
+		client_address_len = sizeof(client_address);
+		
+		if ((client_socket = accept4(this->_socket, (struct sockaddr*)&client_address, &client_address_len, SOCK_NONBLOCK)) < 0)
+		{
+			// The client gave up before we could accept it
+			if(errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+			
 			Logger::error("Server::Listen() on accept", this->_type);
 			return;
 		}
 		
+		std::shared_ptr<Net::Socket> client;
+		
 		switch(this->_type)
 		{
 			case Server::Type::Theater:
-			{
-				std::lock_guard<std::mutex> guard(this->_mutex); // server lock
-				
-				this->_clients.push_back(std::make_shared<Theater::Client>(client_socket, client_address));
-				
-				std::shared_ptr<Net::Socket> client = this->_clients.back();
-				
-				this->onClientConnect(client);
-				
-				std::thread t([client]() {
-					static_cast<Theater::Client*>(client.get())->Listen();
-				});
-				t.detach();
-			}
+				client = std::make_shared<Theater::Client>(client_socket, client_address);
 			break;
 
 			case Server::Type::Webserver:
-			{
-				std::lock_guard<std::mutex> guard(this->_mutex); // server lock
-				
-				this->_clients.push_back(std::make_shared<Webserver::Client>(client_socket, client_address));
-				
-				std::shared_ptr<Net::Socket> client = this->_clients.back();
-				
-				this->onClientConnect(client);
-				
-				std::thread t([client]() {
-					static_cast<Webserver::Client*>(client.get())->Listen();
-				});
-				t.detach();
-			}
+				client = std::make_shared<Webserver::Client>(client_socket, client_address);
 			break;
+
+			default:
+				close(client_socket);
+			continue;
+		}
+		
+		client->SetSendQueueLimit(this->_send_queue_limit);
+		
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // server lock
+			
+			client->SetHandle(this->_clients.Insert(client));
 		}
+		
+		this->onClientConnect(client);
+		
+		if(!this->_event_loop->Add(client))
+		{
+			client->Disconnect();
+			continue;
+		}
+		
+		g_timer_wheel->Add(client, this->_connection_time_out);
 	}
 }
 
 void Server::DisconnectAllClients()
 {
-	for(std::shared_ptr<Net::Socket> client : this->_clients)
+	std::vector<std::shared_ptr<Net::Socket>> clients;
+	
+	// Disconnecting removes the client from the table, so collect them first
+	this->ForEachClient([&clients](const std::shared_ptr<Net::Socket>& client)
+	{
+		clients.push_back(client);
+	});
+	
+	for(std::shared_ptr<Net::Socket> client : clients)
 	{
 		switch(this->_type)
 		{
@@ -164,63 +202,41 @@ void Server::onServerShutdown() const
 	Logger::info("Server shutdown", this->_type);
 }
 
-void Server::onClientConnect(const Net::Socket& client) const
-{
-	std::shared_lock<std::shared_mutex> guard2(g_settings_mutex); // settings lock (read)
-	
-	if ((g_logger_mode & Logger::Mode::Development) != 0)
-	{
-		Logger::info("Client " + client.GetAddress() + " connected",
-			this->_type, g_settings["show_client_connect"].asBool());
-	}
-}
-
 void Server::onClientConnect(const std::shared_ptr<Net::Socket>& client) const
 {
-	std::shared_lock<std::shared_mutex> guard2(g_settings_mutex); // settings lock (read)
-	
-	if ((g_logger_mode & Logger::Mode::Development) != 0)
+	LOG_TRANSACTION(this->_type, GetSettings().show_client_connect, "Client ", client->GetAddress(), " connected");
+
+	if(this->_type == Server::Type::Theater)
 	{
-		Logger::info("Client " + client->GetAddress() + " connected",
-			this->_type, g_settings["show_client_connect"].asBool());
+		g_event_bus->Publish(MoHRS::Event::FromClient(MoHRS::Event::Type::ClientConnected, client->GetAddress()));
 	}
 }
 
 void Server::onClientDisconnect(const Net::Socket& client)
 {
-	std::shared_lock<std::shared_mutex> guard2(g_settings_mutex); // settings lock (read)
-	
 	if(this->GetSocketType() == "tcp")
 	{
-		std::lock_guard<std::mutex> guard(this->_mutex); // server lock
+		std::shared_ptr<Net::Socket> removed;
 		
-		// Find shared pointer in clients list
-		auto it = std::find_if(this->_clients.begin(), this->_clients.end(),
-			[rawPtrToSearch = const_cast<Net::Socket*>(&client)](const std::shared_ptr<Net::Socket>& ptr)
-			{
-				return ptr.get() == rawPtrToSearch;
-			}
-		);
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // server lock
+			
+			removed = this->_clients.Remove(client.GetHandle());
+		}
 		
-		// When found remove client
-		if (it != this->_clients.end())
+		// When found the client is removed
+		if (removed)
 		{
-			if ((g_logger_mode & Logger::Mode::Development) != 0)
+			LOG_TRANSACTION(this->_type, GetSettings().show_client_disconnect, "Client ", client.GetAddress(), " disconnected");
+
+			if(this->_type == Server::Type::Theater)
 			{
-				Logger::info("Client " + client.GetAddress() + " disconnected",
-					this->_type, g_settings["show_client_disconnect"].asBool());
+				g_event_bus->Publish(MoHRS::Event::FromClient(MoHRS::Event::Type::ClientDisconnected, client.GetAddress()));
 			}
-
-			this->_clients.erase(it);
 		}
 	}
 	else
 	{
-		if ((g_logger_mode & Logger::Mode::Development) != 0)
-		{
-			Logger::info("Client " + client.GetAddress() + " disconnected",
-				this->_type, g_settings["show_client_disconnect"].asBool());
-		}
+		LOG_TRANSACTION(this->_type, GetSettings().show_client_disconnect, "Client ", client.GetAddress(), " disconnected");
 	}
 }
-
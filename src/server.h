@@ -5,6 +5,8 @@
 #include <memory>
 
 #include <net/socket.h>
+#include <net/event_loop.h>
+#include <net/socket_table.h>
 
 class Server : public Net::Socket
 {
@@ -20,9 +22,13 @@ class Server : public Net::Socket
 		};
 	
 	private:
-		std::vector<std::shared_ptr<Net::Socket>> _clients; /**< Vector of client sockets connected to this server. */
-		Server::Type                              _type;    /**< Type of the server. */
-		mutable std::mutex                        _mutex;   /**< Mutex for thread-safe operations on the server. */
+		Net::SocketTable                          _clients;    /**< Table of client sockets connected to this server. */
+		Server::Type                              _type;       /**< Type of the server. */
+		std::unique_ptr<Net::EventLoop>           _event_loop; /**< Event loop driving the client sockets. */
+		size_t                                    _threads;    /**< Number of event loop threads. */
+		size_t                                    _send_queue_limit;    /**< Maximum bytes queued per client before it is dropped. */
+		int64_t                                   _connection_time_out; /**< Seconds of silence before a client is disconnected. */
+		mutable std::mutex                        _mutex;      /**< Mutex for thread-safe operations on the server. */
 	
 	public:
 		/**
@@ -33,14 +39,39 @@ class Server : public Net::Socket
 		Server(Server::Type type);
 		
 		/**
-		 * @brief Get the vector of client sockets connected to this server.
+		 * @brief Visit every client socket connected to this server.
 		 * 
-		 * @return Vector of client sockets.
+		 * The server lock is held while visiting, so the visitor must not connect or disconnect clients.
+		 * 
+		 * @param func Called with a reference to the shared pointer of each client socket.
+		 */
+		template<typename Func>
+		void ForEachClient(Func&& func) const
+		{
+			std::lock_guard<std::mutex> guard(this->_mutex); // server lock
+			
+			this->_clients.ForEach(func);
+		}
+		
+		/**
+		 * @brief Get a client socket connected to this server.
+		 * 
+		 * @param handle The handle of the client socket.
+		 * @return The client socket, empty when it disconnected.
 		 */
-		std::vector<std::shared_ptr<Net::Socket>> GetClients();
+		std::shared_ptr<Net::Socket> GetClient(Net::SocketTable::Handle handle) const;
+		
+		/**
+		 * @brief Get the number of client sockets connected to this server.
+		 * 
+		 * @return Number of client sockets.
+		 */
+		size_t GetNumClients() const;
 		
 		/**
 		 * @brief Start listening for incoming connections on the server.
+		 *
+		 * Accepted clients are made non-blocking and handed to the event loop.
 		 */
 		void Listen();
 		
@@ -69,13 +100,6 @@ class Server : public Net::Socket
 		 */
 		void onServerShutdown() const;
 		
-		/**
-		 * @brief Called when a client connects to the server.
-		 * 
-		 * @param client The client socket that connected.
-		 */
-		void onClientConnect(const Net::Socket& client) const;
-
 		/**
 		 * @brief Called when a client connects to the server.
 		 * 
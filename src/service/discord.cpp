@@ -3,50 +3,126 @@
 #include <settings.h>
 #include <logger.h>
 
-Service::Discord::Discord() : _bot("")
+Service::Discord::Discord() : _bot(""), _events(*g_event_bus, MoHRS::EventBus::Overflow::DropOldest),
+	_notifier([this](const std::string& message) { this->_SendToChannels(message); },
+	          [this]() { this->_events.Poll([this](const MoHRS::Event& event) { this->_OnEvent(event); }); },
+	          SEND_INTERVAL, RATE_LIMITED_INTERVAL)
 {
-	std::shared_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read)
-
-	this->_bot.token = g_settings["discord"]["token"].asString();
+	this->_bot.token = GetSettings().discord.token;
 
 	this->_bot.on_ready([discord = this](const dpp::ready_t& event)
 	{
-		discord->_guilds = event.guilds;
-		
+		discord->_ResolveChannels(event.guilds);
+
 		discord->Send("MOHRS-Matchmaker server started!");
 	});
 }
 
+Service::Discord::~Discord()
+{
+
+}
+
 void Service::Discord::Start()
 {
+	this->_notifier.Start();
+
 	this->_bot.start(dpp::st_wait);
 }
 
 void Service::Discord::Send(const std::string& msg)
 {
-	for(dpp::snowflake guild_id : this->_guilds)
+	this->_notifier.Send(msg);
+}
+
+// Private functions
+
+void Service::Discord::_ResolveChannels(const std::vector<dpp::snowflake>& guilds)
+{
+	std::string channel_name = GetSettings().discord.channel;
+
 	{
-		this->_bot.channels_get(guild_id, [discord = this, msg](const dpp::confirmation_callback_t& callback)
+		std::lock_guard<std::mutex> guard(this->_mutex); // discord lock
+
+		this->_channels.clear();
+	}
+
+	this->_notifier.SetReady(guilds.empty());
+
+	// Messages wait in the queue till every guild answered
+	std::shared_ptr<std::atomic<size_t>> num_pending = std::make_shared<std::atomic<size_t>>(guilds.size());
+
+	for(dpp::snowflake guild_id : guilds)
+	{
+		this->_bot.channels_get(guild_id, [discord = this, channel_name, num_pending](const dpp::confirmation_callback_t& callback)
 		{
-			if (callback.is_error())
+			std::lock_guard<std::mutex> guard(discord->_mutex); // discord lock
+
+			if (!callback.is_error())
 			{
-				return;
-			}
-			
-			std::shared_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read)
-			
-			dpp::channel_map channels = callback.get<dpp::channel_map>();
-			
-			for (const auto& pair : channels)
-			{			
-				if(pair.second.name == g_settings["discord"]["channel"].asString())
-				{
-					discord->_bot.message_create(dpp::message(pair.first, msg));
+				dpp::channel_map channels = callback.get<dpp::channel_map>();
 
-					Logger::info("<-- " + msg, Service::Type::Discord);
+				for (const auto& pair : channels)
+				{
+					if(pair.second.name == channel_name)
+					{
+						discord->_channels.push_back(pair.first);
+					}
 				}
 			}
+
+			if(num_pending->fetch_sub(1) == 1)
+			{
+				discord->_notifier.SetReady(true);
+			}
+		});
+	}
+}
+
+void Service::Discord::_SendToChannels(const std::string& message)
+{
+	std::vector<dpp::snowflake> channels;
+
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // discord lock
+
+		channels = this->_channels;
+	}
+
+	for(dpp::snowflake channel_id : channels)
+	{
+		this->_bot.message_create(dpp::message(channel_id, message), [discord = this](const dpp::confirmation_callback_t& callback)
+		{
+			// Too many requests
+			if(callback.is_error() && callback.http_info.status == 429)
+			{
+				discord->_notifier.RateLimited();
+
+				Logger::warning("Rate limited, holding messages", Service::Type::Discord);
+			}
 		});
+
+		this->_num_sent.fetch_add(1, std::memory_order_relaxed);
+
+		Logger::info("<-- " + message, Service::Type::Discord);
 	}
 }
 
+void Service::Discord::_OnEvent(const MoHRS::Event& event)
+{
+	switch(event.type)
+	{
+		case MoHRS::Event::Type::GameCreated:
+			this->Send("Player \"" + std::string(event.host_player.View()) + "\" created server called \"" +
+				std::string(event.name.View()) + "\" in region \"" + MoHRS::RegionNames[event.region] + "\"");
+			break;
+
+		case MoHRS::Event::Type::GameRemoved:
+			this->Send("Player \"" + std::string(event.host_player.View()) + "\" closed server called \"" +
+				std::string(event.name.View()) + "\" in region \"" + MoHRS::RegionNames[event.region] + "\"");
+			break;
+
+		default:
+			break;
+	}
+}
@@ -2,53 +2,106 @@
 #define SERVICE_DISCORD_H
 
 #include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 #include <dpp/dpp.h>
 
+#include <mohrs/event_bus.h>
+#include <service/notifier.h>
+
 namespace Service
 {
 	/**
 	 * @brief The Discord class represents a Discord service.
-	 * 
+	 *
 	 * This class provides functionality for interacting with the Discord API.
+	 * Messages are queued and sent by a notifier thread, so callers never wait on Discord.
+	 * The notifier also turns the game events of the event bus into messages.
+	 * Messages that arrive while the notifier waits for the rate limit are sent together as one message.
 	 */
 	class Discord
 	{
 		private:
-			dpp::cluster                _bot;     /**< The Discord bot instance. */
-			std::vector<dpp::snowflake> _guilds;  /**< List of guild snowflake IDs. */
+			/**
+			 * @brief Time between two messages to a channel, Discord allows 5 messages per 5 seconds.
+			 */
+			static constexpr std::chrono::milliseconds SEND_INTERVAL{1200};
+
+			/**
+			 * @brief Time to wait after Discord reported that the rate limit was hit.
+			 */
+			static constexpr std::chrono::seconds RATE_LIMITED_INTERVAL{10};
+
+			dpp::cluster                _bot;           /**< The Discord bot instance. */
+			std::vector<dpp::snowflake> _channels;      /**< Channels to send to, resolved once the bot is ready. */
+			std::mutex                  _mutex;         /**< Mutex for thread-safe access to the channels. */
+
+			MoHRS::EventBus::Subscriber _events;        /**< Game events, only polled by the notifier thread. */
+			Service::Notifier           _notifier;      /**< Joins and paces the messages. */
+
+			std::atomic<uint64_t>       _num_sent{0};   /**< Messages sent to Discord, one per channel. */
 
 		public:
 			/**
 			 * @brief Default constructor for the Discord class.
-			 * 
+			 *
 			 * Initializes a new Discord bot instance.
 			 */
 			Discord();
-			
+
 			/**
 			 * @brief Destructor for the Discord class.
-			 * 
+			 *
 			 * Cleans up any resources associated with the Discord bot instance.
 			 */
 			~Discord();
 
 			/**
 			 * @brief Starts the Discord service.
-			 * 
-			 * This function initializes the Discord bot and connects it to the Discord API.
+			 *
+			 * This function starts the notifier thread, initializes the Discord bot and connects it to the Discord API.
 			 * It must be called before using other functionality of the Discord service.
 			 */
 			void Start();
 
 			/**
 			 * @brief Sends a message through the Discord service.
-			 * 
+			 *
 			 * @param msg The message to be sent.
-			 * 
-			 * This function sends a message to the Discord server using the initialized bot instance.
-			 * The message is sent to the default channel or recipient.
+			 *
+			 * The message is queued and sent by the notifier thread to the configured channel of every guild.
+			 * This function never blocks on Discord, the message is dropped when the queue is full.
 			 */
 			void Send(const std::string& msg);
+
+			uint64_t GetNumSent() const          { return this->_num_sent.load(std::memory_order_relaxed); }
+			uint64_t GetNumCoalesced() const     { return this->_notifier.GetNumCoalesced();               }
+			uint64_t GetNumDropped() const       { return this->_notifier.GetNumDropped();                 }
+			uint64_t GetNumEventsDropped() const { return this->_events.GetNumDropped();                   }
+
+		private:
+			/**
+			 * @brief Look up the configured channel in every guild, once the bot is ready.
+			 *
+			 * @param guilds The guilds of the bot.
+			 */
+			void _ResolveChannels(const std::vector<dpp::snowflake>& guilds);
+
+			/**
+			 * @brief Send a joined message to every channel, runs on the notifier thread.
+			 *
+			 * @param message The message.
+			 */
+			void _SendToChannels(const std::string& message);
+
+			/**
+			 * @brief Queue a message about a game event.
+			 *
+			 * @param event The event.
+			 */
+			void _OnEvent(const MoHRS::Event& event);
 	};
 }
 
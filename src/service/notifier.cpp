@@ -0,0 +1,127 @@
+#include <service/notifier.h>
+
+/**
+ * @brief Nanoseconds of the steady clock, for the rate limit.
+ */
+static int64_t GetSteadyNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Service::Notifier::Notifier(Sender sender, Poller poller, std::chrono::milliseconds send_interval, std::chrono::milliseconds rate_limited_interval) :
+	_sender(std::move(sender)), _poller(std::move(poller)), _send_interval(send_interval), _rate_limited_interval(rate_limited_interval)
+{
+
+}
+
+void Service::Notifier::Start()
+{
+	this->_thread = std::thread(&Service::Notifier::_Run, this);
+	this->_thread.detach();
+}
+
+void Service::Notifier::Send(const std::string& msg)
+{
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // notifier lock
+
+		if(this->_queue.size() >= MAX_QUEUE)
+		{
+			this->_num_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		this->_queue.push_back(msg);
+	}
+
+	this->_cv.notify_one();
+}
+
+void Service::Notifier::SetReady(bool ready)
+{
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // notifier lock
+
+		this->_ready = ready;
+	}
+
+	this->_cv.notify_one();
+}
+
+void Service::Notifier::RateLimited()
+{
+	this->_rate_limited_until.store(GetSteadyNanoseconds() + std::chrono::nanoseconds(this->_rate_limited_interval).count(), std::memory_order_relaxed);
+}
+
+// Private functions
+
+void Service::Notifier::_Run()
+{
+	std::deque<std::string> messages;
+
+	while(true)
+	{
+		if(this->_poller)
+		{
+			this->_poller();
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex); // notifier lock
+
+			if(!this->_cv.wait_for(lock, POLL_INTERVAL, [this, &messages] { return this->_ready && (!messages.empty() || !this->_queue.empty()); }))
+			{
+				continue;
+			}
+
+			// Everything that was queued while waiting is sent together
+			while(!this->_queue.empty() && messages.size() < MAX_QUEUE)
+			{
+				messages.push_back(std::move(this->_queue.front()));
+				this->_queue.pop_front();
+			}
+		}
+
+		// The service told us to slow down
+		int64_t wait = this->_rate_limited_until.load(std::memory_order_relaxed) - GetSteadyNanoseconds();
+
+		if(wait > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+			continue;
+		}
+
+		size_t num_messages = messages.size();
+		std::string message = Service::Notifier::_Coalesce(messages);
+
+		this->_num_coalesced.fetch_add(num_messages - messages.size() - 1, std::memory_order_relaxed);
+		this->_num_sent.fetch_add(1, std::memory_order_relaxed);
+
+		this->_sender(message);
+
+		// Stay under the rate limit, messages that arrive meanwhile are joined into the next one
+		std::this_thread::sleep_for(this->_send_interval);
+	}
+}
+
+std::string Service::Notifier::_Coalesce(std::deque<std::string>& messages)
+{
+	std::string message = std::move(messages.front());
+	messages.pop_front();
+
+	if(message.size() > MAX_MESSAGE)
+	{
+		message.resize(MAX_MESSAGE);
+	}
+
+	// One message per line
+	while(!messages.empty() && message.size() + 1 + messages.front().size() <= MAX_MESSAGE)
+	{
+		message += '\n';
+		message += messages.front();
+
+		messages.pop_front();
+	}
+
+	return message;
+}
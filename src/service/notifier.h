@@ -0,0 +1,123 @@
+#ifndef SERVICE_NOTIFIER_H
+#define SERVICE_NOTIFIER_H
+
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace Service
+{
+	/**
+	 * @brief Sends queued messages from its own thread, paced for a rate limited chat service.
+	 *
+	 * Callers queue messages and never wait on the service. The notifier thread joins everything that
+	 * was queued since the last send into one message of at most MAX_MESSAGE characters, one message
+	 * per line, and keeps the send interval between two sends. After the service reports that the rate
+	 * limit was hit, nothing is sent for the rate limited interval. Messages wait till the notifier is ready.
+	 */
+	class Notifier
+	{
+		public:
+			/**
+			 * @brief Sends a joined message, called on the notifier thread.
+			 */
+			typedef std::function<void(const std::string& message)> Sender;
+
+			/**
+			 * @brief Called on the notifier thread between sends, at least every poll interval.
+			 */
+			typedef std::function<void()> Poller;
+
+			/**
+			 * @brief Maximum number of messages waiting to be sent, newer messages are dropped.
+			 */
+			static constexpr size_t MAX_QUEUE = 256;
+
+			/**
+			 * @brief Maximum length of a sent message, the limit of a Discord message.
+			 */
+			static constexpr size_t MAX_MESSAGE = 2000;
+
+			/**
+			 * @brief Time between two polls while there is nothing to send.
+			 */
+			static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+
+		private:
+			Sender                      _sender;                /**< Sends the joined messages. */
+			Poller                      _poller;                /**< Polled between sends, may be empty. */
+			std::chrono::milliseconds   _send_interval;         /**< Time between two sends. */
+			std::chrono::milliseconds   _rate_limited_interval; /**< Time to hold messages after the rate limit was hit. */
+
+			std::deque<std::string>     _queue;                 /**< Messages waiting to be sent. */
+			bool                        _ready = false;         /**< Queued messages may be sent. */
+			std::mutex                  _mutex;                 /**< Mutex for thread-safe access to the queue. */
+			std::condition_variable     _cv;                    /**< Wakes the notifier thread. */
+			std::thread                 _thread;                /**< The notifier thread. */
+
+			std::atomic<int64_t>        _rate_limited_until{0}; /**< Steady clock nanoseconds before which nothing is sent. */
+			std::atomic<uint64_t>       _num_sent{0};           /**< Joined messages handed to the sender. */
+			std::atomic<uint64_t>       _num_coalesced{0};      /**< Queued messages sent as part of another message. */
+			std::atomic<uint64_t>       _num_dropped{0};        /**< Queued messages dropped because the queue was full. */
+
+		public:
+			/**
+			 * @brief Constructor for the Notifier class.
+			 *
+			 * @param sender Sends the joined messages.
+			 * @param poller Polled on the notifier thread, may be empty.
+			 * @param send_interval Time between two sends.
+			 * @param rate_limited_interval Time to hold messages after RateLimited().
+			 */
+			Notifier(Sender sender, Poller poller, std::chrono::milliseconds send_interval, std::chrono::milliseconds rate_limited_interval);
+
+			/**
+			 * @brief Starts the notifier thread, the notifier must outlive it.
+			 */
+			void Start();
+
+			/**
+			 * @brief Queues a message, never blocks on the service.
+			 *
+			 * @param msg The message, dropped when the queue is full.
+			 */
+			void Send(const std::string& msg);
+
+			/**
+			 * @brief Lets queued messages be sent or holds them.
+			 *
+			 * @param ready True once the service can take messages.
+			 */
+			void SetReady(bool ready);
+
+			/**
+			 * @brief Holds messages for the rate limited interval, may be called from any thread.
+			 */
+			void RateLimited();
+
+			uint64_t GetNumSent() const      { return this->_num_sent.load(std::memory_order_relaxed);      }
+			uint64_t GetNumCoalesced() const { return this->_num_coalesced.load(std::memory_order_relaxed); }
+			uint64_t GetNumDropped() const   { return this->_num_dropped.load(std::memory_order_relaxed);   }
+
+		private:
+			/**
+			 * @brief Send the queued messages, runs on the notifier thread.
+			 */
+			void _Run();
+
+			/**
+			 * @brief Join queued messages into one message of at most MAX_MESSAGE characters.
+			 *
+			 * @param messages The messages, the ones that were joined are removed.
+			 * @return The joined message.
+			 */
+			static std::string _Coalesce(std::deque<std::string>& messages);
+	};
+}
+
+#endif // SERVICE_NOTIFIER_H
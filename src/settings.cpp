@@ -0,0 +1,147 @@
+#include <string>
+#include <cstdint>
+
+#include <settings.h>
+
+// Global
+std::atomic<const Settings*> g_settings{nullptr};
+
+/**
+ * @brief Read an optional boolean.
+ * @return False if the key holds something else.
+ */
+static bool ReadBool(const Json::Value& json, const std::string& path, const char* key, bool& value, std::string& error)
+{
+	if(!json.isMember(key))
+	{
+		return true;
+	}
+
+	if(!json[key].isBool())
+	{
+		error = path + "." + key + " must be true or false";
+		return false;
+	}
+
+	value = json[key].asBool();
+
+	return true;
+}
+
+/**
+ * @brief Read an optional integer in a range.
+ * @return False if the key holds something else or is out of range.
+ */
+template<typename T>
+static bool ReadInteger(const Json::Value& json, const std::string& path, const char* key, T& value, T min, T max, std::string& error)
+{
+	if(!json.isMember(key))
+	{
+		return true;
+	}
+
+	const Json::Value& member = json[key];
+
+	if(!member.isIntegral() || (member.isInt64() && member.asInt64() < static_cast<Json::Int64>(min)) ||
+	   (member.isUInt64() && member.asUInt64() > static_cast<Json::UInt64>(max)))
+	{
+		error = path + "." + key + " must be a number from " + std::to_string(min) + " till " + std::to_string(max);
+		return false;
+	}
+
+	value = static_cast<T>(member.asUInt64());
+
+	return true;
+}
+
+/**
+ * @brief Read an optional string.
+ * @return False if the key holds something else.
+ */
+static bool ReadString(const Json::Value& json, const std::string& path, const char* key, std::string& value, std::string& error)
+{
+	if(!json.isMember(key))
+	{
+		return true;
+	}
+
+	if(!json[key].isString())
+	{
+		error = path + "." + key + " must be a string";
+		return false;
+	}
+
+	value = json[key].asString();
+
+	return true;
+}
+
+/**
+ * @brief Read an optional object.
+ * @return False if the key holds something else.
+ */
+static bool ReadObject(const Json::Value& json, const char* key, const Json::Value*& value, std::string& error)
+{
+	static const Json::Value empty(Json::objectValue);
+
+	value = &empty;
+
+	if(!json.isMember(key))
+	{
+		return true;
+	}
+
+	if(!json[key].isObject())
+	{
+		error = std::string(key) + " must be an object";
+		return false;
+	}
+
+	value = &json[key];
+
+	return true;
+}
+
+/**
+ * @brief Read the settings every server has.
+ */
+static bool ReadServer(const Json::Value& json, const std::string& path, Settings::Server& server, std::string& error)
+{
+	return ReadInteger(json, path, "port", server.port, 1, 65535, error) &&
+	       ReadInteger(json, path, "threads", server.threads, 1, 256, error) &&
+	       ReadInteger(json, path, "send_queue_limit", server.send_queue_limit, 1, INT32_MAX, error) &&
+	       ReadInteger(json, path, "connection_time_out", server.connection_time_out, 1, 86400, error) &&
+	       ReadBool(json, path, "show_requests", server.show_requests, error) &&
+	       ReadBool(json, path, "show_responses", server.show_responses, error);
+}
+
+bool Settings::FromJson(const Json::Value& json, Settings& settings, std::string& error)
+{
+	const Json::Value* theater;
+	const Json::Value* webserver;
+	const Json::Value* discord;
+
+	if(!json.isObject())
+	{
+		error = "settings must be an object";
+		return false;
+	}
+
+	if(!ReadObject(json, "theater", theater, error) ||
+	   !ReadObject(json, "webserver", webserver, error) ||
+	   !ReadObject(json, "discord", discord, error))
+	{
+		return false;
+	}
+
+	return ReadServer(*theater, "theater", settings.theater, error) &&
+	       ReadBool(*theater, "theater", "binary_log", settings.theater.binary_log, error) &&
+	       ReadInteger<uint64_t>(*theater, "theater", "binary_log_segment_size", settings.theater.binary_log_segment_size,
+	                             1024 * 1024, UINT32_MAX, error) &&
+	       ReadServer(*webserver, "webserver", settings.webserver, error) &&
+	       ReadString(*webserver, "webserver", "password", settings.webserver.password, error) &&
+	       ReadString(*discord, "discord", "token", settings.discord.token, error) &&
+	       ReadString(*discord, "discord", "channel", settings.discord.channel, error) &&
+	       ReadBool(json, "settings", "show_client_connect", settings.show_client_connect, error) &&
+	       ReadBool(json, "settings", "show_client_disconnect", settings.show_client_disconnect, error);
+}
@@ -1,23 +1,104 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
-#include <shared_mutex>
+#include <atomic>
+#include <string>
+#include <cstdint>
 
 #include <json/json.h>
 
 /**
- * @brief Global settings object.
- * 
- * This global variable holds the settings loaded from a JSON file.
+ * @brief Typed settings, loaded from data/settings.json.
+ *
+ * A loaded Settings object is never changed. A reload publishes a new object and frees the old
+ * one a grace period later, so a reference from GetSettings() stays valid while a request is
+ * handled and readers never take a lock.
+ * Ports, threads, send queue limits, time outs, the binary log and the Discord token are only
+ * read when the server starts, everything else follows a reload.
  */
-extern Json::Value       g_settings;
+struct Settings
+{
+	/**
+	 * @brief Settings of a server.
+	 */
+	struct Server
+	{
+		int         port;                            /**< Port to listen on. */
+		int         threads;                         /**< Number of event loop threads. */
+		int         send_queue_limit = 256 * 1024;   /**< Bytes a client may have queued before it is disconnected. */
+		int         connection_time_out = 60;        /**< Seconds without data before a client is disconnected. */
+		bool        show_requests = false;           /**< Show the requests on the console. */
+		bool        show_responses = false;          /**< Show the responses on the console. */
+
+		/**
+		 * @brief Create the settings of a server with its default port and threads.
+		 * @param port Port to listen on.
+		 * @param threads Number of event loop threads.
+		 */
+		Server(int port, int threads) : port(port), threads(threads) {}
+	};
+
+	/**
+	 * @brief Settings of the Theater server.
+	 */
+	struct Theater : Server
+	{
+		bool        binary_log = false;                         /**< Write the binary transaction log instead of the text log. */
+		uint64_t    binary_log_segment_size = 64 * 1024 * 1024; /**< Size of a binary transaction log segment. */
+
+		Theater() : Server(14300, 2) {}
+	};
+
+	/**
+	 * @brief Settings of the webserver.
+	 */
+	struct Webserver : Server
+	{
+		std::string password;               /**< Password of the admin API. */
+
+		Webserver() : Server(8080, 1) {}
+	};
+
+	/**
+	 * @brief Settings of the Discord service.
+	 */
+	struct Discord
+	{
+		std::string token;                        /**< Token of the bot. */
+		std::string channel = "mohrs-matchmaker"; /**< Name of the channel to send to in every guild. */
+	};
+
+	Theater   theater;
+	Webserver webserver;
+	Discord   discord;
+	bool      show_client_connect = false;    /**< Show connecting clients on the console. */
+	bool      show_client_disconnect = false; /**< Show disconnecting clients on the console. */
+
+	/**
+	 * @brief Read and validate settings from JSON.
+	 *
+	 * Missing keys keep their default, a key with the wrong type or a value out of range fails.
+	 *
+	 * @param json The parsed settings file.
+	 * @param settings[out] The settings.
+	 * @param error[out] What is wrong when the settings are invalid.
+	 * @return True if the settings are valid.
+	 */
+	static bool FromJson(const Json::Value& json, Settings& settings, std::string& error);
+};
+
+/**
+ * @brief The current settings.
+ *
+ * Points to the last published Settings object, a replaced object is freed after a grace period.
+ */
+extern std::atomic<const Settings*> g_settings;
 
 /**
- * @brief Mutex for thread-safe access to settings.
- * 
- * This mutex is used to ensure thread safety when accessing or modifying
- * the global settings object.
+ * @brief Get the current settings without locking.
+ *
+ * @return The settings, do not keep the reference longer than the handling of a request.
  */
-extern std::shared_mutex g_settings_mutex;
+inline const Settings& GetSettings() { return *g_settings.load(std::memory_order_acquire); }
 
 #endif // SETTINGS_H
@@ -1,10 +1,12 @@
 #include <unistd.h>
+#include <errno.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <regex>
 #include <thread>
-#include <sstream>
+#include <array>
+#include <atomic>
 
 #include <settings.h>
 #include <logger.h>
@@ -14,28 +16,103 @@
 #include <mohrs/region.h>
 #include <mohrs/game.h>
 #include <mohrs/matchmaker.h>
+#include <mohrs/favorites.h>
+#include <theater/list_cache.h>
+#include <theater/transaction_log.h>
 #include <service/file_system.h>
 
 #include <theater/client.h>
 
-typedef void (Theater::Client::*RequestActionFunc)(const Theater::Parameter&);
+typedef void (Theater::Client::*RequestActionFunc)(const Theater::ParameterView&);
 
-static std::map<std::string, RequestActionFunc> mRequestActions = 
+/**
+ * @brief How expensive it is to handle an action.
+ */
+enum class RequestCost : uint8_t
 {
-	{ "CONN",                           &Theater::Client::requestCONN               },
-	{ "USER",                           &Theater::Client::requestUSER               },
-	{ "PROF",                           &Theater::Client::requestPROF               },
-	{ "LLST",                           &Theater::Client::requestLLST               },
-	{ "GLST",                           &Theater::Client::requestGLST               },
-	{ "RLST",                           &Theater::Client::requestRLST               },
-	{ "CGAM",                           &Theater::Client::requestCGAM               },
-	{ "UGAM",                           &Theater::Client::requestUGAM               },
-	{ "RGAM",                           &Theater::Client::requestRGAM               },
-	{ "FILE",                           &Theater::Client::requestFILE               },
-	{ "PING",                           &Theater::Client::requestPING               },
+	Light,  /**< Answered without touching the matchmaker. */
+	Browse, /**< Reads games from the matchmaker. */
+	Write,  /**< Changes games in the matchmaker. */
 };
 
-Theater::Client::Client(int socket, struct sockaddr_in address)
+/**
+ * @brief Dispatch entry with the handler and metadata of an action.
+ */
+struct RequestAction
+{
+	uint32_t                        code;     /**< FourCC of the action. */
+	std::string_view                name;     /**< Name of the action. */
+	RequestActionFunc               func;     /**< Handler of the action. */
+	RequestCost                     cost;     /**< Cost class of the action. */
+	std::array<std::string_view, 4> required; /**< Parameters the request must contain. */
+};
+
+static constexpr RequestAction mRequestActions[] = 
+{
+	{ Theater::FourCC("CONN"), "CONN", &Theater::Client::requestCONN, RequestCost::Light,  {                                                   } },
+	{ Theater::FourCC("USER"), "USER", &Theater::Client::requestUSER, RequestCost::Light,  {                                                   } },
+	{ Theater::FourCC("PROF"), "PROF", &Theater::Client::requestPROF, RequestCost::Light,  { "TEXT"                                            } },
+	{ Theater::FourCC("LLST"), "LLST", &Theater::Client::requestLLST, RequestCost::Browse, { "TID"                                             } },
+	{ Theater::FourCC("GLST"), "GLST", &Theater::Client::requestGLST, RequestCost::Browse, { "TID", "LOBBY-ID"                                 } },
+	{ Theater::FourCC("RLST"), "RLST", &Theater::Client::requestRLST, RequestCost::Browse, { "TID"                                             } },
+	{ Theater::FourCC("CGAM"), "CGAM", &Theater::Client::requestCGAM, RequestCost::Write,  { "HOST-PLAYER", "NAME", "REGION-ID", "MAX-PLAYERS" } },
+	{ Theater::FourCC("UGAM"), "UGAM", &Theater::Client::requestUGAM, RequestCost::Write,  {                                                   } },
+	{ Theater::FourCC("RGAM"), "RGAM", &Theater::Client::requestRGAM, RequestCost::Write,  {                                                   } },
+	{ Theater::FourCC("FILE"), "FILE", &Theater::Client::requestFILE, RequestCost::Light,  { "TID"                                             } },
+	{ Theater::FourCC("PING"), "PING", &Theater::Client::requestPING, RequestCost::Light,  {                                                   } },
+};
+
+static constexpr size_t NUM_REQUEST_ACTIONS = sizeof(mRequestActions) / sizeof(mRequestActions[0]);
+
+/**
+ * @brief Get the index of an action in mRequestActions.
+ * @param code The FourCC of the action.
+ * @return The index of the action or -1 when the action is unknown.
+ */
+static constexpr int GetRequestActionIndex(uint32_t code)
+{
+	switch(code)
+	{
+		case Theater::FourCC("CONN"): return 0;
+		case Theater::FourCC("USER"): return 1;
+		case Theater::FourCC("PROF"): return 2;
+		case Theater::FourCC("LLST"): return 3;
+		case Theater::FourCC("GLST"): return 4;
+		case Theater::FourCC("RLST"): return 5;
+		case Theater::FourCC("CGAM"): return 6;
+		case Theater::FourCC("UGAM"): return 7;
+		case Theater::FourCC("RGAM"): return 8;
+		case Theater::FourCC("FILE"): return 9;
+		case Theater::FourCC("PING"): return 10;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Check at compile time that the switch and the dispatch table agree.
+ */
+static constexpr bool CheckRequestActions()
+{
+	for(size_t i = 0; i < NUM_REQUEST_ACTIONS; i++)
+	{
+		if(GetRequestActionIndex(mRequestActions[i].code) != static_cast<int>(i) ||
+			Theater::FourCC(mRequestActions[i].name) != mRequestActions[i].code)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static_assert(CheckRequestActions(), "mRequestActions and GetRequestActionIndex() are out of sync");
+
+static std::atomic<uint64_t> mRequestCounts[NUM_REQUEST_ACTIONS]; /**< Handled requests per action. */
+static std::atomic<uint64_t> mRequestsIncomplete;                 /**< Requests missing a required parameter. */
+static std::atomic<uint64_t> mRequestsUnknown;                    /**< Requests with an unknown action. */
+
+Theater::Client::Client(int socket, struct sockaddr_in address) : _flight_recorder(Theater::FlightRecorder::CONNECTION_CAPACITY, Theater::FlightRecorder::CONNECTION_SNAP_LENGTH)
 {
 	this->_socket = socket;
 	this->_address = address;
@@ -47,31 +124,100 @@ Theater::Client::~Client()
 	this->Disconnect();
 }
 
-void Theater::Client::Listen()
+bool Theater::Client::onReadable()
 {
 	while(true)
 	{
-		std::vector<unsigned char> buffer(4096, 0);
+		size_t buffer_size;
+		unsigned char* buffer = this->_framer.GetWriteBuffer(buffer_size);
 		
-		int recv_size = read(this->_socket, &(buffer[0]), 4096);
+		int recv_size = read(this->_socket, buffer, buffer_size);
 		
-		// If error or no data is recieved we end the connection
-		if(recv_size <= 0)
+		if(recv_size < 0)
 		{
-			break;
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			// Socket is drained, wait for the next readiness event
+			return (errno == EAGAIN || errno == EWOULDBLOCK);
+		}
+
+		// If no data is recieved the client closed the connection
+		if(recv_size == 0)
+		{
+			return false;
 		}
 		
-		// Resize buffer
-		buffer.resize(recv_size);
+		this->_framer.Commit(recv_size);
 		
 		this->UpdateLastRecievedTime();
 
-		this->_LogTransaction("-->", Util::Buffer::ToString(buffer));
+		// Handle every complete frame, a partial frame waits for the next read.
+		// All responses to this read are gathered and written at once.
+		std::string_view request;
+		Theater::Framer::Result result;
+		
+		this->BeginBatch();
+		
+		while((result = this->_framer.Next(request)) == Theater::Framer::Result::Frame)
+		{
+			this->_num_requests++;
+			
+			this->_LogTransaction(Theater::TransactionLogFormat::Direction::Request, request);
+			
+			this->onRequest(request);
+		}
 		
-		this->onRequest(buffer);
+		this->EndBatch();
+		
+		if(result == Theater::Framer::Result::Invalid)
+		{
+			Logger::warning("Client " + this->GetAddress() + " sent a frame with an invalid size", Server::Type::Theater);
+			
+			return false;
+		}
 	}
-	
-	this->Disconnect();
+}
+
+uint64_t Theater::Client::ReserveResponse() const
+{
+	std::lock_guard<std::mutex> guard(this->_reservations_mutex); // reservations lock
+
+	this->_reservations.emplace_back();
+
+	return this->_first_reservation + this->_reservations.size() - 1;
+}
+
+void Theater::Client::SendReserved(uint64_t reservation, std::vector<std::string> responses) const
+{
+	std::lock_guard<std::mutex> guard(this->_reservations_mutex); // reservations lock
+
+	Reservation& reserved = this->_reservations[reservation - this->_first_reservation];
+	reserved.sent = true;
+	reserved.responses = std::move(responses);
+
+	this->BeginBatch();
+
+	// Reservations can be sent out of order, only the oldest ones that are complete go out
+	while(!this->_reservations.empty() && this->_reservations.front().sent)
+	{
+		for(const std::string& response : this->_reservations.front().responses)
+		{
+			this->_Queue(response);
+		}
+
+		for(const std::string& response : this->_reservations.front().held)
+		{
+			this->_Queue(response);
+		}
+
+		this->_reservations.pop_front();
+		this->_first_reservation++;
+	}
+
+	this->EndBatch();
 }
 
 void Theater::Client::Disconnect()
@@ -82,384 +228,322 @@ void Theater::Client::Disconnect()
 	g_theater_server->onClientDisconnect(*this);
 }
 
-void Theater::Client::Send(const std::string& action, const Theater::Parameter& parameter) const
+uint64_t Theater::Client::GetNumRequests() const
 {
-	// Generate data from parameter
-	std::string data = Theater::Client::GetData(parameter);
-	
-	this->Send(action, data);	
+	return this->_num_requests;
 }
 
-void Theater::Client::Send(const std::string& action, const std::string& data) const
+std::map<std::string, uint64_t> Theater::Client::GetRequestCounts()
 {
-	std::vector<unsigned char> response(Theater::HEADER_SIZE, 0);
+	std::map<std::string, uint64_t> counts;
 	
-	// Set action
-	std::copy(action.begin(), action.begin() + 4, response.begin());
-
-	// Set data size
-	uint32_t calc_size = Theater::HEADER_SIZE;
-
-	if(data.size() > 0)
+	for(size_t i = 0; i < NUM_REQUEST_ACTIONS; i++)
 	{
-		// Set data
-		response.insert(response.end(), data.begin(), data.end());
-
-		// End
-		response.push_back(0x00);
-
-		// fix calc size
-		calc_size += data.size() +  1;
+		counts[std::string(mRequestActions[i].name)] = mRequestCounts[i];
 	}
 	
-	response[8] = (calc_size >> 24) & 0xFF;
-	response[9] = (calc_size >> 16) & 0xFF;
-	response[10] = (calc_size >> 8) & 0xFF;
-	response[11] = calc_size & 0xFF;
-
-	this->Net::Socket::Send(response);
-
-	this->_LogTransaction("<--", Util::Buffer::ToString(response));
+	counts["incomplete"] = mRequestsIncomplete;
+	counts["unknown"] = mRequestsUnknown;
+	
+	return counts;
 }
 
 // Events
 
-void Theater::Client::onRequest(const std::vector<unsigned char>& request)
+void Theater::Client::onRequest(std::string_view request)
 {
 	if(request.size() < Theater::HEADER_SIZE)
 		return;
 
-	std::string action(request.begin(), request.begin() + 4);
-	Parameter parameter;
-
-	// Check if byte 9 till 12 has the same length as the request
-	//uint32_t request_length = 0;
-	//request_length |= static_cast<uint32_t>(request[8]) << 24;
-	//request_length |= static_cast<uint32_t>(request[9]) << 16;
-	//request_length |= static_cast<uint32_t>(request[10]) << 8;
-	//request_length |= static_cast<uint32_t>(request[11]);
+	Theater::ParameterView parameter;
+	int index = GetRequestActionIndex(Theater::FourCC(request.substr(0, 4)));
 	
-	//Logger::debug("request_length = " + std::to_string(request_length));
-	//Logger::debug("request.size() = " + std::to_string(request.size()));
+	if(index < 0)
+	{
+		uint64_t count = ++mRequestsUnknown;
+		
+		// Only log on powers of two, so garbage can not flood the log
+		if((count & (count - 1)) == 0)
+		{
+			Logger::warning("action \"" + Util::Buffer::ToString(request.substr(0, 4)) + "\" not implemented! (" +
+				std::to_string(count) + " unknown actions)", Server::Type::Theater);
+		}
+		
+		return;
+	}
+	
+	const RequestAction& action = mRequestActions[index];
 
 	// Extract parameter
 	if(request.size() > Theater::HEADER_SIZE)
 	{
-		// We expect that the last byte of the request is 0x00.
-		std::string data(request.begin() + Theater::HEADER_SIZE, request.end() - 1);
-
-		// Convert data to parameters
-		parameter = Theater::Client::GetParameter(data);
+		std::string_view data = request.substr(Theater::HEADER_SIZE);
+		
+		// Strip the 0x00 that ends the data
+		if(data.back() == 0x00)
+		{
+			data.remove_suffix(1);
+		}
 
-		//Logger::debug("data = " + data);
-		//for (const auto& pair : parameter) {
-		//	Logger::debug("Key: " + pair.first + ", Value: " + pair.second);
-		//}
+		// Parse data in place
+		parameter.Parse(data);
 	}
-
-	auto it = mRequestActions.find(action);
-	if (it != mRequestActions.end())
-	{
-		// Get Function address
-		RequestActionFunc func = it->second;
 	
-		// Execute action function with class object.
-		(this->*(func))(parameter);
-	}
-	else
-	{		
-		Logger::warning("action \"" + action + "\" not implemented!", Server::Type::Theater);
+	// Ignore requests that miss a required parameter
+	for(std::string_view key : action.required)
+	{
+		if(!key.empty() && !parameter.Has(key))
+		{
+			mRequestsIncomplete++;
+			return;
+		}
 	}
+	
+	mRequestCounts[index]++;
+	
+	// Execute action function with class object.
+	(this->*(action.func))(parameter);
 }
 
-void Theater::Client::requestCONN(const Theater::Parameter& parameter)
+void Theater::Client::requestCONN(const Theater::ParameterView& parameter)
 {
-	this->Send("CONN", {
-		{"NUM-CHALLENGES", "0"},
-		{"IMPORTANT", "Elon_Musk_Wants_to_Embed_AI-on-a-Chip_Into_Every_Human_Brain"}
-	});
+	Theater::Response::CONN conn;
+	conn.important = "Elon_Musk_Wants_to_Embed_AI-on-a-Chip_Into_Every_Human_Brain";
+	conn.num_challenges = 0;
+
+	this->Send(conn);
 }
 
-void Theater::Client::requestUSER(const Theater::Parameter& parameter)
+void Theater::Client::requestUSER(const Theater::ParameterView& parameter)
 {
-	this->Send("USER", {
-		{ "TICKET", Util::addQuote("1111") }
-	});
+	Theater::Response::USER user;
+	user.ticket = "1111";
+
+	this->Send(user);
 }
 
-void Theater::Client::requestPROF(const Theater::Parameter& parameter)
+void Theater::Client::requestPROF(const Theater::ParameterView& parameter)
 {
-	if(parameter.find("TEXT") == parameter.end())
-	{
-		return;
-	}
-
-	std::string text = parameter.at("TEXT");
+	Theater::Response::PROF prof;
+	prof.clean_text = parameter.Get("TEXT");
 
-	this->Send("PROF", {
-		{ "CLEAN-TEXT", text }
-	});
+	this->Send(prof);
 }
 
-void Theater::Client::requestLLST(const Theater::Parameter& parameter)
+void Theater::Client::requestLLST(const Theater::ParameterView& parameter)
 {
-	if(parameter.find("TID") == parameter.end())
-	{
-		return;
-	}
+	std::string_view tid = parameter.Get("TID");
+	MoHRS::Favorites favorites(parameter);
 
-	std::string tid = parameter.at("TID");
+	Theater::Response::LLST llst;
+	llst.num_lobbies = static_cast<int64_t>(MoHRS::RegionNames.size());
+	llst.tid = tid;
 
-	this->Send("LLST", {
-		{ "TID", tid},
-		{ "NUM-LOBBIES", std::to_string(MoHRS::RegionNames.size()) }
-	});
+	this->Send(llst);
 
 	for(const auto& region : MoHRS::RegionNames)
 	{
-		MoHRS::Games games;
+		std::shared_ptr<const Theater::ListCache::Region> cached = g_list_cache->Get(region.first);
 		int num_fav_games = 0,
 			num_fav_players = 0;
 
-		g_matchmaker->findGamesByRegion(region.first, games);
-		g_matchmaker->findFavoritesByGames(parameter, games, num_fav_games, num_fav_players);
-
-		this->Send("LDAT", {
-			{ "TID", tid },
-			{ "LOBBY-ID", std::to_string(static_cast<int8_t>(region.first)) },
-			{ "NAME", Util::addQuote(region.second) },
-			{ "LOCALE", "1" },
-			{ "NUM-GAMES", std::to_string(games.size()) },
-			{ "FAVORITE-GAMES", std::to_string(num_fav_games) },
-			{ "FAVORITE-PLAYERS", std::to_string(num_fav_players) }
-		});
+		favorites.Count(cached->snapshot->games, num_fav_games, num_fav_players);
+
+		Theater::Response::CachedLDAT ldat;
+		ldat.favorite_games = num_fav_games;
+		ldat.favorite_players = num_fav_players;
+		ldat.lobby = cached->lobby;
+		ldat.tid = tid;
+
+		this->Send(ldat);
 	}
 }
 
-void Theater::Client::requestGLST(const Theater::Parameter& parameter)
+void Theater::Client::requestGLST(const Theater::ParameterView& parameter)
 {
-	if(parameter.find("TID") == parameter.end() || parameter.find("LOBBY-ID") == parameter.end())
-	{
-		return;
-	}
-
-	std::string tid = parameter.at("TID");
-	std::string lobby_id = parameter.at("LOBBY-ID");
+	std::string_view tid = parameter.Get("TID");
+	std::string_view lobby_id = parameter.Get("LOBBY-ID");
+	MoHRS::Favorites favorites(parameter);
 
 	MoHRS::Game game;
-	MoHRS::Games games;
-	
 
 	// Convert region
 	game.SetRegion(lobby_id);
 
 	// Find games
-	g_matchmaker->findGamesByRegion(game.GetRegion(), games);
+	std::shared_ptr<const Theater::ListCache::GameList> cached = g_list_cache->GetGames(game.GetRegion());
 
-	this->Send("GLST", {
-		{ "TID", tid },
-		{ "LOBBY-ID", lobby_id },
-		{ "NUM-GAMES", std::to_string(games.size()) },
-	});
+	Theater::Response::GLST glst;
+	glst.lobby_id = lobby_id;
+	glst.num_games = static_cast<int64_t>(cached->snapshot->games.size());
+	glst.tid = tid;
+
+	this->Send(glst);
 
-	for(const MoHRS::Game& game : games)
+	for(size_t i = 0; i < cached->snapshot->games.size(); i++)
 	{
 		int num_fav_games = 0,
 			num_fav_players = 0;
 
-		g_matchmaker->findFavoritesByGame(parameter, game, num_fav_games, num_fav_players);
-
-		this->Send("GDAT", {
-			{ "TID", tid },
-			{ "IP", Util::addQuote(game.GetIp()) },
-			{ "PORT", "28500" },
-			{ "GAME-ID", std::to_string(game.GetId()) },
-			{ "FAVORITE", std::to_string(num_fav_games) },
-			{ "NUM-FAV-PLAYERS", std::to_string(num_fav_players) },
-			{ "NUM-PLAYERS", std::to_string(game.GetNumPlayers()) },
-			{ "MAX-PLAYERS", std::to_string(game.GetMaxPlayers()) },
-			{ "NAME", Util::addQuote(game.GetName()) },
-		});
+		favorites.Count(*cached->snapshot->games[i], num_fav_games, num_fav_players);
+
+		Theater::Response::CachedGDAT gdat;
+		gdat.favorite = num_fav_games;
+		gdat.server = cached->games[i].server;
+		gdat.num_fav_players = num_fav_players;
+		gdat.status = cached->games[i].status;
+		gdat.tid = tid;
+
+		this->Send(gdat);
 	}
 }
 
-void Theater::Client::requestRLST(const Theater::Parameter& parameter)
+void Theater::Client::requestRLST(const Theater::ParameterView& parameter)
 {
-	if(parameter.find("TID") == parameter.end())
-	{
-		return;
-	}
+	std::string_view tid = parameter.Get("TID");
 
-	std::string tid = parameter.at("TID");
+	Theater::Response::RLST rlst;
+	rlst.num_regions = static_cast<int64_t>(MoHRS::RegionNames.size());
+	rlst.tid = tid;
 
-	this->Send("RLST", {
-		{ "TID", tid },
-		{ "NUM-REGIONS", std::to_string(MoHRS::RegionNames.size()) }
-	});
+	this->Send(rlst);
 
 	for(const auto& region : MoHRS::RegionNames)
 	{
-		MoHRS::Games games;
-
-		g_matchmaker->findGamesByRegion(region.first, games);
-
-		this->Send("RDAT", {
-			{ "TID", tid },
-			{ "REGION-ID", std::to_string(static_cast<int8_t>(region.first)) },
-			{ "NAME", Util::addQuote(region.second) },
-			{ "LOCALE", "0" },
-			{ "NUM-GAMES", std::to_string(games.size()) },
-			{ "NUM-PLAYERS", "0" }, // Don't see a reason to process
-		});
+		std::shared_ptr<const Theater::ListCache::Region> cached = g_list_cache->Get(region.first);
+
+		Theater::Response::CachedRDAT rdat;
+		rdat.region = cached->region;
+		rdat.tid = tid;
+
+		this->Send(rdat);
 	}
 }
 
-void Theater::Client::requestCGAM(const Theater::Parameter& parameter)
+void Theater::Client::requestCGAM(const Theater::ParameterView& parameter)
 {
-	MoHRS::Game game;
+	Net::SocketTable::Handle handle = this->GetHandle();
 
-	if(!g_matchmaker->createGame(*this, parameter, game))
-		return;
-	
-	// Send create game successfull
-	this->Send("CGAM", {
-		{ "LOBBY-ID", std::to_string(static_cast<uint8_t>(game.GetRegion())) },
-		{ "GAME-ID", std::to_string(game.GetId()) }
-	});
+	// The game gets its id when the matchmaker commits it and the response is sent from there,
+	// responses to the next requests wait for it
+	uint64_t reservation = this->ReserveResponse();
+
+	bool queued = g_matchmaker->createGame(*this, parameter, [handle, reservation](const MoHRS::Game& game)
+	{
+		std::shared_ptr<Net::Socket> socket = g_theater_server->GetClient(handle);
+
+		// Client disconnected before the game was committed
+		if(!socket)
+		{
+			return;
+		}
 
-	// Send update time in seconds
-	this->Send("UGAM", {
-		{"QUENCH", "20"}
+		const Theater::Client& client = static_cast<const Theater::Client&>(*socket);
+
+		// Send create game successfull
+		Theater::Response::CGAM cgam;
+		cgam.game_id = game.GetId();
+		cgam.lobby_id = static_cast<uint8_t>(game.GetRegion());
+
+		// Send update time in seconds
+		Theater::Response::UGAM ugam;
+		ugam.quench = 20;
+
+		client.SendReserved(reservation, { Theater::Client::_Encode(cgam), Theater::Client::_Encode(ugam) });
 	});
+
+	// Rejected, nothing is sent
+	if(!queued)
+	{
+		this->SendReserved(reservation, {});
+	}
 }
 
-void Theater::Client::requestUGAM(const Theater::Parameter& parameter)
+void Theater::Client::requestUGAM(const Theater::ParameterView& parameter)
 {
 	g_matchmaker->updateGame(*this, parameter);
 }
 
-void Theater::Client::requestRGAM(const Theater::Parameter& parameter)
+void Theater::Client::requestRGAM(const Theater::ParameterView& parameter)
 {
 	g_matchmaker->removeGame(this->GetAddress());
 }
 
-void Theater::Client::requestFILE(const Theater::Parameter& parameter)
+void Theater::Client::requestFILE(const Theater::ParameterView& parameter)
 {
-	if(parameter.find("TID") == parameter.end())
-	{
-		return;
-	}
+	std::string_view tid = parameter.Get("TID");
 
-	std::string tid = parameter.at("TID");
+	Theater::Response::FILE file;
+	file.num_chunks = 1;
+	file.tid = tid;
+	file.type = "moh3/tos/";
 
-	this->Send("FILE", {
-		{ "TID", tid },
-		{ "TYPE", "moh3/tos/" },
-		{ "NUM-CHUNKS", "1" }
-	});
+	this->Send(file);
 
 	// Max is 2047 characters you can send in one transaction with FCHU.
 	std::string data;
 	g_file_system->GetFile("../data/eula.txt", data);
 	
-	this->Send("FCHU", {
-		{ "TID", tid },
-		{ "DATA", Util::addQuote(data) }
-	});
+	Theater::Response::FCHU fchu;
+	fchu.data = data;
+	fchu.tid = tid;
+
+	this->Send(fchu);
 }
 
-void Theater::Client::requestPING(const Theater::Parameter& parameter)
+void Theater::Client::requestPING(const Theater::ParameterView& parameter)
 {
-	Theater::Parameter response;
-
-	this->Send("PONG", response);
+	this->Send(Theater::Response::PONG());
 }
 
 // Private functions
 
-void Theater::Client::_LogTransaction(const std::string& direction, const std::string& response) const
+void Theater::Client::_LogTransaction(Theater::TransactionLogFormat::Direction direction, std::string_view frame) const
 {
-	std::shared_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read)
-	
-	//if ((g_logger_mode & Logger::Mode::Development) == 0)
-	//{
-	//	return;
-	//}
+	// Always recorded, dumped by the admin API or SIGUSR1 when a client misbehaves
+	this->_flight_recorder.Record(this->GetHandle(), direction, frame);
+	g_flight_recorder->Record(this->GetHandle(), direction, frame);
 	
-	bool show_console = (g_settings["theater"]["show_requests"].asBool() && direction == "-->") ||
-						(g_settings["theater"]["show_responses"].asBool() && direction == "<--");
+	// The binary log replaces the text log, mohrs-logdump turns it into text
+	if(g_transaction_log != nullptr)
+	{
+		g_transaction_log->Append(this->GetHandle(), direction, frame);
+		
+		return;
+	}
 	
-	Logger::info(this->GetAddress() + " " + direction + " " + response,
-			Server::Type::Theater, show_console);
-}
-
-Theater::Parameter Theater::Client::GetParameter(const std::string& data)
-{
-	std::istringstream iss(data);
-	Theater::Parameter parameter;
-
-	std::string token;
-	while (std::getline(iss, token, ' '))
+	// Compiled out of release builds, the frame is only copied and made printable by the writer thread
+	if(!MOHRS_LOG_ENABLED(Logger::Level::Transaction))
 	{
-		// Skip empty tokens
-		if (token.empty()) {
-			continue;
-		}
-
-		// Find the position of '=' in the token
-		size_t equalPos = token.find('=');
-		if (equalPos != std::string::npos) {
-			// Split the token into key and value
-			std::string key = token.substr(0, equalPos);
-			std::string value = token.substr(equalPos + 1);
-
-			// Add key-value pair to the map
-			parameter[key] = value;
-		}
+		return;
 	}
-
-	return parameter;
+	
+	const Settings::Theater& settings = GetSettings().theater;
+	
+	bool is_request = (direction == Theater::TransactionLogFormat::Direction::Request);
+	bool show_console = (settings.show_requests && is_request) || (settings.show_responses && !is_request);
+	
+	Logger::Log(Logger::Level::Transaction, Server::Type::Theater, show_console,
+			this->GetAddress(), is_request ? " --> " : " <-- ", Logger::Frame{std::string(frame)});
 }
 
-std::string Theater::Client::GetData(const Theater::Parameter& parameter)
+void Theater::Client::_Send(std::string_view response) const
 {
-	std::string data;
+	std::lock_guard<std::mutex> guard(this->_reservations_mutex); // reservations lock
 
-	for (const auto& pair : parameter)
+	// Held till the reserved responses before it are sent
+	if(!this->_reservations.empty())
 	{
-		data += pair.first + "=" + pair.second + " ";
-	}
-
-	// Remove the trailing space if there are any key-value pairs
-	if (!parameter.empty())
-	{
-		data.pop_back();
+		this->_reservations.back().held.emplace_back(response);
+		return;
 	}
 
-	return data;
+	this->_Queue(response);
 }
 
-// Static functions
-
-void Theater::Client::Heartbeat()
+void Theater::Client::_Queue(std::string_view response) const
 {
-	Logger::info("Heartbeat started", Server::Theater);
+	this->Net::Socket::Send(response.data(), response.size());
 
-	while(true)
-	{
-		std::this_thread::sleep_for (std::chrono::seconds(60));
-
-		auto target_time = std::chrono::system_clock::now() - std::chrono::minutes(1);
-
-		for(std::shared_ptr<Net::Socket> client : g_theater_server->GetClients())
-		{
-			auto last_recieved = client.get()->GetLastRecievedTime();
-
-			if (last_recieved <= target_time)
-			{
-				client.get()->Close();
-			}
-		}
-	}
+	this->_LogTransaction(Theater::TransactionLogFormat::Direction::Response, response);
 }
-
@@ -1,7 +1,18 @@
 #ifndef THEATER_CLIENT_H
 #define THEATER_CLIENT_H
 
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <mutex>
+
 #include <net/socket.h>
+#include <theater/framer.h>
+#include <theater/encoder.h>
+#include <theater/messages.h>
+#include <theater/parameter_view.h>
+#include <theater/flight_recorder.h>
 #include <util.h>
 
 /**
@@ -11,15 +22,22 @@
 namespace Theater
 {
 	/**
-	 * @typedef Parameter
-	 * @brief Typedef for a map of string parameters.
+	 * @brief Size of the header for network communication.
 	 */
-	typedef std::map<std::string, std::string> Parameter;
+	const int HEADER_SIZE = 12;
 
 	/**
-	 * @brief Size of the header for network communication.
+	 * @brief Encodes a 4 byte action tag as an integer.
+	 * @param code The action tag, for example "CONN".
+	 * @return The action tag as a big-endian integer.
 	 */
-	const int HEADER_SIZE = 12;
+	constexpr uint32_t FourCC(std::string_view code)
+	{
+		return (static_cast<uint32_t>(static_cast<uint8_t>(code[0])) << 24) |
+		       (static_cast<uint32_t>(static_cast<uint8_t>(code[1])) << 16) |
+		       (static_cast<uint32_t>(static_cast<uint8_t>(code[2])) << 8)  |
+		        static_cast<uint32_t>(static_cast<uint8_t>(code[3]));
+	}
 
 	/**
 	 * @class Client
@@ -28,6 +46,26 @@ namespace Theater
 	 */
 	class Client : public Net::Socket
 	{
+		private:
+			Theater::Framer                    _framer;          /**< Splits the received stream into frames. */
+			std::atomic<uint64_t>              _num_requests{0}; /**< Number of frames handled. */
+			mutable std::vector<unsigned char> _response;        /**< Reused buffer the responses are encoded in. */
+			mutable Theater::FlightRecorder    _flight_recorder; /**< The last frames of this connection. */
+
+			/**
+			 * @brief A response that is sent later, with the responses that were sent after it.
+			 */
+			struct Reservation
+			{
+				bool                     sent = false; /**< The reserved responses were given. */
+				std::vector<std::string> responses;    /**< The reserved responses. */
+				std::vector<std::string> held;         /**< Responses sent after the reservation, in order. */
+			};
+
+			mutable std::mutex              _reservations_mutex;     /**< Orders the responses while a reservation is open. */
+			mutable std::deque<Reservation> _reservations;           /**< Open reservations, oldest first. */
+			mutable uint64_t                _first_reservation = 0;  /**< Number of the oldest open reservation. */
+
 		public:
 			/**
 			 * @brief Constructor for Webserver Client.
@@ -43,39 +81,71 @@ namespace Theater
 			~Client();
 			
 			/**
-			 * @brief Start listening for incoming requests.
+			 * @brief Read all pending data and handle the incoming requests.
+			 * @return False when the connection must be closed, true otherwise.
 			 */
-			void Listen();
+			bool onReadable() override;
 
 			/**
 			 * @brief Disconnect the client.
 			 */
-			void Disconnect();
+			void Disconnect() override;
+
+			/**
+			 * @brief Gets the number of requests handled for this client.
+			 * @return The number of requests.
+			 */
+			uint64_t GetNumRequests() const;
+
+			/**
+			 * @brief Get the last frames of this connection.
+			 * 
+			 * @return The frames, oldest first.
+			 */
+			std::vector<Theater::FlightRecorder::Frame> GetRecordedFrames() const { return this->_flight_recorder.Snapshot(); }
+
+			/**
+			 * @brief Gets the number of handled requests per action of all clients.
+			 * @return Map of action name to number of requests, including the "incomplete" and "unknown" requests.
+			 */
+			static std::map<std::string, uint64_t> GetRequestCounts();
 			
 			/**
-			 * @brief Sends a message with parameters to the client.
-			 * @param action The action to be performed.
-			 * @param parameter The parameters associated with the action.
-			 * @details Sends a message to the client with the specified action and parameters.
+			 * @brief Sends a response to the client.
+			 * @param message The response, one of the schemas in Theater::Response.
+			 * @details The response is encoded in the reused response buffer and queued on the socket.
+			 */
+			template<typename Message>
+			void Send(const Message& message) const
+			{
+				this->_response.clear();
+
+				this->_Send(this->_response, message);
+			}
+
+			/**
+			 * @brief Reserve the place of a response that is only known later.
+			 * @details Responses sent after the reservation are held till the reserved responses are
+			 * sent, so the client gets every response in the order of its requests.
+			 * @return The reservation.
 			 */
-			void Send(const std::string& action, const Theater::Parameter& parameter) const;
+			uint64_t ReserveResponse() const;
 
 			/**
-			 * @brief Sends a message with data to the client.
-			 * @param action The action to be performed.
-			 * @param data The data associated with the action.
-			 * @details Sends a message to the client with the specified action and data.
+			 * @brief Send the responses of a reservation, followed by the responses held behind it.
+			 * @param reservation The reservation, may be sent from any thread.
+			 * @param responses The encoded responses, none to only release the held responses.
 			 */
-			void Send(const std::string& action, const std::string& data) const;
+			void SendReserved(uint64_t reservation, std::vector<std::string> responses) const;
 
 			// Events
 			
 			/**
 			 * @brief Handles an incoming request.
 			 * @param request The incoming request to be handled.
-			 * @details Handles an incoming request received as a vector of unsigned characters.
+			 * @details Handles a single complete frame, header included.
 			 */
-			void onRequest(const std::vector<unsigned char>& request);
+			void onRequest(std::string_view request);
 			
 			// Requests
 			
@@ -87,7 +157,7 @@ namespace Theater
 			 * - Client sends:    CONN.......0 PROT=1 PROD=MOH3-PS2 VERS=2003.1.0.
 			 * - Server responds: CONN.......dNUM-CHALLENGES=0.
 			 */
-            void requestCONN(const Theater::Parameter& parameter);
+            void requestCONN(const Theater::ParameterView& parameter);
 			
 			/**
 			 * @brief Processes a user request with the specified parameters.
@@ -97,7 +167,7 @@ namespace Theater
 			 * - Client sends:    USER.......ZCRC=10dc UID=b9ae75b4a39dbd70acab076760aec09d72257f3ec059517b9fa03a8aebf6187a.
 			 * - Server responds: USER........TICKET="1111".
 			 */
-			void requestUSER(const Theater::Parameter& parameter);
+			void requestUSER(const Theater::ParameterView& parameter);
 			
 			/**
 			 * @brief Processes a profile request with the specified parameters.
@@ -107,7 +177,7 @@ namespace Theater
 			 * - Client sends:    PROF........TEXT="PLAYER1".
 			 * - Server responds: PROF.......!CLEAN-TEXT="PLAYER1".
 			 */
-			void requestPROF(const Theater::Parameter& parameter);
+			void requestPROF(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a list of live streams request with the specified parameters.
@@ -118,7 +188,7 @@ namespace Theater
 			 * - Server responds: LLST....... NUM-LOBBIES=1 TID=1.
 			 *                    LDAT.......dFAVORITE-GAMES=0 FAVORITE-PLAYERS=0 LOBBY-ID=1 LOCALE=1 NAME="Europe" NUM-GAMES=0 TID=1.
 			 */
-			void requestLLST(const Theater::Parameter& parameter);
+			void requestLLST(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a global list of streams request with the specified parameters.
@@ -129,7 +199,7 @@ namespace Theater
 			 * - Server responds: GLST.......)LOBBY-ID=1 NUM-GAMES=1 TID=2.
 			 *                    GDAT.......{FAVORITE=0 GAME-ID=1 IP="1.2.3.4" MAX-PLAYERS=8 NAME="Server" NUM-FAV-PLAYERS=0 NUM-PLAYERS=1 PORT=28500 TID=2.
 			 */
-			void requestGLST(const Theater::Parameter& parameter);
+			void requestGLST(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a recommended list of streams request with the specified parameters.
@@ -140,7 +210,7 @@ namespace Theater
 			 * - Server responds: RLST....... NUM-REGIONS=8 TID=1.
 			 *                    RDAT.......OLOCALE=0 NAME="Europe" NUM-GAMES=0 NUM-PLAYERS=0 REGION-ID=1 TID=1.
 			 */
-			void requestRLST(const Theater::Parameter& parameter);
+			void requestRLST(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a create game request with the specified parameters.
@@ -150,7 +220,7 @@ namespace Theater
 			 * - Client sends:    CGAM.......JREGION-ID=1 NAME="Server" MAX-PLAYERS=8 HOST-PLAYER="PLAYER1".
 			 * - Server responds: CGAM.......!GAME-ID=1 LOBBY-ID=1.
 			 */
-			void requestCGAM(const Theater::Parameter& parameter);
+			void requestCGAM(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes an update game request with the specified parameters.
@@ -159,7 +229,7 @@ namespace Theater
 			 * The protocol for the update game request is as follows:
 			 * - Client sends: UGAM.......sLOBBY-ID=1 GAME-ID=1 NAME="Server" NUM-PLAYERS=1 MAX-PLAYERS=8 PLAYER-NAME.1="PLAYER1" TICKET.1="1111".
 			 */
-			void requestUGAM(const Theater::Parameter& parameter);
+			void requestUGAM(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a remove game request with the specified parameters.
@@ -168,7 +238,7 @@ namespace Theater
 			 * The protocol for the remove game request is as follows:
 			 * - Client sends: RGAM.......!LOBBY-ID=1 GAME-ID=1.
 			 */
-			void requestRGAM(const Theater::Parameter& parameter);
+			void requestRGAM(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a file request with the specified parameters.
@@ -179,7 +249,7 @@ namespace Theater
 			 * - Server responds: FILE........NUM-CHUNKS=1 TID=1 TYPE=moh3/tos/.
 			 *                    FCHU........DATA="<your data>" (Data can be max 2047 bytes).
 			 */
-			void requestFILE(const Theater::Parameter& parameter);
+			void requestFILE(const Theater::ParameterView& parameter);
 
 			/**
 			 * @brief Processes a ping request with the specified parameters.
@@ -189,43 +259,67 @@ namespace Theater
 			 * - Client sends: PING........
 			 * - Server responds: PONG........
 			 */
-			void requestPING(const Theater::Parameter& parameter);
+			void requestPING(const Theater::ParameterView& parameter);
 
 		private:
 			/**
 			 * @brief Log a transaction.
 			 * 
-			 * This function logs a transaction with the specified direction and response.
+			 * This function logs a transaction with the specified direction and frame.
+			 * The frame is formatted by the logger thread, nothing is done when transaction logging is disabled.
 			 * 
-			 * @param direction The direction of the transaction ("<--" or "-->").
-			 * @param response The response to log.
+			 * @param direction Request or response, only turned into an arrow for the text log.
+			 * @param frame The raw request or response.
 			 */
-			void _LogTransaction(const std::string& direction, const std::string& response) const;
-		
-		public:
+			void _LogTransaction(Theater::TransactionLogFormat::Direction direction, std::string_view frame) const;
+
+
 			/**
-			 * @brief Heartbeat function to manage client connections.
-			 *
-			 * This function periodically checks for client connections and closes
-			 * connections that have not sent any data in the last minute.
+			 * @brief Queue an encoded response and log it, or hold it behind an open reservation.
+			 * @param response The encoded response, header included.
 			 */
-			static void Heartbeat();
-			
+			void _Send(std::string_view response) const;
+
 			/**
-			 * @brief Parses the provided data into a Parameter map.
-			 * @param data The data to be parsed into parameters.
-			 * @return A Parameter map parsed from the provided data.
-			 * @details Parses the provided data into a map of parameters.
+			 * @brief Queue an encoded response on the socket and log it.
+			 * @param response The encoded response, header included.
+			 * @details The reservations lock must be held.
 			 */
-			static Parameter GetParameter(const std::string& data);
-			
+			void _Queue(std::string_view response) const;
+
+			/**
+			 * @brief Encode a response in a buffer, then queue and log it.
+			 * @param buffer The buffer to append the response to, another thread than the one driving
+			 * the client must not use the reused response buffer.
+			 * @param message The response, one of the schemas in Theater::Response.
+			 */
+			template<typename Message>
+			void _Send(std::vector<unsigned char>& buffer, const Message& message) const
+			{
+				Theater::Encoder encoder(buffer);
+
+				encoder.Begin(Message::ACTION);
+				message.Encode(encoder);
+
+				this->_Send(encoder.End());
+			}
+
 			/**
-			 * @brief Converts the provided Parameter map into a string.
-			 * @param parameter The Parameter map to be converted into a string.
-			 * @return A string representation of the Parameter map.
-			 * @details Converts the provided Parameter map into a string format.
+			 * @brief Encode a response for a reservation.
+			 * @param message The response, one of the schemas in Theater::Response.
+			 * @return The encoded response, header included.
 			 */
-			static std::string GetData(const Theater::Parameter& parameter);
+			template<typename Message>
+			static std::string _Encode(const Message& message)
+			{
+				std::vector<unsigned char> buffer;
+				Theater::Encoder encoder(buffer);
+
+				encoder.Begin(Message::ACTION);
+				message.Encode(encoder);
+
+				return std::string(encoder.End());
+			}
 	};
 }
 
@@ -0,0 +1,101 @@
+#include <charconv>
+
+#include <theater/client.h>
+
+#include <theater/encoder.h>
+
+Theater::Encoder::Encoder(std::vector<unsigned char>& buffer) : _buffer(buffer)
+{
+
+}
+
+void Theater::Encoder::Begin(std::string_view action)
+{
+	this->_start = this->_buffer.size();
+	this->_empty = true;
+
+	// Action followed by zeros, the size is filled in by End()
+	this->_buffer.resize(this->_start + Theater::HEADER_SIZE, 0x00);
+	std::copy(action.begin(), action.begin() + 4, this->_buffer.begin() + this->_start);
+}
+
+void Theater::Encoder::Add(const Theater::Field& field, std::string_view value)
+{
+	this->_AddKey(field);
+
+	if(field.quoted)
+	{
+		this->_buffer.push_back('"');
+		this->_Append(value);
+		this->_buffer.push_back('"');
+	}
+	else
+	{
+		this->_Append(value);
+	}
+}
+
+void Theater::Encoder::Add(const Theater::Field& field, int64_t value)
+{
+	char digits[24];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+	this->Add(field, std::string_view(digits, result.ptr - digits));
+}
+
+void Theater::Encoder::AddEncoded(std::string_view fields)
+{
+	if(fields.empty())
+	{
+		return;
+	}
+
+	if(!this->_empty)
+	{
+		this->_buffer.push_back(' ');
+	}
+
+	this->_empty = false;
+
+	this->_Append(fields);
+}
+
+std::string_view Theater::Encoder::End()
+{
+	// Data ends with 0x00, a response without data is only the header
+	if(!this->_empty)
+	{
+		this->_buffer.push_back(0x00);
+	}
+
+	uint32_t size = this->_buffer.size() - this->_start;
+	unsigned char* header = this->_buffer.data() + this->_start;
+
+	// Byte 9 till 12 contain the size of the response
+	header[8] = (size >> 24) & 0xFF;
+	header[9] = (size >> 16) & 0xFF;
+	header[10] = (size >> 8) & 0xFF;
+	header[11] = size & 0xFF;
+
+	return std::string_view(reinterpret_cast<const char*>(header), size);
+}
+
+// Private functions
+
+void Theater::Encoder::_AddKey(const Theater::Field& field)
+{
+	if(!this->_empty)
+	{
+		this->_buffer.push_back(' ');
+	}
+
+	this->_empty = false;
+
+	this->_Append(field.key);
+	this->_buffer.push_back('=');
+}
+
+void Theater::Encoder::_Append(std::string_view data)
+{
+	this->_buffer.insert(this->_buffer.end(), data.begin(), data.end());
+}
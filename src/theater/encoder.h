@@ -0,0 +1,108 @@
+#ifndef THEATER_ENCODER_H
+#define THEATER_ENCODER_H
+
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace Theater
+{
+	/**
+	 * @brief Key of a field in a response and whether its value is sent between quotes.
+	 */
+	struct Field
+	{
+		std::string_view key;    /**< Key of the field. */
+		bool             quoted; /**< Value is sent between quotes. */
+	};
+
+	/**
+	 * @brief Check if the keys of a schema are in alphabetical order.
+	 * @param fields The fields of the schema.
+	 * @return True if every key sorts after the previous one.
+	 * @details The client expects the keys in the order the old std::map based responses used.
+	 */
+	template<typename Fields>
+	constexpr bool IsSorted(const Fields& fields)
+	{
+		for(size_t i = 1; i < fields.size(); i++)
+		{
+			if(!(fields[i - 1].key < fields[i].key))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @class Encoder
+	 * @brief Writes a Theater response straight into an output buffer.
+	 * @details The header is written first with an empty size that is filled in by End(), so the
+	 * response is built in a single pass. The buffer is owned by the caller and keeps its capacity
+	 * between responses, so after the first few responses no memory is allocated anymore.
+	 * Fields added without Begin() and End() form a fragment that can later be added with AddEncoded().
+	 */
+	class Encoder
+	{
+		private:
+			std::vector<unsigned char>& _buffer;        /**< Output buffer. */
+			size_t                      _start = 0;     /**< Start of the current response. */
+			bool                        _empty = true;  /**< No field was added to the current response. */
+
+		public:
+			/**
+			 * @brief Constructor for Encoder.
+			 * @param buffer The buffer the responses are appended to.
+			 */
+			explicit Encoder(std::vector<unsigned char>& buffer);
+
+			/**
+			 * @brief Start a response.
+			 * @param action The 4 byte action of the response.
+			 */
+			void Begin(std::string_view action);
+
+			/**
+			 * @brief Add a field with a text value.
+			 * @param field The field.
+			 * @param value The value, quotes are added when the field is quoted.
+			 */
+			void Add(const Theater::Field& field, std::string_view value);
+
+			/**
+			 * @brief Add a field with an integer value.
+			 * @param field The field.
+			 * @param value The value.
+			 */
+			void Add(const Theater::Field& field, int64_t value);
+
+			/**
+			 * @brief Add fields that were encoded before.
+			 * @param fields The encoded KEY=VALUE pairs, for example from a cache.
+			 */
+			void AddEncoded(std::string_view fields);
+
+			/**
+			 * @brief Finish the response and fill in its size.
+			 * @return The complete response, valid until the buffer is changed.
+			 */
+			std::string_view End();
+
+		private:
+			/**
+			 * @brief Write the separator and the key of a field.
+			 * @param field The field.
+			 */
+			void _AddKey(const Theater::Field& field);
+
+			/**
+			 * @brief Append bytes to the buffer.
+			 * @param data The bytes.
+			 */
+			void _Append(std::string_view data);
+	};
+}
+
+#endif // THEATER_ENCODER_H
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include <util.h>
+
+#include <theater/flight_recorder.h>
+
+/**
+ * @brief Global header of a nanosecond pcap file.
+ */
+struct PcapHeader
+{
+	uint32_t magic = 0xa1b23c4d;
+	uint16_t version_major = 2;
+	uint16_t version_minor = 4;
+	int32_t  thiszone = 0;
+	uint32_t sigfigs = 0;
+	uint32_t snaplen = 0;
+	uint32_t network = 147; /**< LINKTYPE_USER0 */
+};
+
+/**
+ * @brief Header of every packet in a pcap file.
+ */
+struct PcapRecord
+{
+	uint32_t seconds;
+	uint32_t nanoseconds;
+	uint32_t captured;
+	uint32_t length;
+};
+
+/**
+ * @brief Start of every packet, tells the connection and direction of the frame.
+ */
+struct PcapPseudoHeader
+{
+	uint64_t connection;
+	uint8_t  direction;
+	uint8_t  reserved[7];
+};
+
+Theater::FlightRecorder::FlightRecorder(size_t capacity, size_t snap_length) : _capacity(capacity), _snap_length(snap_length)
+{
+
+}
+
+Theater::FlightRecorder::~FlightRecorder()
+{
+	delete this->_ring.load(std::memory_order_acquire);
+}
+
+void Theater::FlightRecorder::Record(uint64_t connection, Theater::TransactionLogFormat::Direction direction, std::string_view frame)
+{
+	Ring* ring = this->_GetRing();
+	uint64_t position = this->_head.fetch_add(1, std::memory_order_relaxed);
+	size_t index = position & (this->_capacity - 1);
+	Slot& slot = ring->slots[index];
+
+	// Readers that see the odd sequence skip the slot till it is complete
+	slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	slot.connection = connection;
+	slot.length = static_cast<uint32_t>(frame.size());
+	slot.captured = static_cast<uint32_t>(std::min(frame.size(), this->_snap_length));
+	slot.direction = direction;
+	std::memcpy(ring->data.get() + index * this->_snap_length, frame.data(), slot.captured);
+
+	slot.sequence.store(2 * position + 2, std::memory_order_release);
+}
+
+std::vector<Theater::FlightRecorder::Frame> Theater::FlightRecorder::Snapshot(uint64_t connection) const
+{
+	std::vector<Frame> frames;
+	const Ring* ring = this->_ring.load(std::memory_order_acquire);
+
+	// Nothing was recorded yet
+	if(ring == nullptr)
+	{
+		return frames;
+	}
+
+	uint64_t head = this->_head.load(std::memory_order_acquire);
+	uint64_t position = (head > this->_capacity) ? head - this->_capacity : 0;
+
+	frames.reserve(head - position);
+
+	for(; position < head; position++)
+	{
+		size_t index = position & (this->_capacity - 1);
+		const Slot& slot = ring->slots[index];
+		uint64_t expected = 2 * position + 2;
+
+		if(slot.sequence.load(std::memory_order_acquire) != expected)
+		{
+			continue;
+		}
+
+		Frame frame;
+		frame.time = slot.time;
+		frame.connection = slot.connection;
+		frame.length = slot.length;
+		frame.direction = slot.direction;
+
+		// A torn size is thrown away below, it must not read past the slot
+		size_t captured = std::min<size_t>(slot.captured, this->_snap_length);
+		frame.data.assign(reinterpret_cast<const char*>(ring->data.get() + index * this->_snap_length), captured);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// Overwritten by a newer frame while copying
+		if(slot.sequence.load(std::memory_order_relaxed) != expected)
+		{
+			continue;
+		}
+
+		if(connection == 0 || frame.connection == connection)
+		{
+			frames.push_back(std::move(frame));
+		}
+	}
+
+	return frames;
+}
+
+bool Theater::FlightRecorder::WritePcap(const std::string& path, const std::vector<Frame>& frames)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	PcapHeader header;
+	header.snaplen = sizeof(PcapPseudoHeader);
+
+	for(const Frame& frame : frames)
+	{
+		header.snaplen = std::max(header.snaplen, static_cast<uint32_t>(sizeof(PcapPseudoHeader) + frame.data.size()));
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for(const Frame& frame : frames)
+	{
+		PcapRecord record;
+		record.seconds = static_cast<uint32_t>(frame.time / 1000000000);
+		record.nanoseconds = static_cast<uint32_t>(frame.time % 1000000000);
+		record.captured = static_cast<uint32_t>(sizeof(PcapPseudoHeader) + frame.data.size());
+		record.length = sizeof(PcapPseudoHeader) + frame.length;
+
+		PcapPseudoHeader pseudo_header = {};
+		pseudo_header.connection = frame.connection;
+		pseudo_header.direction = static_cast<uint8_t>(frame.direction);
+
+		file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+		file.write(reinterpret_cast<const char*>(&pseudo_header), sizeof(pseudo_header));
+		file.write(frame.data.data(), frame.data.size());
+	}
+
+	return file.good();
+}
+
+std::string Theater::FlightRecorder::GetDumpPath(const std::string& name)
+{
+	return "../data/log/flight-" + name + "-" + Util::Time::GetNowDateTime("%Y%m%d-%H%M%S") + ".pcap";
+}
+
+// Private functions
+
+Theater::FlightRecorder::Ring* Theater::FlightRecorder::_GetRing()
+{
+	Ring* ring = this->_ring.load(std::memory_order_acquire);
+
+	if(ring != nullptr)
+	{
+		return ring;
+	}
+
+	// Only connections that send frames pay for a ring
+	Ring* created = new Ring();
+	created->slots = std::make_unique<Slot[]>(this->_capacity);
+	created->data = std::make_unique<unsigned char[]>(this->_capacity * this->_snap_length);
+
+	// Another thread recorded the first frame at the same time
+	if(!this->_ring.compare_exchange_strong(ring, created, std::memory_order_acq_rel, std::memory_order_acquire))
+	{
+		delete created;
+		return ring;
+	}
+
+	return created;
+}
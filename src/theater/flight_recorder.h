@@ -0,0 +1,153 @@
+#ifndef THEATER_FLIGHT_RECORDER_H
+#define THEATER_FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include <theater/transaction_log.h>
+
+namespace Theater
+{
+	/**
+	 * @brief Keeps the most recent Theater frames in memory.
+	 *
+	 * Recording claims the next slot with a single atomic add and copies the frame in, it never locks.
+	 * The ring is allocated by the first recorded frame, after that recording never allocates. Frames
+	 * longer than the snap length are cut, like a packet capture, the original length is kept. Every
+	 * slot carries a sequence number so a reader can tell whether the frame in it is complete, nothing
+	 * is paid for readers until somebody dumps the ring.
+	 *
+	 * A ring takes capacity * (64 + snap length) bytes. Every connection has its own ring of
+	 * CONNECTION_CAPACITY frames cut at CONNECTION_SNAP_LENGTH bytes, that is 6 KB per connection
+	 * that sent a frame and nothing for one that did not.
+	 */
+	class FlightRecorder
+	{
+		public:
+			/**
+			 * @brief Number of bytes kept of every frame in the global ring.
+			 */
+			static constexpr size_t SNAP_LENGTH = 512;
+
+			/**
+			 * @brief Number of bytes kept of every frame of a connection, the header and the first parameters.
+			 */
+			static constexpr size_t CONNECTION_SNAP_LENGTH = 128;
+
+			/**
+			 * @brief Number of frames kept of every connection.
+			 */
+			static constexpr size_t CONNECTION_CAPACITY = 32;
+
+			/**
+			 * @brief Number of frames kept of all connections together.
+			 */
+			static constexpr size_t GLOBAL_CAPACITY = 4096;
+
+			/**
+			 * @brief A recorded frame.
+			 */
+			struct Frame
+			{
+				uint64_t      time;              /**< Nanoseconds since the epoch. */
+				uint64_t      connection;        /**< Handle of the connection. */
+				uint32_t      length;            /**< Length of the frame. */
+				Theater::TransactionLogFormat::Direction direction; /**< Direction of the frame. */
+				std::string   data;              /**< Start of the frame, at most the snap length. */
+			};
+
+		private:
+			/**
+			 * @brief A position in the ring, the captured bytes are in the data of the ring.
+			 */
+			struct alignas(64) Slot
+			{
+				std::atomic<uint64_t> sequence{0}; /**< Odd while the frame is written, 2 * position + 2 once it is complete. */
+				uint64_t              time;        /**< Nanoseconds since the epoch. */
+				uint64_t              connection;  /**< Handle of the connection. */
+				uint32_t              length;      /**< Length of the frame. */
+				uint32_t              captured;    /**< Bytes of the frame in the data of the slot. */
+				Theater::TransactionLogFormat::Direction direction; /**< Direction of the frame. */
+			};
+
+			/**
+			 * @brief The memory of the ring, allocated by the first frame.
+			 */
+			struct Ring
+			{
+				std::unique_ptr<Slot[]>          slots; /**< The slots. */
+				std::unique_ptr<unsigned char[]> data;  /**< Snap length bytes for every slot. */
+			};
+
+			std::atomic<Ring*>      _ring{nullptr}; /**< The ring, empty till the first frame. */
+			size_t                  _capacity;      /**< Number of slots, a power of two. */
+			size_t                  _snap_length;   /**< Bytes kept of every frame. */
+			std::atomic<uint64_t>   _head{0};       /**< Next position to record. */
+
+		public:
+			/**
+			 * @brief Create a ring, its memory is allocated by the first frame.
+			 * @param capacity The number of frames to keep, a power of two.
+			 * @param snap_length The number of bytes kept of every frame.
+			 */
+			explicit FlightRecorder(size_t capacity, size_t snap_length = SNAP_LENGTH);
+
+			/**
+			 * @brief Free the ring.
+			 */
+			~FlightRecorder();
+
+			FlightRecorder(const FlightRecorder&) = delete;
+			FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+			/**
+			 * @brief Record a frame.
+			 * @param connection The handle of the connection.
+			 * @param direction The direction of the frame.
+			 * @param frame The raw frame, header included.
+			 */
+			void Record(uint64_t connection, Theater::TransactionLogFormat::Direction direction, std::string_view frame);
+
+			/**
+			 * @brief Copy the frames in the ring, oldest first.
+			 * @details Frames that are overwritten while copying are left out.
+			 * @param connection Only copy frames of this connection, 0 for all frames.
+			 * @return The frames.
+			 */
+			std::vector<Frame> Snapshot(uint64_t connection = 0) const;
+
+			/**
+			 * @brief Write frames to a capture file.
+			 *
+			 * The file is a nanosecond pcap file with link type USER0. Every packet starts with a 16 byte
+			 * pseudo header, the little-endian connection handle, the direction (0 request, 1 response) and
+			 * 7 reserved bytes, followed by the captured bytes of the frame. The snap length of the file is
+			 * that of the longest captured frame.
+			 *
+			 * @param path The path of the file.
+			 * @param frames The frames.
+			 * @return True if the file was written.
+			 */
+			static bool WritePcap(const std::string& path, const std::vector<Frame>& frames);
+
+			/**
+			 * @brief Get the path for a capture file in the log directory.
+			 * @param name Describes what was captured.
+			 * @return The path.
+			 */
+			static std::string GetDumpPath(const std::string& name);
+
+		private:
+			/**
+			 * @brief Get the ring, allocate it if this is the first frame.
+			 * @return The ring.
+			 */
+			Ring* _GetRing();
+	};
+}
+
+#endif // THEATER_FLIGHT_RECORDER_H
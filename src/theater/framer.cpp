@@ -0,0 +1,74 @@
+#include <cstring>
+
+#include <theater/client.h>
+
+#include <theater/framer.h>
+
+Theater::Framer::Framer() : _buffer(Theater::MAX_FRAME_SIZE * 2, 0)
+{
+
+}
+
+unsigned char* Theater::Framer::GetWriteBuffer(size_t& size)
+{
+	// Everything is framed, start over at the beginning
+	if(this->_head == this->_tail)
+	{
+		this->_head = 0;
+		this->_tail = 0;
+	}
+	// Not enough room for a full frame, wrap the unfinished tail to the start
+	else if(this->_buffer.size() - this->_tail < Theater::MAX_FRAME_SIZE)
+	{
+		size_t pending = this->_tail - this->_head;
+
+		std::memmove(&(this->_buffer[0]), &(this->_buffer[this->_head]), pending);
+
+		this->_head = 0;
+		this->_tail = pending;
+	}
+
+	size = this->_buffer.size() - this->_tail;
+
+	return &(this->_buffer[this->_tail]);
+}
+
+void Theater::Framer::Commit(size_t size)
+{
+	this->_tail += size;
+}
+
+Theater::Framer::Result Theater::Framer::Next(std::string_view& frame)
+{
+	size_t pending = this->_tail - this->_head;
+
+	if(pending < Theater::HEADER_SIZE)
+	{
+		return Result::Incomplete;
+	}
+
+	const unsigned char* header = &(this->_buffer[this->_head]);
+
+	// Byte 9 till 12 contain the size of the frame
+	uint32_t frame_size = 0;
+	frame_size |= static_cast<uint32_t>(header[8]) << 24;
+	frame_size |= static_cast<uint32_t>(header[9]) << 16;
+	frame_size |= static_cast<uint32_t>(header[10]) << 8;
+	frame_size |= static_cast<uint32_t>(header[11]);
+
+	if(frame_size < Theater::HEADER_SIZE || frame_size > Theater::MAX_FRAME_SIZE)
+	{
+		return Result::Invalid;
+	}
+
+	if(pending < frame_size)
+	{
+		return Result::Incomplete;
+	}
+
+	frame = std::string_view(reinterpret_cast<const char*>(header), frame_size);
+
+	this->_head += frame_size;
+
+	return Result::Frame;
+}
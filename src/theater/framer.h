@@ -0,0 +1,69 @@
+#ifndef THEATER_FRAMER_H
+#define THEATER_FRAMER_H
+
+#include <vector>
+#include <string_view>
+
+namespace Theater
+{
+	/**
+	 * @brief Maximum size of a single frame, header included.
+	 */
+	const size_t MAX_FRAME_SIZE = 8192;
+
+	/**
+	 * @class Framer
+	 * @brief Splits the Theater byte stream into frames using the length in the header.
+	 * @details Every frame starts with a 12 byte header where bytes 8 till 11 hold the big-endian
+	 * size of the whole frame. Data is read straight into the framer, complete frames are handed
+	 * out as views into that memory and only the unfinished tail of the last read is kept.
+	 * When the write position runs out of room the tail wraps back to the start of the buffer,
+	 * so complete frames are never copied.
+	 */
+	class Framer
+	{
+		public:
+			/**
+			 * @brief Result of extracting the next frame.
+			 */
+			enum Result
+			{
+				Frame,      /**< A complete frame was extracted. */
+				Incomplete, /**< More data is needed for the next frame. */
+				Invalid,    /**< The header holds a size that can never be valid. */
+			};
+
+		private:
+			std::vector<unsigned char> _buffer;     /**< Receive buffer. */
+			size_t                     _head = 0;   /**< Start of the data that is not framed yet. */
+			size_t                     _tail = 0;   /**< End of the received data. */
+
+		public:
+			Framer();
+
+			/**
+			 * @brief Get the free space to read new data into.
+			 * @param size[out] The number of bytes that can be written.
+			 * @return Pointer to the start of the free space.
+			 * @details Invalidates the frames handed out by Next().
+			 */
+			unsigned char* GetWriteBuffer(size_t& size);
+
+			/**
+			 * @brief Mark bytes written into the write buffer as received.
+			 * @param size The number of bytes received.
+			 */
+			void Commit(size_t size);
+
+			/**
+			 * @brief Extract the next complete frame.
+			 * @param frame[out] View of the frame including its header.
+			 * @return Frame when a frame was extracted, Incomplete when more data is needed,
+			 *         Invalid when the stream can not be framed anymore.
+			 * @details The view stays valid until the next call to GetWriteBuffer().
+			 */
+			Result Next(std::string_view& frame);
+	};
+}
+
+#endif // THEATER_FRAMER_H
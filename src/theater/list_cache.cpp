@@ -0,0 +1,151 @@
+#include <globals.h>
+#include <mohrs/matchmaker.h>
+#include <theater/encoder.h>
+#include <theater/messages.h>
+
+#include <theater/list_cache.h>
+
+std::shared_ptr<const Theater::ListCache::Region> Theater::ListCache::Get(MoHRS::Regions region)
+{
+	return this->_Get(this->_regions, region, [region](const std::shared_ptr<const MoHRS::RegionSnapshot>& snapshot)
+	{
+		return Theater::ListCache::_BuildRegion(region, snapshot);
+	});
+}
+
+std::shared_ptr<const Theater::ListCache::GameList> Theater::ListCache::GetGames(MoHRS::Regions region)
+{
+	return this->_Get(this->_games, region, &Theater::ListCache::_BuildGames);
+}
+
+uint64_t Theater::ListCache::GetHits() const
+{
+	return this->_hits;
+}
+
+uint64_t Theater::ListCache::GetMisses() const
+{
+	return this->_misses;
+}
+
+// Private functions
+
+template<typename Entry, typename Build>
+std::shared_ptr<const Entry> Theater::ListCache::_Get(std::array<std::shared_ptr<const Entry>, MoHRS::NUM_REGIONS>& entries,
+	MoHRS::Regions region, Build&& build)
+{
+	size_t index = MoHRS::GetRegionIndex(region);
+	std::shared_ptr<const MoHRS::RegionSnapshot> snapshot = g_matchmaker->GetSnapshot(region);
+
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // list cache lock
+
+		if(entries[index] && entries[index]->snapshot->version == snapshot->version)
+		{
+			this->_hits++;
+
+			return entries[index];
+		}
+	}
+
+	this->_misses++;
+
+	// Encode outside the lock, so clients that hit other regions don't wait
+	std::shared_ptr<const Entry> cached = build(snapshot);
+
+	{
+		std::lock_guard<std::mutex> guard(this->_mutex); // list cache lock
+
+		// Two clients can miss at the same time, keep the newest version
+		if(!entries[index] || entries[index]->snapshot->version < snapshot->version)
+		{
+			entries[index] = cached;
+		}
+	}
+
+	return cached;
+}
+
+std::shared_ptr<const Theater::ListCache::Region> Theater::ListCache::_BuildRegion(MoHRS::Regions region, const std::shared_ptr<const MoHRS::RegionSnapshot>& snapshot)
+{
+	std::shared_ptr<Region> cached = std::make_shared<Region>();
+	std::vector<unsigned char> buffer;
+
+	cached->snapshot = snapshot;
+
+	const std::string& name = MoHRS::RegionNames.at(region);
+	int64_t num_games = static_cast<int64_t>(snapshot->games.size());
+
+	// Lobby
+	{
+		Theater::Encoder encoder(buffer);
+		Theater::Response::LDAT ldat;
+		ldat.lobby_id = static_cast<int8_t>(region);
+		ldat.locale = 1;
+		ldat.name = name;
+		ldat.num_games = num_games;
+
+		ldat.EncodeLobby(encoder);
+		cached->lobby.assign(buffer.begin(), buffer.end());
+		buffer.clear();
+	}
+
+	// Region
+	{
+		Theater::Encoder encoder(buffer);
+		Theater::Response::RDAT rdat;
+		rdat.locale = 0;
+		rdat.name = name;
+		rdat.num_games = num_games;
+		rdat.num_players = static_cast<int64_t>(snapshot->num_players);
+		rdat.region_id = static_cast<int8_t>(region);
+
+		rdat.EncodeRegion(encoder);
+		cached->region.assign(buffer.begin(), buffer.end());
+	}
+
+	return cached;
+}
+
+std::shared_ptr<const Theater::ListCache::GameList> Theater::ListCache::_BuildGames(const std::shared_ptr<const MoHRS::RegionSnapshot>& snapshot)
+{
+	std::shared_ptr<GameList> cached = std::make_shared<GameList>();
+	std::vector<unsigned char> buffer;
+
+	cached->snapshot = snapshot;
+	cached->games.reserve(snapshot->games.size());
+
+	for(const MoHRS::GamePtr& game : snapshot->games)
+	{
+		Theater::ListCache::Game encoded_game;
+		std::string ip = game->GetIpString();
+
+		Theater::Response::GDAT gdat;
+		gdat.game_id = game->GetId();
+		gdat.ip = ip;
+		gdat.max_players = game->GetMaxPlayers();
+		gdat.name = game->GetName();
+		gdat.num_players = game->GetNumPlayers();
+		gdat.port = 28500;
+
+		{
+			Theater::Encoder encoder(buffer);
+
+			gdat.EncodeServer(encoder);
+			encoded_game.server.assign(buffer.begin(), buffer.end());
+			buffer.clear();
+		}
+
+		{
+			Theater::Encoder encoder(buffer);
+
+			gdat.EncodeStatus(encoder);
+			encoded_game.status.assign(buffer.begin(), buffer.end());
+			buffer.clear();
+		}
+
+		cached->games.push_back(std::move(encoded_game));
+	}
+
+	return cached;
+}
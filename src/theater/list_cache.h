@@ -0,0 +1,124 @@
+#ifndef THEATER_LIST_CACHE_H
+#define THEATER_LIST_CACHE_H
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mohrs/game.h>
+#include <mohrs/region.h>
+#include <mohrs/matchmaker.h>
+
+namespace Theater
+{
+	/**
+	 * @class ListCache
+	 * @brief Cache of the encoded LDAT, RDAT and GDAT fields of every region.
+	 * @details Most clients that browse the same region get the same responses, only the TID and the
+	 * favorite counts differ. The fields that are the same for every client are encoded once per version
+	 * of the region. When the matchmaker publishes a new snapshot of a region, the region is encoded
+	 * again on the next request, so a list request is mostly copying the cached fields.
+	 * The lobby and region fields only depend on the totals of the region and are cached apart from
+	 * the games, so LLST and RLST never encode the games of a region.
+	 */
+	class ListCache
+	{
+		public:
+			/**
+			 * @brief Encoded fields of a game.
+			 */
+			struct Game
+			{
+				std::string server; /**< Encoded by GDAT::EncodeServer(). */
+				std::string status; /**< Encoded by GDAT::EncodeStatus(). */
+			};
+
+			/**
+			 * @brief Encoded fields of a region at a single version.
+			 */
+			struct Region
+			{
+				std::shared_ptr<const MoHRS::RegionSnapshot> snapshot; /**< Snapshot of the region that was encoded. */
+				std::string                                  lobby;    /**< Encoded by LDAT::EncodeLobby(). */
+				std::string                                  region;   /**< Encoded by RDAT::EncodeRegion(). */
+			};
+
+			/**
+			 * @brief Encoded games of a region at a single version.
+			 */
+			struct GameList
+			{
+				std::shared_ptr<const MoHRS::RegionSnapshot> snapshot; /**< Snapshot of the region that was encoded. */
+				std::vector<Game>                            games;    /**< The encoded games, same order as the snapshot. */
+			};
+
+		private:
+			std::array<std::shared_ptr<const Region>, MoHRS::NUM_REGIONS>   _regions; /**< Latest encoded version of every region. */
+			std::array<std::shared_ptr<const GameList>, MoHRS::NUM_REGIONS> _games;   /**< Latest encoded games of every region. */
+			mutable std::mutex                                              _mutex;   /**< Guards _regions and _games. */
+
+			std::atomic<uint64_t> _hits{0};   /**< Requests served from the cache. */
+			std::atomic<uint64_t> _misses{0}; /**< Requests that encoded the region again. */
+
+		public:
+			/**
+			 * @brief Get the encoded fields of a region.
+			 * @param region The region.
+			 * @return The encoded fields of the current version of the region.
+			 * @details The region is encoded again when its version in the matchmaker changed.
+			 */
+			std::shared_ptr<const Region> Get(MoHRS::Regions region);
+
+			/**
+			 * @brief Get the encoded games of a region.
+			 * @param region The region.
+			 * @return The encoded games of the current version of the region.
+			 * @details The games are encoded again when the version of the region in the matchmaker changed.
+			 */
+			std::shared_ptr<const GameList> GetGames(MoHRS::Regions region);
+
+			/**
+			 * @brief Get the number of requests served from the cache.
+			 * @return The number of hits.
+			 */
+			uint64_t GetHits() const;
+
+			/**
+			 * @brief Get the number of requests that encoded a region again.
+			 * @return The number of misses.
+			 */
+			uint64_t GetMisses() const;
+
+		private:
+			/**
+			 * @brief Get a cache entry of a region, encoding it again when it is out of date.
+			 * @param entries The cache entries of every region.
+			 * @param region The region.
+			 * @param build Called with the snapshot of the region to encode a new entry.
+			 * @return The entry of the current version of the region.
+			 */
+			template<typename Entry, typename Build>
+			std::shared_ptr<const Entry> _Get(std::array<std::shared_ptr<const Entry>, MoHRS::NUM_REGIONS>& entries,
+				MoHRS::Regions region, Build&& build);
+
+			/**
+			 * @brief Encode the lobby and region fields of a region.
+			 * @param region The region.
+			 * @param snapshot The snapshot of the region.
+			 * @return The encoded fields.
+			 */
+			static std::shared_ptr<const Region> _BuildRegion(MoHRS::Regions region, const std::shared_ptr<const MoHRS::RegionSnapshot>& snapshot);
+
+			/**
+			 * @brief Encode the games of a region.
+			 * @param snapshot The snapshot of the region.
+			 * @return The encoded games.
+			 */
+			static std::shared_ptr<const GameList> _BuildGames(const std::shared_ptr<const MoHRS::RegionSnapshot>& snapshot);
+	};
+}
+
+#endif // THEATER_LIST_CACHE_H
@@ -0,0 +1,389 @@
+#ifndef THEATER_MESSAGES_H
+#define THEATER_MESSAGES_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <theater/encoder.h>
+
+/**
+ * @namespace Theater::Response
+ * @brief Fixed schemas of the responses sent to the client.
+ * @details Every schema lists its fields in the order they are sent and whether the value is quoted.
+ * The order is checked at compile time, Encode() writes the values with the matching field.
+ */
+namespace Theater::Response
+{
+	struct CONN
+	{
+		static constexpr std::string_view ACTION = "CONN";
+		static constexpr std::array<Theater::Field, 2> FIELDS = {{
+			{ "IMPORTANT", false }, { "NUM-CHALLENGES", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		std::string_view important;
+		int64_t          num_challenges;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->important);
+			encoder.Add(FIELDS[1], this->num_challenges);
+		}
+	};
+
+	struct USER
+	{
+		static constexpr std::string_view ACTION = "USER";
+		static constexpr std::array<Theater::Field, 1> FIELDS = {{
+			{ "TICKET", true }
+		}};
+
+		std::string_view ticket;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->ticket);
+		}
+	};
+
+	struct PROF
+	{
+		static constexpr std::string_view ACTION = "PROF";
+		static constexpr std::array<Theater::Field, 1> FIELDS = {{
+			{ "CLEAN-TEXT", false }
+		}};
+
+		std::string_view clean_text; /**< Sent as received, quotes included. */
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->clean_text);
+		}
+	};
+
+	struct LLST
+	{
+		static constexpr std::string_view ACTION = "LLST";
+		static constexpr std::array<Theater::Field, 2> FIELDS = {{
+			{ "NUM-LOBBIES", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          num_lobbies;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->num_lobbies);
+			encoder.Add(FIELDS[1], this->tid);
+		}
+	};
+
+	struct LDAT
+	{
+		static constexpr std::string_view ACTION = "LDAT";
+		static constexpr std::array<Theater::Field, 7> FIELDS = {{
+			{ "FAVORITE-GAMES", false }, { "FAVORITE-PLAYERS", false }, { "LOBBY-ID", false }, { "LOCALE", false },
+			{ "NAME", true }, { "NUM-GAMES", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          favorite_games;
+		int64_t          favorite_players;
+		int64_t          lobby_id;
+		int64_t          locale;
+		std::string_view name;
+		int64_t          num_games;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->favorite_games);
+			encoder.Add(FIELDS[1], this->favorite_players);
+			this->EncodeLobby(encoder);
+			encoder.Add(FIELDS[6], this->tid);
+		}
+
+		/**
+		 * @brief Encode the fields that are the same for every client.
+		 */
+		void EncodeLobby(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[2], this->lobby_id);
+			encoder.Add(FIELDS[3], this->locale);
+			encoder.Add(FIELDS[4], this->name);
+			encoder.Add(FIELDS[5], this->num_games);
+		}
+	};
+
+	/**
+	 * @brief LDAT with the fields of the lobby taken from the list cache.
+	 */
+	struct CachedLDAT
+	{
+		static constexpr std::string_view ACTION = LDAT::ACTION;
+
+		int64_t          favorite_games;
+		int64_t          favorite_players;
+		std::string_view lobby; /**< Encoded by LDAT::EncodeLobby(). */
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(LDAT::FIELDS[0], this->favorite_games);
+			encoder.Add(LDAT::FIELDS[1], this->favorite_players);
+			encoder.AddEncoded(this->lobby);
+			encoder.Add(LDAT::FIELDS[6], this->tid);
+		}
+	};
+
+	struct GLST
+	{
+		static constexpr std::string_view ACTION = "GLST";
+		static constexpr std::array<Theater::Field, 3> FIELDS = {{
+			{ "LOBBY-ID", false }, { "NUM-GAMES", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		std::string_view lobby_id; /**< Sent as received. */
+		int64_t          num_games;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->lobby_id);
+			encoder.Add(FIELDS[1], this->num_games);
+			encoder.Add(FIELDS[2], this->tid);
+		}
+	};
+
+	struct GDAT
+	{
+		static constexpr std::string_view ACTION = "GDAT";
+		static constexpr std::array<Theater::Field, 9> FIELDS = {{
+			{ "FAVORITE", false }, { "GAME-ID", false }, { "IP", true }, { "MAX-PLAYERS", false }, { "NAME", true },
+			{ "NUM-FAV-PLAYERS", false }, { "NUM-PLAYERS", false }, { "PORT", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          favorite;
+		int64_t          game_id;
+		std::string_view ip;
+		int64_t          max_players;
+		std::string_view name;
+		int64_t          num_fav_players;
+		int64_t          num_players;
+		int64_t          port;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->favorite);
+			this->EncodeServer(encoder);
+			encoder.Add(FIELDS[5], this->num_fav_players);
+			this->EncodeStatus(encoder);
+			encoder.Add(FIELDS[8], this->tid);
+		}
+
+		/**
+		 * @brief Encode the fields of the server, the same for every client.
+		 */
+		void EncodeServer(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[1], this->game_id);
+			encoder.Add(FIELDS[2], this->ip);
+			encoder.Add(FIELDS[3], this->max_players);
+			encoder.Add(FIELDS[4], this->name);
+		}
+
+		/**
+		 * @brief Encode the status of the server, the same for every client.
+		 */
+		void EncodeStatus(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[6], this->num_players);
+			encoder.Add(FIELDS[7], this->port);
+		}
+	};
+
+	/**
+	 * @brief GDAT with the fields of the server taken from the list cache.
+	 */
+	struct CachedGDAT
+	{
+		static constexpr std::string_view ACTION = GDAT::ACTION;
+
+		int64_t          favorite;
+		std::string_view server; /**< Encoded by GDAT::EncodeServer(). */
+		int64_t          num_fav_players;
+		std::string_view status; /**< Encoded by GDAT::EncodeStatus(). */
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(GDAT::FIELDS[0], this->favorite);
+			encoder.AddEncoded(this->server);
+			encoder.Add(GDAT::FIELDS[5], this->num_fav_players);
+			encoder.AddEncoded(this->status);
+			encoder.Add(GDAT::FIELDS[8], this->tid);
+		}
+	};
+
+	struct RLST
+	{
+		static constexpr std::string_view ACTION = "RLST";
+		static constexpr std::array<Theater::Field, 2> FIELDS = {{
+			{ "NUM-REGIONS", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          num_regions;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->num_regions);
+			encoder.Add(FIELDS[1], this->tid);
+		}
+	};
+
+	struct RDAT
+	{
+		static constexpr std::string_view ACTION = "RDAT";
+		static constexpr std::array<Theater::Field, 6> FIELDS = {{
+			{ "LOCALE", false }, { "NAME", true }, { "NUM-GAMES", false }, { "NUM-PLAYERS", false },
+			{ "REGION-ID", false }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          locale;
+		std::string_view name;
+		int64_t          num_games;
+		int64_t          num_players;
+		int64_t          region_id;
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			this->EncodeRegion(encoder);
+			encoder.Add(FIELDS[5], this->tid);
+		}
+
+		/**
+		 * @brief Encode the fields that are the same for every client.
+		 */
+		void EncodeRegion(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->locale);
+			encoder.Add(FIELDS[1], this->name);
+			encoder.Add(FIELDS[2], this->num_games);
+			encoder.Add(FIELDS[3], this->num_players);
+			encoder.Add(FIELDS[4], this->region_id);
+		}
+	};
+
+	/**
+	 * @brief RDAT with the fields of the region taken from the list cache.
+	 */
+	struct CachedRDAT
+	{
+		static constexpr std::string_view ACTION = RDAT::ACTION;
+
+		std::string_view region; /**< Encoded by RDAT::EncodeRegion(). */
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.AddEncoded(this->region);
+			encoder.Add(RDAT::FIELDS[5], this->tid);
+		}
+	};
+
+	struct CGAM
+	{
+		static constexpr std::string_view ACTION = "CGAM";
+		static constexpr std::array<Theater::Field, 2> FIELDS = {{
+			{ "GAME-ID", false }, { "LOBBY-ID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t game_id;
+		int64_t lobby_id;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->game_id);
+			encoder.Add(FIELDS[1], this->lobby_id);
+		}
+	};
+
+	struct UGAM
+	{
+		static constexpr std::string_view ACTION = "UGAM";
+		static constexpr std::array<Theater::Field, 1> FIELDS = {{
+			{ "QUENCH", false }
+		}};
+
+		int64_t quench; /**< Seconds between game updates. */
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->quench);
+		}
+	};
+
+	struct FILE
+	{
+		static constexpr std::string_view ACTION = "FILE";
+		static constexpr std::array<Theater::Field, 3> FIELDS = {{
+			{ "NUM-CHUNKS", false }, { "TID", false }, { "TYPE", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		int64_t          num_chunks;
+		std::string_view tid;
+		std::string_view type;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->num_chunks);
+			encoder.Add(FIELDS[1], this->tid);
+			encoder.Add(FIELDS[2], this->type);
+		}
+	};
+
+	struct FCHU
+	{
+		static constexpr std::string_view ACTION = "FCHU";
+		static constexpr std::array<Theater::Field, 2> FIELDS = {{
+			{ "DATA", true }, { "TID", false }
+		}};
+		static_assert(Theater::IsSorted(FIELDS));
+
+		std::string_view data; /**< Max 2047 characters. */
+		std::string_view tid;
+
+		void Encode(Theater::Encoder& encoder) const
+		{
+			encoder.Add(FIELDS[0], this->data);
+			encoder.Add(FIELDS[1], this->tid);
+		}
+	};
+
+	struct PONG
+	{
+		static constexpr std::string_view ACTION = "PONG";
+
+		/**
+		 * @brief PONG has no fields, only the header is sent.
+		 */
+		void Encode(Theater::Encoder& /* encoder */) const
+		{
+
+		}
+	};
+}
+
+#endif // THEATER_MESSAGES_H
@@ -0,0 +1,103 @@
+#include <theater/parameter_view.h>
+
+Theater::ParameterView::ParameterView()
+{
+
+}
+
+Theater::ParameterView::ParameterView(std::string_view data)
+{
+	this->Parse(data);
+}
+
+void Theater::ParameterView::Parse(std::string_view data)
+{
+	size_t pos = 0;
+	size_t size = data.size();
+
+	this->_size = 0;
+
+	while(pos < size && this->_size < MAX_PARAMETERS)
+	{
+		// Skip separators
+		if(data[pos] == ' ')
+		{
+			pos++;
+			continue;
+		}
+
+		// Key runs till '=' or the end of the token
+		size_t key_start = pos;
+
+		while(pos < size && data[pos] != '=' && data[pos] != ' ')
+		{
+			pos++;
+		}
+
+		// Token without '=' is ignored
+		if(pos >= size || data[pos] != '=')
+		{
+			continue;
+		}
+
+		std::string_view key = data.substr(key_start, pos - key_start);
+		size_t value_start = ++pos;
+
+		if(pos < size && data[pos] == '"')
+		{
+			// Quoted value runs till the closing quote, spaces and escaped characters included
+			pos++;
+
+			while(pos < size && data[pos] != '"')
+			{
+				pos += (data[pos] == '\\' && pos + 1 < size) ? 2 : 1;
+			}
+
+			// Keep the closing quote
+			if(pos < size)
+			{
+				pos++;
+			}
+		}
+		else
+		{
+			while(pos < size && data[pos] != ' ')
+			{
+				pos++;
+			}
+		}
+
+		this->_parameters[this->_size++] = { key, data.substr(value_start, pos - value_start) };
+	}
+}
+
+bool Theater::ParameterView::Has(std::string_view key) const
+{
+	std::string_view value;
+
+	return this->Get(key, value);
+}
+
+bool Theater::ParameterView::Get(std::string_view key, std::string_view& value) const
+{
+	// Search backwards so the last value of a repeated key wins
+	for(size_t i = this->_size; i > 0; i--)
+	{
+		if(this->_parameters[i - 1].first == key)
+		{
+			value = this->_parameters[i - 1].second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::string_view Theater::ParameterView::Get(std::string_view key) const
+{
+	std::string_view value;
+
+	this->Get(key, value);
+
+	return value;
+}
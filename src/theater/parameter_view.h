@@ -0,0 +1,81 @@
+#ifndef THEATER_PARAMETER_VIEW_H
+#define THEATER_PARAMETER_VIEW_H
+
+#include <array>
+#include <utility>
+#include <string_view>
+
+namespace Theater
+{
+	/**
+	 * @class ParameterView
+	 * @brief Flat list of KEY=VALUE pairs that point into the data of a request.
+	 * @details The data is parsed in a single pass without heap allocation. Values between quotes
+	 * may contain spaces and backslash escaped characters. Values are kept as they were sent,
+	 * quotes and escapes included, so the view is only valid as long as the request data.
+	 */
+	class ParameterView
+	{
+		public:
+			/**
+			 * @brief Maximum number of parameters kept from a single request.
+			 */
+			static const size_t MAX_PARAMETERS = 48;
+
+			typedef std::pair<std::string_view, std::string_view> Pair;
+
+		private:
+			std::array<Pair, MAX_PARAMETERS> _parameters; /**< The parsed KEY=VALUE pairs. */
+			size_t                           _size = 0;   /**< Number of parsed pairs. */
+
+		public:
+			ParameterView();
+
+			/**
+			 * @brief Parses the data of a request.
+			 * @param data The data after the header, without the ending 0x00.
+			 */
+			explicit ParameterView(std::string_view data);
+
+			/**
+			 * @brief Parses the data of a request, replacing the current parameters.
+			 * @param data The data after the header, without the ending 0x00.
+			 * @details Pairs beyond MAX_PARAMETERS are ignored.
+			 */
+			void Parse(std::string_view data);
+
+			/**
+			 * @brief Check if a parameter is present.
+			 * @param key The key of the parameter.
+			 * @return True if the parameter is present, false otherwise.
+			 */
+			bool Has(std::string_view key) const;
+
+			/**
+			 * @brief Get the value of a parameter.
+			 * @param key The key of the parameter.
+			 * @param value[out] The value of the parameter.
+			 * @return True if the parameter is present, false otherwise.
+			 * @details When a key is sent more than once the last value is returned.
+			 */
+			bool Get(std::string_view key, std::string_view& value) const;
+
+			/**
+			 * @brief Get the value of a parameter.
+			 * @param key The key of the parameter.
+			 * @return The value of the parameter, empty when the parameter is not present.
+			 */
+			std::string_view Get(std::string_view key) const;
+
+			/**
+			 * @brief Get the number of parsed parameters.
+			 * @return The number of parameters.
+			 */
+			size_t size() const { return this->_size; }
+
+			const Pair* begin() const { return this->_parameters.data(); }
+			const Pair* end() const   { return this->_parameters.data() + this->_size; }
+	};
+}
+
+#endif // THEATER_PARAMETER_VIEW_H
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <util.h>
+#include <logger.h>
+
+#include <theater/transaction_log.h>
+
+/**
+ * @brief Nanoseconds since the epoch.
+ */
+static uint64_t GetNowNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+Theater::TransactionLog::TransactionLog(const std::string& directory, size_t segment_size) :
+	_directory(directory), _segment_size(std::max(segment_size, MIN_SEGMENT_SIZE))
+{
+	this->_name = "theater-" + Util::Time::GetNowDateTime("%Y%m%d-%H%M%S");
+}
+
+Theater::TransactionLog::~TransactionLog()
+{
+	std::lock_guard<std::mutex> guard(this->_mutex); // transaction log lock
+
+	this->_CloseSegment();
+}
+
+void Theater::TransactionLog::Append(uint64_t connection, Theater::TransactionLogFormat::Direction direction, std::string_view frame)
+{
+	using namespace Theater::TransactionLogFormat;
+
+	size_t record_size = GetRecordSize(frame.size());
+
+	// Room for the record and the end marker of the segment
+	if(record_size + sizeof(RecordHeader) > this->_segment_size - sizeof(SegmentHeader))
+	{
+		this->_num_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	RecordHeader header = {};
+	header.size = static_cast<uint32_t>(frame.size());
+	std::memcpy(header.action, frame.data(), std::min<size_t>(frame.size(), sizeof(header.action)));
+	header.time = GetNowNanoseconds();
+	header.connection = connection;
+	header.direction = static_cast<uint8_t>(direction);
+
+	std::lock_guard<std::mutex> guard(this->_mutex); // transaction log lock
+
+	if(this->_data != nullptr && this->_offset + record_size + sizeof(RecordHeader) > this->_segment_size)
+	{
+		this->_CloseSegment();
+	}
+
+	if(this->_data == nullptr && !this->_OpenSegment())
+	{
+		this->_num_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// The padding is already zero, the file was created empty
+	std::memcpy(this->_data + this->_offset, &header, sizeof(header));
+	std::memcpy(this->_data + this->_offset + sizeof(header), frame.data(), frame.size());
+	this->_offset += record_size;
+
+	this->_num_records.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Private functions
+
+bool Theater::TransactionLog::_OpenSegment()
+{
+	using namespace Theater::TransactionLogFormat;
+
+	char sequence[16];
+	std::snprintf(sequence, sizeof(sequence), "%06llu", static_cast<unsigned long long>(this->_sequence));
+
+	std::string path = this->_directory + "/" + this->_name + "-" + sequence + ".txl";
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if(fd == -1)
+	{
+		Logger::error("Can't create transaction log \"" + path + "\"", Server::Type::Theater);
+		return false;
+	}
+
+	// Reserve the blocks now, a write into a sparse mapping on a full disk raises SIGBUS
+	if(posix_fallocate(fd, 0, this->_segment_size) != 0)
+	{
+		Logger::error("Can't reserve " + std::to_string(this->_segment_size) + " bytes for transaction log \"" + path + "\"", Server::Type::Theater);
+		close(fd);
+		unlink(path.c_str());
+		return false;
+	}
+
+	void* data = mmap(nullptr, this->_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if(data == MAP_FAILED)
+	{
+		Logger::error("Can't map transaction log \"" + path + "\"", Server::Type::Theater);
+		close(fd);
+		return false;
+	}
+
+	SegmentHeader header = {};
+	std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.header_size = sizeof(SegmentHeader);
+	header.sequence = this->_sequence;
+	header.created = GetNowNanoseconds();
+
+	std::memcpy(data, &header, sizeof(header));
+
+	this->_fd = fd;
+	this->_data = static_cast<unsigned char*>(data);
+	this->_offset = sizeof(header);
+	this->_sequence++;
+
+	this->_num_segments.fetch_add(1, std::memory_order_relaxed);
+
+	Logger::info("Transaction log segment \"" + path + "\" created", Server::Type::Theater);
+
+	return true;
+}
+
+void Theater::TransactionLog::_CloseSegment()
+{
+	if(this->_data == nullptr)
+	{
+		return;
+	}
+
+	// The end marker is the zeroed header after the last record
+	size_t used = this->_offset + sizeof(Theater::TransactionLogFormat::RecordHeader);
+
+	munmap(this->_data, this->_segment_size);
+
+	if(ftruncate(this->_fd, used) == -1)
+	{
+		Logger::warning("Can't truncate transaction log segment", Server::Type::Theater);
+	}
+
+	close(this->_fd);
+
+	this->_fd = -1;
+	this->_data = nullptr;
+	this->_offset = 0;
+}
@@ -0,0 +1,138 @@
+#ifndef THEATER_TRANSACTION_LOG_H
+#define THEATER_TRANSACTION_LOG_H
+
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace Theater
+{
+	/**
+	 * @brief Binary format of the transaction log segments.
+	 * @details A segment starts with a SegmentHeader followed by records. Every record is a RecordHeader
+	 * followed by the raw frame, padded to a multiple of 8 bytes. A record with size 0 ends the segment,
+	 * segments that were not closed cleanly end in zeros. All integers are little-endian.
+	 */
+	namespace TransactionLogFormat
+	{
+		const char     MAGIC[8] = {'M', 'O', 'H', 'R', 'S', 'T', 'X', 'L'};
+		const uint32_t VERSION = 1;
+
+		/**
+		 * @brief Direction of a logged frame.
+		 */
+		enum class Direction : uint8_t
+		{
+			Request = 0,  /**< Received from the client. */
+			Response = 1, /**< Sent to the client. */
+		};
+
+		/**
+		 * @brief Start of every segment file.
+		 */
+		struct SegmentHeader
+		{
+			char     magic[8];    /**< MAGIC. */
+			uint32_t version;     /**< VERSION. */
+			uint32_t header_size; /**< Size of this header. */
+			uint64_t sequence;    /**< Number of the segment since the server started. */
+			uint64_t created;     /**< Nanoseconds since the epoch when the segment was created. */
+		};
+
+		/**
+		 * @brief Start of every record.
+		 */
+		struct RecordHeader
+		{
+			uint32_t size;        /**< Size of the frame, 0 ends the segment. */
+			char     action[4];   /**< FourCC of the frame. */
+			uint64_t time;        /**< Nanoseconds since the epoch. */
+			uint64_t connection;  /**< Handle of the connection. */
+			uint8_t  direction;   /**< Direction. */
+			uint8_t  reserved[7];
+		};
+
+		static_assert(sizeof(SegmentHeader) == 32, "Segment header must be 32 bytes");
+		static_assert(sizeof(RecordHeader) == 32, "Record header must be 32 bytes");
+
+		/**
+		 * @brief Size of a record in the segment, header and padding included.
+		 * @param size The size of the frame.
+		 * @return The size of the record.
+		 */
+		constexpr size_t GetRecordSize(size_t size) { return sizeof(RecordHeader) + ((size + 7) & ~static_cast<size_t>(7)); }
+	}
+
+	/**
+	 * @brief Appends every Theater frame to memory-mapped segment files.
+	 *
+	 * A segment is created at its full size with its blocks reserved on disk and mapped, appending a
+	 * record is a copy into the mapping. When the disk has no room for a segment, records are dropped.
+	 * A full segment is truncated to its used size and the next one is started. The pages belong to the
+	 * kernel, so records survive a crash of the server. Use mohrs-logdump to read the segments.
+	 */
+	class TransactionLog
+	{
+		public:
+			/**
+			 * @brief Smallest segment, a segment must hold the largest frame.
+			 */
+			static constexpr size_t MIN_SEGMENT_SIZE = 1024 * 1024;
+
+		private:
+			std::string    _directory;       /**< Directory of the segment files. */
+			std::string    _name;            /**< Start of the segment file names. */
+			size_t         _segment_size;    /**< Size of a segment file. */
+
+			std::mutex     _mutex;           /**< Mutex for thread-safe access to the current segment. */
+			int            _fd = -1;         /**< Current segment file. */
+			unsigned char* _data = nullptr;  /**< Mapping of the current segment. */
+			size_t         _offset = 0;      /**< End of the last record in the current segment. */
+			uint64_t       _sequence = 0;    /**< Number of the next segment. */
+
+			std::atomic<uint64_t> _num_records{0};  /**< Records appended. */
+			std::atomic<uint64_t> _num_dropped{0};  /**< Records lost because no segment could be opened. */
+			std::atomic<uint64_t> _num_segments{0}; /**< Segments created. */
+
+		public:
+			/**
+			 * @brief Create a transaction log, the first segment is created by the first record.
+			 * @param directory The directory of the segment files.
+			 * @param segment_size The size of a segment file, at least MIN_SEGMENT_SIZE.
+			 */
+			TransactionLog(const std::string& directory, size_t segment_size);
+
+			/**
+			 * @brief Close the current segment.
+			 */
+			~TransactionLog();
+
+			/**
+			 * @brief Append a frame.
+			 * @param connection The handle of the connection.
+			 * @param direction The direction of the frame.
+			 * @param frame The raw frame, header included.
+			 */
+			void Append(uint64_t connection, TransactionLogFormat::Direction direction, std::string_view frame);
+
+			uint64_t GetNumRecords() const  { return this->_num_records.load(std::memory_order_relaxed);  }
+			uint64_t GetNumDropped() const  { return this->_num_dropped.load(std::memory_order_relaxed);  }
+			uint64_t GetNumSegments() const { return this->_num_segments.load(std::memory_order_relaxed); }
+
+		private:
+			/**
+			 * @brief Create and map the next segment.
+			 * @return True if the segment is open.
+			 */
+			bool _OpenSegment();
+
+			/**
+			 * @brief Unmap the current segment and truncate it to its used size.
+			 */
+			void _CloseSegment();
+	};
+}
+
+#endif // THEATER_TRANSACTION_LOG_H
@@ -5,6 +5,7 @@
 #include <numeric>
 #include <random>
 #include <chrono>
+#include <time.h>
 
 #include <util.h>
 
@@ -36,9 +37,16 @@ bool Util::Buffer::ReadString(const std::vector<unsigned char>& buffer, size_t&
 }
 
 std::string Util::Buffer::ToString(const std::vector<char>& buffer)
+{
+	return Util::Buffer::ToString(std::string_view(buffer.data(), buffer.size()));
+}
+
+std::string Util::Buffer::ToString(std::string_view buffer)
 {
 	std::string s;
 	
+	s.reserve(buffer.size());
+	
 	for(char v : buffer)
 	{
 		if((v >= 32 && v <= 126) || (v == 9))
@@ -56,9 +64,7 @@ std::string Util::Buffer::ToString(const std::vector<char>& buffer)
 
 std::string Util::Buffer::ToString(const std::vector<unsigned char>& buffer)
 {
-	std::vector<char> buffer2(buffer.begin(), buffer.end());
-	
-	return Util::Buffer::ToString(buffer2);
+	return Util::Buffer::ToString(std::string_view(reinterpret_cast<const char*>(buffer.data()), buffer.size()));
 }
 
 //Util::Time
@@ -91,6 +97,15 @@ std::string Util::Time::GetTimeZone()
 	return timezone_string;	
 }
 
+int64_t Util::Time::GetMonotonicSeconds()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+
+	return ts.tv_sec;
+}
+
 // Util::Url
 
 void Util::Url::GetElements(const std::string& url, std::string& url_base, Util::Url::Variables& url_variables)
@@ -206,23 +221,19 @@ std::string Util::addQuote(const std::string& value)
 	return "\"" + value + "\"";
 }
 
-std::string Util::removeQuote(const std::string& value)
+std::string_view Util::removeQuote(std::string_view value)
 {
-	std::string new_value = value;
+	if (!value.empty() && value.front() == '\"')
+	{
+		value.remove_prefix(1); // Remove first character
+	}
 
-	if (!new_value.empty())
+	if (!value.empty() && value.back() == '\"')
 	{
-        if (new_value.front() == '\"')
-		{
-            new_value.erase(0, 1); // Remove first character
-        }
-        if (new_value.back() == '\"')
-		{
-            new_value.pop_back(); // Remove last character
-        }
-    }
+		value.remove_suffix(1); // Remove last character
+	}
 
-	return new_value;
+	return value;
 }
 
 std::vector<std::string> Util::splitFavorite(const std::string& input)
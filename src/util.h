@@ -2,6 +2,7 @@
 #define UTIL_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 
@@ -52,6 +53,16 @@ namespace Util
 		 * @return The resulting string.
 		 */
 		std::string ToString(const std::vector<unsigned char>& buffer);
+
+		/**
+		 * @brief Convert a view of a buffer to a string.
+		 * 
+		 * This function converts a view of a buffer to a string.
+		 * 
+		 * @param buffer The view of the buffer to convert.
+		 * @return The resulting string.
+		 */
+		std::string ToString(std::string_view buffer);
 	}
 	
 	namespace Url
@@ -113,6 +124,16 @@ namespace Util
 		 * @return The current time zone as a string.
 		 */
 		std::string GetTimeZone();
+
+		/**
+		 * @brief Get the current time of the coarse monotonic clock.
+		 * 
+		 * This function is cheap enough to call on every read. The clock is not affected by
+		 * changes of the system time.
+		 * 
+		 * @return The current monotonic time in seconds.
+		 */
+		int64_t GetMonotonicSeconds();
 	}
 	
 	/**
@@ -125,9 +146,9 @@ namespace Util
 	/**
 	 * @brief Removes quotation marks from the provided string.
 	 * @param value The string to remove quotation marks from.
-	 * @return The string with quotation marks removed.
+	 * @return The string with quotation marks removed, a view into value.
 	 */
-	std::string removeQuote(const std::string& value);
+	std::string_view removeQuote(std::string_view value);
 	
 	/**
 	 * @brief Splits a string containing favorite items into a vector of strings.
@@ -135,6 +156,27 @@ namespace Util
 	 * @return A vector of strings containing the individual favorite items.
 	 */
 	std::vector<std::string> splitFavorite(const std::string& input);
+
+	/**
+	 * @brief Read-only view of a contiguous range of objects.
+	 */
+	template<typename T>
+	class Span
+	{
+		private:
+			const T* _data; /**< First object. */
+			size_t   _size; /**< Number of objects. */
+
+		public:
+			Span(const T* data, size_t size) : _data(data), _size(size) {}
+
+			const T* begin() const { return this->_data; }
+			const T* end() const   { return this->_data + this->_size; }
+			size_t   size() const  { return this->_size; }
+			bool     empty() const { return this->_size == 0; }
+
+			const T& operator[](size_t index) const { return this->_data[index]; }
+	};
 }
 
 #endif // UTIL_H
@@ -2,12 +2,19 @@
 #include <json/json.h>
 #include <random>
 #include <chrono>
+#include <charconv>
 
 #include <logger.h>
 #include <globals.h>
 #include <settings.h>
 #include <mohrs/game.h>
 #include <mohrs/matchmaker.h>
+#include <mohrs/event_bus.h>
+#include <theater/client.h>
+#include <theater/list_cache.h>
+#include <theater/transaction_log.h>
+#include <theater/flight_recorder.h>
+#include <service/discord.h>
 
 #include <webserver/client.h>
 
@@ -33,7 +40,7 @@ void Webserver::Client::requestAPIAdminClients(const atomizes::HTTPMessage& http
 {
 	// Check password
 	auto it = url_variables.find("password");
-	if (it == url_variables.end() || it->second != g_settings["webserver"]["password"].asString())
+	if (it == url_variables.end() || it->second != GetSettings().webserver.password)
 	{
 		return;
 	}
@@ -47,13 +54,13 @@ void Webserver::Client::requestAPIAdminClients(const atomizes::HTTPMessage& http
 		Json::Value json_game;
 		
 		json_game["id"] = game.GetId();
-		json_game["ip"] = game.GetIp();
-		json_game["name"] = game.GetName();
+		json_game["ip"] = game.GetIpString();
+		json_game["name"] = std::string(game.GetName());
 		json_game["region"] = static_cast<int8_t>(game.GetRegion());
 		json_game["num_players"] = game.GetNumPlayers();
 		json_game["max_players"] = game.GetMaxPlayers();
-		json_game["host_player"] = game.GetHostPlayer();
-		json_game["theater_session"] = game.GetTheaterSession();
+		json_game["host_player"] = std::string(game.GetHostPlayer());
+		json_game["theater_session"] = std::string(game.GetTheaterSession());
 
 		// Players
 		Json::Value json_players(Json::arrayValue);
@@ -61,8 +68,8 @@ void Webserver::Client::requestAPIAdminClients(const atomizes::HTTPMessage& http
 		{
 			Json::Value json_player;
 
-			json_player["name"] = player.GetName();
-			json_player["ticket"] = player.GetTicket();
+			json_player["name"] = std::string(player.GetName());
+			json_player["ticket"] = std::string(player.GetTicket());
 
 			json_players.append(json_player);
 		}
@@ -74,26 +81,34 @@ void Webserver::Client::requestAPIAdminClients(const atomizes::HTTPMessage& http
 
 	// Theater
 	Json::Value json_theater(Json::arrayValue);
-	for(std::shared_ptr<Net::Socket> client : g_theater_server->GetClients())
+	g_theater_server->ForEachClient([&json_theater](const std::shared_ptr<Net::Socket>& client)
 	{
 		Json::Value json_client;
 
 		json_client["ip"] = client.get()->GetIP();
 		json_client["port"] = client.get()->GetPort();
+		json_client["handle"] = static_cast<Json::UInt64>(client.get()->GetHandle());
 
 		time_t last_recieved_time = std::chrono::system_clock::to_time_t(client.get()->GetLastRecievedTime());
 		json_client["last_recieved_time"] = std::string(std::ctime(&last_recieved_time));
+		
+		// Send syscalls per request
+		json_client["requests"] = static_cast<Json::UInt64>(static_cast<Theater::Client*>(client.get())->GetNumRequests());
+		json_client["send_calls"] = static_cast<Json::UInt64>(client.get()->GetSendCalls());
+		
+		// Slow consumers
+		json_client["send_queue"] = static_cast<Json::UInt64>(client.get()->GetSendQueueSize());
 
 		// Debug
 		//json_client["ref_count"] = client.use_count();
 
 		json_theater.append(json_client);
-	}
+	});
 	json_results["theater"] = json_theater;
 
 	// Webserver
 	Json::Value json_webserver(Json::arrayValue);
-	for(std::shared_ptr<Net::Socket> client : g_webserver_server->GetClients())
+	g_webserver_server->ForEachClient([&json_webserver](const std::shared_ptr<Net::Socket>& client)
 	{
 		Json::Value json_client;
 
@@ -102,16 +117,127 @@ void Webserver::Client::requestAPIAdminClients(const atomizes::HTTPMessage& http
 
 		time_t last_recieved_time = std::chrono::system_clock::to_time_t(client.get()->GetLastRecievedTime());
 		json_client["last_recieved_time"] = std::string(std::ctime(&last_recieved_time));
+		json_client["send_queue"] = static_cast<Json::UInt64>(client.get()->GetSendQueueSize());
 
 		// Debug
 		//json_client["ref_count"] = client.use_count();
 
 		json_webserver.append(json_client);
-	}
+	});
 	json_results["webserver"] = json_webserver;
 
+	// Metrics
+	Json::Value json_metrics;
+	for(const auto& [action, count] : Theater::Client::GetRequestCounts())
+	{
+		json_metrics["theater"]["requests"][action] = static_cast<Json::UInt64>(count);
+	}
+
+	uint64_t hits = g_list_cache->GetHits(),
+		misses = g_list_cache->GetMisses();
+
+	json_metrics["theater"]["list_cache"]["hits"] = static_cast<Json::UInt64>(hits);
+	json_metrics["theater"]["list_cache"]["misses"] = static_cast<Json::UInt64>(misses);
+	json_metrics["theater"]["list_cache"]["hit_rate"] = (hits + misses > 0) ? static_cast<double>(hits) / (hits + misses) : 0.0;
+
+	json_metrics["matchmaker"]["batches"] = static_cast<Json::UInt64>(g_matchmaker->GetNumBatches());
+	json_metrics["matchmaker"]["writes"] = static_cast<Json::UInt64>(g_matchmaker->GetNumWrites());
+	json_metrics["matchmaker"]["updates"] = static_cast<Json::UInt64>(g_matchmaker->GetNumUpdates());
+	json_metrics["matchmaker"]["noop_updates"] = static_cast<Json::UInt64>(g_matchmaker->GetNumNoopUpdates());
+	json_metrics["matchmaker"]["rejected"] = static_cast<Json::UInt64>(g_matchmaker->GetNumRejected());
+
+	json_metrics["discord"]["sent"] = static_cast<Json::UInt64>(g_discord->GetNumSent());
+	json_metrics["discord"]["coalesced"] = static_cast<Json::UInt64>(g_discord->GetNumCoalesced());
+	json_metrics["discord"]["dropped"] = static_cast<Json::UInt64>(g_discord->GetNumDropped());
+	json_metrics["discord"]["events_dropped"] = static_cast<Json::UInt64>(g_discord->GetNumEventsDropped());
+	json_metrics["logger"]["dropped"] = static_cast<Json::UInt64>(Logger::GetNumDropped());
+	json_metrics["event_bus"]["published"] = static_cast<Json::UInt64>(g_event_bus->GetNumPublished());
+	
+	if(g_transaction_log != nullptr)
+	{
+		json_metrics["transaction_log"]["records"] = static_cast<Json::UInt64>(g_transaction_log->GetNumRecords());
+		json_metrics["transaction_log"]["dropped"] = static_cast<Json::UInt64>(g_transaction_log->GetNumDropped());
+		json_metrics["transaction_log"]["segments"] = static_cast<Json::UInt64>(g_transaction_log->GetNumSegments());
+	}
+	
+	json_results["metrics"] = json_metrics;
+
 	this->Send(json_results);
 
 	this->_LogTransaction("<--", "HTTP/1.1 200 OK");
 }
 
+void Webserver::Client::requestAPIAdminFlightRecorder(const atomizes::HTTPMessage& http_request, const std::string& url_base,
+		const Util::Url::Variables& url_variables)
+{
+	// Check password
+	{
+		auto it = url_variables.find("password");
+		if (it == url_variables.end() || it->second != GetSettings().webserver.password)
+		{
+			return;
+		}
+	}
+
+	Json::Value json_results;
+	std::vector<Theater::FlightRecorder::Frame> frames;
+	std::string name = "all";
+
+	auto it = url_variables.find("connection");
+	if (it != url_variables.end())
+	{
+		uint64_t handle = 0;
+		std::from_chars_result result = std::from_chars(it->second.data(), it->second.data() + it->second.size(), handle);
+
+		// The invalid handle would dump every connection
+		if (it->second.empty() || result.ec != std::errc() || result.ptr != it->second.data() + it->second.size() ||
+		    handle == Net::SocketTable::INVALID_HANDLE)
+		{
+			json_results["error"] = "Invalid connection \"" + it->second + "\"";
+
+			this->Send(json_results);
+
+			this->_LogTransaction("<--", "HTTP/1.1 200 OK");
+			return;
+		}
+
+		std::shared_ptr<Net::Socket> client = g_theater_server->GetClient(handle);
+
+		// A client that disconnected only has its frames in the global ring left
+		if (client)
+		{
+			frames = static_cast<Theater::Client*>(client.get())->GetRecordedFrames();
+		}
+		else
+		{
+			frames = g_flight_recorder->Snapshot(handle);
+		}
+
+		name = std::to_string(handle);
+	}
+	else
+	{
+		frames = g_flight_recorder->Snapshot();
+	}
+
+	std::string path = Theater::FlightRecorder::GetDumpPath(name);
+
+	json_results["frames"] = static_cast<Json::UInt64>(frames.size());
+
+	if (Theater::FlightRecorder::WritePcap(path, frames))
+	{
+		json_results["file"] = path;
+
+		Logger::info("Flight recorder dumped " + std::to_string(frames.size()) + " frames to \"" + path + "\"", Server::Type::Webserver);
+	}
+	else
+	{
+		json_results["error"] = "Can't write " + path;
+
+		Logger::error("Can't write flight recorder dump \"" + path + "\"", Server::Type::Webserver);
+	}
+
+	this->Send(json_results);
+
+	this->_LogTransaction("<--", "HTTP/1.1 200 OK");
+}
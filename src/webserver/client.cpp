@@ -1,4 +1,8 @@
 #include <unistd.h>
+#include <errno.h>
+#include <strings.h>
+#include <cstdlib>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -27,8 +31,47 @@ static std::map<std::string, RequestActionFunc> mRequestActions =
 	
 	// API
 	{ "/API/admin/clients",                                   &Webserver::Client::requestAPIAdminClients    },
+	{ "/API/admin/flight_recorder",                           &Webserver::Client::requestAPIAdminFlightRecorder },
 };
 
+/**
+ * @brief Largest request a client may send, header and body.
+ */
+static const size_t MAX_REQUEST_SIZE = 64 * 1024;
+
+/**
+ * @brief Get the size of the first request in a buffer.
+ * 
+ * @param request The received data.
+ * @return The size of the header and the body given by Content-Length, std::string::npos while the header is not complete.
+ */
+static size_t GetRequestSize(const std::string& request)
+{
+	size_t header_end = request.find("\r\n\r\n");
+	
+	if(header_end == std::string::npos)
+	{
+		return std::string::npos;
+	}
+	
+	size_t content_length = 0;
+	
+	// Header lines after the request line, the names are case insensitive
+	for(size_t pos = request.find("\r\n") + 2; pos < header_end + 2; )
+	{
+		size_t line_end = request.find("\r\n", pos);
+		
+		if(line_end - pos > 15 && strncasecmp(request.c_str() + pos, "Content-Length:", 15) == 0)
+		{
+			content_length = std::min<size_t>(std::strtoull(request.c_str() + pos + 15, nullptr, 10), MAX_REQUEST_SIZE + 1);
+		}
+		
+		pos = line_end + 2;
+	}
+	
+	return header_end + 4 + content_length;
+}
+
 Webserver::Client::Client(int socket, struct sockaddr_in address)
 {
 	this->_socket = socket;
@@ -41,35 +84,82 @@ Webserver::Client::~Client()
 	this->Disconnect();
 }
 
-void Webserver::Client::Listen()
+bool Webserver::Client::onReadable()
 {
-	std::vector<char> buffer(4096, 0);
-	HTTPMessageParser http_parser;
-	HTTPMessage http_request;
+	bool closed = false;
+	
+	// Read socket till it is drained, a request can arrive over several reads
+	while(true)
+	{
+		char chunk[4096];
+
+		int recv_size = read(this->_socket, chunk, sizeof(chunk));
+
+		if(recv_size < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			if(errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				return false;
+			}
+
+			break;
+		}
+
+		// The client closed its side, a complete request is still answered
+		if(recv_size == 0)
+		{
+			closed = true;
+			break;
+		}
+
+		this->_request.append(chunk, recv_size);
+		
+		this->UpdateLastRecievedTime();
+
+		if(this->_request.size() > MAX_REQUEST_SIZE)
+		{
+			Logger::warning("Client " + this->GetAddress() + " sent a request larger than " + std::to_string(MAX_REQUEST_SIZE) + " bytes", Server::Type::Webserver);
+
+			return false;
+		}
+	}
 	
-	// Read socket
-	int recv_size = read(this->_socket, &(buffer[0]), 4096);
+	size_t request_size = GetRequestSize(this->_request);
 	
-	// If error or no data is recieved we end the connection
-	if(recv_size <= 0)
+	if(request_size != std::string::npos && request_size > MAX_REQUEST_SIZE)
 	{
-		this->Disconnect();
+		Logger::warning("Client " + this->GetAddress() + " sent a request larger than " + std::to_string(MAX_REQUEST_SIZE) + " bytes", Server::Type::Webserver);
 
-		return;
+		return false;
 	}
 	
-	// Resize buffer
-	buffer.resize(recv_size);
+	// Wait for the rest of the header and body
+	if(request_size == std::string::npos || this->_request.size() < request_size)
+	{
+		return !closed;
+	}
 	
-	this->UpdateLastRecievedTime();
+	HTTPMessageParser http_parser;
+	HTTPMessage http_request;
+	
+	// The connection is closed after the response, anything sent after the request is ignored
+	this->_request.resize(request_size);
 
 	// Parse buffer to http header
-	http_parser.Parse(&http_request, &(buffer[0]));
+	http_parser.Parse(&http_request, this->_request.c_str());
+	
+	this->_request.clear();
 	
 	// Trigger onRequest event
 	this->onRequest(http_request);
 	
-	this->Disconnect();
+	// Keep the connection till the event loop has written the whole response
+	return this->CloseWhenSent();
 }
 
 void Webserver::Client::Disconnect()
@@ -142,18 +232,18 @@ void Webserver::Client::requestMeme(const atomizes::HTTPMessage& http_request, c
 
 void Webserver::Client::_LogTransaction(const std::string& direction, const std::string& response) const
 {
-	std::shared_lock<std::shared_mutex> guard(g_settings_mutex); // settings lock (read)
+	if(!MOHRS_LOG_ENABLED(Logger::Level::Transaction))
+	{
+		return;
+	}
 	
-	//if ((g_logger_mode & Logger::Mode::Development) == 0)
-	//{
-	//	return;
-	//}
+	const Settings::Webserver& settings = GetSettings().webserver;
 	
-	bool show_console = (g_settings["webserver"]["show_requests"].asBool() && direction == "-->") ||
-						(g_settings["webserver"]["show_responses"].asBool() && direction == "<--");
+	bool show_console = (settings.show_requests && direction == "-->") ||
+						(settings.show_responses && direction == "<--");
 	
-	Logger::info(this->GetAddress() + " " + direction + " " + response,
-			Server::Type::Webserver, show_console);
+	Logger::Log(Logger::Level::Transaction, Server::Type::Webserver, show_console,
+			this->GetAddress(), " ", direction, " ", response);
 }
 
 atomizes::HTTPMessage Webserver::Client::_defaultResponseHeader(bool isPlainText) const
@@ -228,28 +318,3 @@ void Webserver::Client::_SendFile(const std::string& file_name) const
 	
 	this->_LogTransaction("<--", "HTTP/1.1 200 OK");
 }
-
-// Static functions
-
-void Webserver::Client::Heartbeat()
-{
-	Logger::info("Heartbeat started", Server::Webserver);
-
-	while(true)
-	{
-		std::this_thread::sleep_for (std::chrono::seconds(60));
-
-		auto target_time = std::chrono::system_clock::now() - std::chrono::minutes(1);
-
-		for(std::shared_ptr<Net::Socket> client : g_webserver_server->GetClients())
-		{
-			auto last_recieved = client.get()->GetLastRecievedTime();
-
-			if (last_recieved <= target_time)
-			{
-				client.get()->Close();
-			}
-		}
-	}
-}
-
@@ -25,6 +25,9 @@ namespace Webserver
 {
 	class Client : public Net::Socket
 	{
+		private:
+			std::string _request; /**< Received part of the request, it is handled once complete. */
+
 		public:
 			/**
 			 * @brief Constructor for Webserver Client.
@@ -40,14 +43,19 @@ namespace Webserver
 			~Client();
 			
 			/**
-			 * @brief Start listening for incoming requests.
+			 * @brief Read the pending data and respond once the request is complete.
+			 * 
+			 * The header ends with an empty line and is followed by Content-Length bytes of body,
+			 * a request that arrives in several reads is kept till the rest of it arrives.
+			 * 
+			 * @return False when the connection must be closed, true otherwise.
 			 */
-			void Listen();
+			bool onReadable() override;
 
 			/**
 			 * @brief Disconnect the client.
 			 */
-			void Disconnect();
+			void Disconnect() override;
 
 			/**
 			 * @brief Send an HTTP response.
@@ -113,6 +121,18 @@ namespace Webserver
 			 * @param url_variables  Additional URL variables.
 			 */
 			void requestAPIAdminClients(const atomizes::HTTPMessage& http_request, const std::string& url_base, const Util::Url::Variables& url_variables);
+
+			/**
+			 * @brief Handle a request to dump the flight recorder through the API.
+			 * 
+			 * Writes the last frames of the theater connection in the "connection" variable, or of all
+			 * connections without it, to a capture file in the log directory.
+			 * 
+			 * @param http_request   The HTTP request message.
+			 * @param url_base       The base URL for flight recorder API requests.
+			 * @param url_variables  Additional URL variables.
+			 */
+			void requestAPIAdminFlightRecorder(const atomizes::HTTPMessage& http_request, const std::string& url_base, const Util::Url::Variables& url_variables);
 		
 		private:
 			/**
@@ -148,15 +168,6 @@ namespace Webserver
 			 * @param file_name The name of the file to send.
 			 */
 			void _SendFile(const std::string& file_name) const;
-		
-		public:
-			/**
-			 * @brief Heartbeat function to manage client connections.
-			 *
-			 * This function periodically checks for client connections and closes
-			 * connections that have not sent any data in the last minute.
-			 */
-			static void Heartbeat();
 	};
 }
 
@@ -0,0 +1,30 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+#include <cstdlib>
+
+/**
+ * @brief Number of failed checks, the test fails when it is not 0.
+ */
+inline int g_failed_checks = 0;
+
+/**
+ * @brief Check a condition and report it when it does not hold, the test goes on.
+ */
+#define CHECK(condition) \
+	do \
+	{ \
+		if(!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			g_failed_checks++; \
+		} \
+	} while(false)
+
+/**
+ * @brief Exit code of the test.
+ */
+#define CHECK_RESULT() ((g_failed_checks == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif // TESTS_CHECK_H
@@ -0,0 +1,148 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <globals.h>
+#include <settings.h>
+#include <theater/client.h>
+#include <theater/framer.h>
+#include <theater/flight_recorder.h>
+
+#include "check.h"
+
+/**
+ * @brief Build a request frame.
+ */
+static std::string MakeRequest(const std::string& action, const std::string& data)
+{
+	std::string frame = action + std::string(8, '\0') + data;
+
+	if(!data.empty())
+	{
+		frame += '\0';
+	}
+
+	frame[8] = static_cast<char>(frame.size() >> 24);
+	frame[9] = static_cast<char>(frame.size() >> 16);
+	frame[10] = static_cast<char>(frame.size() >> 8);
+	frame[11] = static_cast<char>(frame.size());
+
+	return frame;
+}
+
+/**
+ * @brief Read the actions of the responses that are waiting on the socket.
+ */
+static std::vector<std::string> ReadResponses(int socket)
+{
+	Theater::Framer framer;
+	std::vector<std::string> actions;
+	size_t size;
+	unsigned char* buffer = framer.GetWriteBuffer(size);
+	ssize_t recv_size = recv(socket, buffer, size, MSG_DONTWAIT);
+
+	if(recv_size > 0)
+	{
+		framer.Commit(recv_size);
+	}
+
+	std::string_view frame;
+
+	while(framer.Next(frame) == Theater::Framer::Frame)
+	{
+		actions.push_back(std::string(frame.substr(0, 4)));
+	}
+
+	return actions;
+}
+
+int main()
+{
+	Settings settings;
+	int sockets[2];
+
+	g_settings.store(&settings);
+	g_flight_recorder = new Theater::FlightRecorder(Theater::FlightRecorder::GLOBAL_CAPACITY);
+
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+	// Never destroyed, disconnecting needs the matchmaker and the server
+	Theater::Client* client = new Theater::Client(sockets[0], sockaddr_in());
+	std::map<std::string, uint64_t> before = Theater::Client::GetRequestCounts();
+
+	// Known actions are handled and answered
+	client->onRequest(MakeRequest("CONN", "PROT=2 PROD=moh3"));
+	client->onRequest(MakeRequest("USER", "NAME=player"));
+	client->onRequest(MakeRequest("PING", ""));
+
+	CHECK((ReadResponses(sockets[1]) == std::vector<std::string>{ "CONN", "USER", "PONG" }));
+
+	// Unknown actions, including actions that only differ in case, are counted and not answered
+	client->onRequest(MakeRequest("XXXX", "A=1"));
+	client->onRequest(MakeRequest("conn", ""));
+	client->onRequest(MakeRequest("\xff\xff\xff\xff", ""));
+
+	// Requests that miss a required parameter are counted and not answered
+	client->onRequest(MakeRequest("PROF", "OTHER=1"));
+	client->onRequest(MakeRequest("GLST", "TID=1"));
+
+	// A request shorter than a header is ignored
+	client->onRequest("CONN");
+
+	CHECK(ReadResponses(sockets[1]).empty());
+
+	// A required parameter may be the only one
+	client->onRequest(MakeRequest("PROF", "TEXT=\"hello\""));
+
+	CHECK((ReadResponses(sockets[1]) == std::vector<std::string>{ "PROF" }));
+
+	std::map<std::string, uint64_t> after = Theater::Client::GetRequestCounts();
+
+	CHECK(after["CONN"] - before["CONN"] == 1);
+	CHECK(after["USER"] - before["USER"] == 1);
+	CHECK(after["PING"] - before["PING"] == 1);
+	CHECK(after["PROF"] - before["PROF"] == 1);
+	CHECK(after["GLST"] - before["GLST"] == 0);
+	CHECK(after["unknown"] - before["unknown"] == 3);
+	CHECK(after["incomplete"] - before["incomplete"] == 2);
+
+	// Every action of the dispatch table is reported
+	for(const char* action : { "CONN", "USER", "PROF", "LLST", "GLST", "RLST", "CGAM", "UGAM", "RGAM", "FILE", "PING" })
+	{
+		CHECK(after.count(action) == 1);
+	}
+
+	// Responses to later requests wait for a reserved response
+	uint64_t first = client->ReserveResponse();
+
+	client->onRequest(MakeRequest("PING", ""));
+
+	uint64_t second = client->ReserveResponse();
+
+	client->onRequest(MakeRequest("USER", "NAME=player"));
+
+	CHECK(ReadResponses(sockets[1]).empty());
+
+	// The second reservation is complete first, it still waits for the first one
+	client->SendReserved(second, { MakeRequest("UGAM", "QUENCH=20") });
+
+	CHECK(ReadResponses(sockets[1]).empty());
+
+	client->SendReserved(first, { MakeRequest("CGAM", "GAME-ID=1 LOBBY-ID=1") });
+
+	CHECK((ReadResponses(sockets[1]) == std::vector<std::string>{ "CGAM", "PONG", "UGAM", "USER" }));
+
+	// A reservation without responses only releases the held responses
+	uint64_t empty = client->ReserveResponse();
+
+	client->onRequest(MakeRequest("PING", ""));
+	client->SendReserved(empty, {});
+
+	CHECK((ReadResponses(sockets[1]) == std::vector<std::string>{ "PONG" }));
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,149 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <theater/encoder.h>
+#include <theater/messages.h>
+
+#include "check.h"
+
+/**
+ * @brief Read the size in the header of a response.
+ */
+static uint32_t GetSize(std::string_view response)
+{
+	return (static_cast<uint32_t>(static_cast<unsigned char>(response[8])) << 24) |
+	       (static_cast<uint32_t>(static_cast<unsigned char>(response[9])) << 16) |
+	       (static_cast<uint32_t>(static_cast<unsigned char>(response[10])) << 8) |
+	        static_cast<uint32_t>(static_cast<unsigned char>(response[11]));
+}
+
+/**
+ * @brief Encode a response the way Theater::Client::Send does.
+ */
+template<typename Response>
+static std::string Encode(const Response& response)
+{
+	std::vector<unsigned char> buffer;
+	Theater::Encoder encoder(buffer);
+
+	encoder.Begin(Response::ACTION);
+	response.Encode(encoder);
+
+	return std::string(encoder.End());
+}
+
+/**
+ * @brief Fields are separated by spaces, quoted fields get quotes and the data ends with 0x00.
+ */
+static void TestFields()
+{
+	Theater::Response::CONN conn;
+	conn.important = "yes";
+	conn.num_challenges = -12;
+
+	std::string response = Encode(conn);
+
+	CHECK(response.substr(0, 4) == "CONN");
+	CHECK(response.substr(4, 4) == std::string(4, '\0'));
+	CHECK(GetSize(response) == response.size());
+	CHECK(response.substr(12) == std::string("IMPORTANT=yes NUM-CHALLENGES=-12") + '\0');
+
+	Theater::Response::USER user;
+	user.ticket = "1111";
+
+	CHECK(Encode(user).substr(12) == std::string("TICKET=\"1111\"") + '\0');
+}
+
+/**
+ * @brief A response without fields is only the header.
+ */
+static void TestEmptyResponse()
+{
+	std::string response = Encode(Theater::Response::PONG());
+
+	CHECK(response.size() == 12);
+	CHECK(response.substr(0, 4) == "PONG");
+	CHECK(GetSize(response) == 12);
+}
+
+/**
+ * @brief Encoded fragments join the fields with a single space, empty fragments add nothing.
+ */
+static void TestEncodedFragments()
+{
+	std::vector<unsigned char> fragment_buffer;
+	Theater::Encoder fragment(fragment_buffer);
+	Theater::Field name = { "NAME", true };
+	Theater::Field max_players = { "MAX-PLAYERS", false };
+
+	fragment.Add(name, "My Server");
+	fragment.Add(max_players, 8);
+
+	std::string_view fields(reinterpret_cast<const char*>(fragment_buffer.data()), fragment_buffer.size());
+
+	CHECK(fields == "NAME=\"My Server\" MAX-PLAYERS=8");
+
+	std::vector<unsigned char> buffer;
+	Theater::Encoder encoder(buffer);
+	Theater::Field tid = { "TID", false };
+
+	encoder.Begin("GDAT");
+	encoder.AddEncoded("");
+	encoder.AddEncoded(fields);
+	encoder.Add(tid, 7);
+
+	std::string_view response = encoder.End();
+
+	CHECK(response.substr(12) == std::string("NAME=\"My Server\" MAX-PLAYERS=8 TID=7") + '\0');
+	CHECK(GetSize(response) == response.size());
+}
+
+/**
+ * @brief Responses are appended to the buffer, each with its own size.
+ */
+static void TestSeveralResponses()
+{
+	std::vector<unsigned char> buffer;
+	Theater::Encoder encoder(buffer);
+	Theater::Field tid = { "TID", false };
+
+	encoder.Begin("GLST");
+	encoder.Add(tid, 1);
+	size_t first_size = encoder.End().size();
+
+	encoder.Begin("PONG");
+	size_t second_size = encoder.End().size();
+
+	// Only the last response is valid, the others may have moved
+	encoder.Begin("FILE");
+	encoder.Add(tid, 123456);
+	std::string_view third = encoder.End();
+
+	CHECK(buffer.size() == first_size + second_size + third.size());
+	CHECK(GetSize(std::string_view(reinterpret_cast<const char*>(buffer.data()), buffer.size())) == first_size);
+	CHECK(second_size == 12);
+	CHECK(third.substr(0, 4) == "FILE");
+	CHECK(third.substr(12) == std::string("TID=123456") + '\0');
+
+	// The buffer keeps its capacity when it is reused
+	size_t capacity = buffer.capacity();
+
+	buffer.clear();
+	encoder.Begin("GLST");
+	encoder.Add(tid, 1);
+	encoder.End();
+
+	CHECK(buffer.size() == first_size);
+	CHECK(buffer.capacity() == capacity);
+}
+
+int main()
+{
+	TestFields();
+	TestEmptyResponse();
+	TestEncodedFragments();
+	TestSeveralResponses();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,228 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include <mohrs/event_bus.h>
+
+#include "check.h"
+
+/**
+ * @brief Create an event whose fields all follow from its id, so a torn event is easy to spot.
+ */
+static MoHRS::Event MakeEvent(int id)
+{
+	MoHRS::Event event;
+
+	event.type = MoHRS::Event::Type::GameUpdated;
+	event.game_id = id;
+	event.region = static_cast<MoHRS::Regions>(1 + id % 6);
+	event.num_players = static_cast<uint8_t>(id % 8);
+	event.theater_session.Assign("10.0.0.1:" + std::to_string(id));
+	event.name.Assign("Game " + std::to_string(id));
+	event.host_player.Assign("Host" + std::to_string(id));
+
+	return event;
+}
+
+/**
+ * @brief Check that every field of an event belongs to the same id.
+ */
+static bool IsComplete(const MoHRS::Event& event)
+{
+	int id = event.game_id;
+
+	return event.type == MoHRS::Event::Type::GameUpdated &&
+	       event.region == static_cast<MoHRS::Regions>(1 + id % 6) &&
+	       event.num_players == static_cast<uint8_t>(id % 8) &&
+	       event.theater_session.View() == "10.0.0.1:" + std::to_string(id) &&
+	       event.name.View() == "Game " + std::to_string(id) &&
+	       event.host_player.View() == "Host" + std::to_string(id);
+}
+
+/**
+ * @brief Poll all events of a subscriber.
+ */
+static std::vector<int> PollIds(MoHRS::EventBus::Subscriber& subscriber)
+{
+	std::vector<int> ids;
+
+	subscriber.Poll([&ids](const MoHRS::Event& event)
+	{
+		CHECK(IsComplete(event));
+
+		ids.push_back(event.game_id);
+	});
+
+	return ids;
+}
+
+/**
+ * @brief A subscriber only sees events published after it subscribed, in publish order.
+ */
+static void TestSubscribe()
+{
+	MoHRS::EventBus bus;
+
+	for(int id = 0; id < 3; id++)
+	{
+		bus.Publish(MakeEvent(id));
+	}
+
+	MoHRS::EventBus::Subscriber subscriber(bus, MoHRS::EventBus::Overflow::DropOldest);
+
+	CHECK(PollIds(subscriber).empty());
+
+	for(int id = 3; id < 103; id++)
+	{
+		bus.Publish(MakeEvent(id));
+	}
+
+	std::vector<int> ids = PollIds(subscriber);
+
+	CHECK(ids.size() == 100);
+
+	for(size_t i = 0; i < ids.size(); i++)
+	{
+		CHECK(ids[i] == static_cast<int>(3 + i));
+	}
+
+	// Every event is handled once
+	CHECK(PollIds(subscriber).empty());
+	CHECK(subscriber.GetNumDropped() == 0);
+	CHECK(bus.GetNumPublished() == 103);
+}
+
+/**
+ * @brief A subscriber that fell behind continues at the oldest event that is still in the ring.
+ */
+static void TestDropOldest()
+{
+	MoHRS::EventBus bus;
+	MoHRS::EventBus::Subscriber subscriber(bus, MoHRS::EventBus::Overflow::DropOldest);
+	const int num_events = MoHRS::EventBus::CAPACITY + 10;
+
+	for(int id = 0; id < num_events; id++)
+	{
+		bus.Publish(MakeEvent(id));
+	}
+
+	std::vector<int> ids = PollIds(subscriber);
+
+	CHECK(ids.size() == MoHRS::EventBus::CAPACITY);
+	CHECK(!ids.empty() && ids.front() == 10 && ids.back() == num_events - 1);
+	CHECK(subscriber.GetNumDropped() == 10);
+
+	for(size_t i = 1; i < ids.size(); i++)
+	{
+		CHECK(ids[i] == ids[i - 1] + 1);
+	}
+}
+
+/**
+ * @brief A subscriber that fell behind skips everything queued and continues with new events.
+ */
+static void TestDropAll()
+{
+	MoHRS::EventBus bus;
+	MoHRS::EventBus::Subscriber subscriber(bus, MoHRS::EventBus::Overflow::DropAll);
+	const int num_events = MoHRS::EventBus::CAPACITY + 10;
+
+	for(int id = 0; id < num_events; id++)
+	{
+		bus.Publish(MakeEvent(id));
+	}
+
+	CHECK(PollIds(subscriber).empty());
+	CHECK(subscriber.GetNumDropped() == static_cast<uint64_t>(num_events));
+
+	for(int id = num_events; id < num_events + 5; id++)
+	{
+		bus.Publish(MakeEvent(id));
+	}
+
+	std::vector<int> ids = PollIds(subscriber);
+
+	CHECK(ids.size() == 5);
+	CHECK(!ids.empty() && ids.front() == num_events);
+	CHECK(subscriber.GetNumDropped() == static_cast<uint64_t>(num_events));
+}
+
+/**
+ * @brief Producers publish while a subscriber polls, every handled event is complete and in order.
+ */
+static void TestConcurrent()
+{
+	const int num_producers = 4;
+	const int num_events = 50000;
+
+	MoHRS::EventBus bus;
+	MoHRS::EventBus::Subscriber subscriber(bus, MoHRS::EventBus::Overflow::DropOldest);
+	std::vector<std::thread> threads;
+	std::atomic<int> num_done{0};
+
+	for(int producer = 0; producer < num_producers; producer++)
+	{
+		threads.emplace_back([&bus, &num_done, producer, num_events]()
+		{
+			for(int i = 0; i < num_events; i++)
+			{
+				bus.Publish(MakeEvent(producer * num_events + i));
+			}
+
+			num_done++;
+		});
+	}
+
+	std::vector<int> last(num_producers, -1);
+	uint64_t num_handled = 0;
+	bool torn = false;
+	bool ordered = true;
+
+	auto poll = [&]()
+	{
+		num_handled += subscriber.Poll([&](const MoHRS::Event& event)
+		{
+			torn |= !IsComplete(event);
+
+			int producer = event.game_id / num_events;
+
+			if(producer >= 0 && producer < num_producers)
+			{
+				// A producer publishes its events in order, so they are handled in order
+				ordered &= (event.game_id > last[producer]);
+				last[producer] = event.game_id;
+			}
+		});
+	};
+
+	while(num_done < num_producers)
+	{
+		poll();
+	}
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	poll();
+
+	CHECK(!torn);
+	CHECK(ordered);
+	CHECK(num_handled > 0);
+	CHECK(bus.GetNumPublished() == static_cast<uint64_t>(num_producers * num_events));
+
+	// A slot that a lapped producer finished last is counted by neither
+	CHECK(num_handled + subscriber.GetNumDropped() <= bus.GetNumPublished());
+}
+
+int main()
+{
+	TestSubscribe();
+	TestDropOldest();
+	TestDropAll();
+	TestConcurrent();
+
+	return CHECK_RESULT();
+}
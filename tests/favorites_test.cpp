@@ -0,0 +1,122 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <util.h>
+#include <mohrs/favorites.h>
+
+#include "check.h"
+
+/**
+ * @brief The matching of the matchmaker before FavoriteMatcher.
+ */
+static bool OldMatches(const std::string& patterns, const std::string& text)
+{
+	for(const std::string& pattern : Util::splitFavorite(patterns))
+	{
+		if(text.find(pattern) != std::string::npos)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Check that the matcher agrees with the old matching.
+ */
+static void CheckSame(const std::string& patterns, const std::string& text)
+{
+	MoHRS::FavoriteMatcher matcher(patterns);
+	bool old_result = OldMatches(patterns, text);
+	bool new_result = matcher.Matches(text);
+
+	if(old_result != new_result)
+	{
+		std::cerr << "patterns \"" << patterns << "\" text \"" << text << "\": old " << old_result << ", new " << new_result << std::endl;
+	}
+
+	CHECK(old_result == new_result);
+}
+
+/**
+ * @brief Empty lists and empty patterns.
+ */
+static void TestEmptyPatterns()
+{
+	// No patterns match nothing
+	CheckSame("", "");
+	CheckSame("", "Pearl Harbor");
+
+	// An empty pattern, also between or before others, matches every text
+	for(const char* patterns : { ";", ";;", "a;;b", ";abc", "xyz;", "xyz;;" })
+	{
+		CheckSame(patterns, "");
+		CheckSame(patterns, "Pearl Harbor");
+		CheckSame(patterns, "abc");
+	}
+
+	CHECK(MoHRS::FavoriteMatcher(";").Matches(""));
+	CHECK(MoHRS::FavoriteMatcher("a;;b").Matches("zzz"));
+
+	// A trailing ';' does not add an empty pattern
+	CHECK(!MoHRS::FavoriteMatcher("xyz;").Matches("abc"));
+	CHECK(!MoHRS::FavoriteMatcher("").Matches("abc"));
+}
+
+/**
+ * @brief Patterns that overlap, contain each other or only match as a suffix.
+ */
+static void TestOverlappingPatterns()
+{
+	const std::string patterns = "he;she;his;hers;\"Pearl Harbor\";rbo";
+
+	for(const char* text : { "ushers", "hi", "this", "sh", "h", "shore", "\"Pearl Harbor\"", "Pearl Harbor", "Harbor", "arbo" })
+	{
+		CheckSame(patterns, text);
+	}
+
+	CheckSame("aaaa;aab", "aaab");
+	CheckSame("abcd;bc", "abce");
+	CheckSame("abcd;bcx", "abcx");
+	CheckSame("\xff\x01;\x80", std::string("a\x80z"));
+	CheckSame("abc", "ab");
+}
+
+/**
+ * @brief Random pattern lists on a small alphabet so many patterns overlap.
+ */
+static void TestRandom()
+{
+	std::mt19937 random(1);
+	const std::string alphabet = "ab;c";
+
+	for(int i = 0; i < 20000; i++)
+	{
+		std::string patterns;
+		std::string text;
+
+		for(size_t length = random() % 12; length > 0; length--)
+		{
+			patterns += alphabet[random() % alphabet.size()];
+		}
+
+		for(size_t length = random() % 16; length > 0; length--)
+		{
+			text += alphabet[random() % 3];
+		}
+
+		CheckSame(patterns, text);
+	}
+}
+
+int main()
+{
+	TestEmptyPatterns();
+	TestOverlappingPatterns();
+	TestRandom();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include <theater/flight_recorder.h>
+
+#include "check.h"
+
+using Theater::TransactionLogFormat::Direction;
+
+/**
+ * @brief Frames are kept oldest first, cut at the snap length, with their original length.
+ */
+static void TestRing()
+{
+	Theater::FlightRecorder recorder(8, 16);
+
+	CHECK(recorder.Snapshot().empty());
+
+	for(size_t i = 0; i < 20; i++)
+	{
+		std::string frame = "UGAM" + std::string(i, static_cast<char>('a' + i));
+
+		recorder.Record(1 + i % 2, (i % 3 == 0) ? Direction::Response : Direction::Request, frame);
+	}
+
+	std::vector<Theater::FlightRecorder::Frame> frames = recorder.Snapshot();
+
+	CHECK(frames.size() == 8);
+
+	for(size_t i = 0; i < frames.size(); i++)
+	{
+		size_t number = 12 + i;
+		std::string frame = "UGAM" + std::string(number, static_cast<char>('a' + number));
+
+		CHECK(frames[i].connection == 1 + number % 2);
+		CHECK(frames[i].direction == ((number % 3 == 0) ? Direction::Response : Direction::Request));
+		CHECK(frames[i].length == frame.size());
+		CHECK(frames[i].data == frame.substr(0, 16));
+	}
+
+	// Only the frames of a connection
+	frames = recorder.Snapshot(2);
+
+	CHECK(frames.size() == 4);
+
+	for(const Theater::FlightRecorder::Frame& frame : frames)
+	{
+		CHECK(frame.connection == 2);
+	}
+}
+
+/**
+ * @brief Threads that record at the same time, also the first frame, leave only complete frames.
+ */
+static void TestConcurrent()
+{
+	Theater::FlightRecorder recorder(64, 64);
+	std::vector<std::thread> threads;
+
+	for(uint64_t connection = 1; connection <= 8; connection++)
+	{
+		threads.emplace_back([&recorder, connection]()
+		{
+			for(size_t i = 0; i < 2000; i++)
+			{
+				recorder.Record(connection, Direction::Request, std::string(8 + i % 100, static_cast<char>('0' + connection)));
+			}
+		});
+	}
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::vector<Theater::FlightRecorder::Frame> frames = recorder.Snapshot();
+
+	// A writer that was lapped by another one may leave its slot skipped
+	CHECK(!frames.empty() && frames.size() <= 64);
+
+	// Every frame was written by a single thread
+	for(const Theater::FlightRecorder::Frame& frame : frames)
+	{
+		CHECK(frame.data == std::string(std::min<size_t>(frame.length, 64), static_cast<char>('0' + frame.connection)));
+	}
+}
+
+/**
+ * @brief The capture file holds every frame after its pseudo header.
+ */
+static void TestPcap()
+{
+	Theater::FlightRecorder recorder(4, Theater::FlightRecorder::CONNECTION_SNAP_LENGTH);
+	std::filesystem::path path = std::filesystem::temp_directory_path() / ("mohrs-flight-" + std::to_string(getpid()) + ".pcap");
+
+	recorder.Record(5, Direction::Request, "CONN" + std::string(8, '\0') + "TID=1");
+	recorder.Record(5, Direction::Response, std::string(300, 'x'));
+
+	CHECK(Theater::FlightRecorder::WritePcap(path.string(), recorder.Snapshot()));
+
+	std::ifstream file(path, std::ios::binary);
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	uint32_t value;
+
+	CHECK(data.size() == 24 + (16 + 16 + 17) + (16 + 16 + Theater::FlightRecorder::CONNECTION_SNAP_LENGTH));
+
+	if(data.size() >= 24 + 16 + 16)
+	{
+		std::memcpy(&value, data.data(), sizeof(value));
+		CHECK(value == 0xa1b23c4d);
+
+		// The snap length
+		std::memcpy(&value, data.data() + 16, sizeof(value));
+		CHECK(value == 16 + Theater::FlightRecorder::CONNECTION_SNAP_LENGTH);
+
+		// Captured and original length of the first packet
+		std::memcpy(&value, data.data() + 24 + 8, sizeof(value));
+		CHECK(value == 16 + 17);
+		std::memcpy(&value, data.data() + 24 + 12, sizeof(value));
+		CHECK(value == 16 + 17);
+
+		// The pseudo header
+		uint64_t connection;
+		std::memcpy(&connection, data.data() + 24 + 16, sizeof(connection));
+		CHECK(connection == 5);
+		CHECK(data[24 + 16 + 8] == static_cast<char>(Direction::Request));
+		CHECK(std::string(data.data() + 24 + 32, 4) == "CONN");
+	}
+
+	std::filesystem::remove(path);
+}
+
+int main()
+{
+	TestRing();
+	TestConcurrent();
+	TestPcap();
+
+	return CHECK_RESULT();
+}
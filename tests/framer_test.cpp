@@ -0,0 +1,171 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+#include <theater/framer.h>
+
+#include "check.h"
+
+/**
+ * @brief Build a frame with a Theater header.
+ * @param action The FourCC of the frame.
+ * @param payload The data after the header.
+ * @param header_size The size written in the header, the real size when it is negative.
+ */
+static std::string MakeFrame(const std::string& action, const std::string& payload, int64_t header_size = -1)
+{
+	std::string frame = action + std::string("\x40\x00\x00\x00", 4) + std::string(4, '\0') + payload;
+	uint32_t size = static_cast<uint32_t>((header_size < 0) ? frame.size() : header_size);
+
+	frame[8] = static_cast<char>(size >> 24);
+	frame[9] = static_cast<char>(size >> 16);
+	frame[10] = static_cast<char>(size >> 8);
+	frame[11] = static_cast<char>(size);
+
+	return frame;
+}
+
+/**
+ * @brief Feed data to the framer like a read would.
+ */
+static void Feed(Theater::Framer& framer, std::string_view data)
+{
+	size_t size;
+	unsigned char* buffer = framer.GetWriteBuffer(size);
+
+	CHECK(size >= data.size());
+
+	std::memcpy(buffer, data.data(), data.size());
+	framer.Commit(data.size());
+}
+
+/**
+ * @brief One frame that arrives in several reads.
+ */
+static void TestSplitFrame()
+{
+	Theater::Framer framer;
+	std::string frame = MakeFrame("CGAM", "NAME=split\nMAXPLAYERS=32\n");
+	std::string_view result;
+
+	// Header split in the middle of the size field, payload split twice
+	std::vector<size_t> cuts = { 0, 3, 10, 20, frame.size() };
+
+	for(size_t i = 1; i < cuts.size(); i++)
+	{
+		CHECK(framer.Next(result) == Theater::Framer::Incomplete);
+
+		Feed(framer, std::string_view(frame).substr(cuts[i - 1], cuts[i] - cuts[i - 1]));
+	}
+
+	CHECK(framer.Next(result) == Theater::Framer::Frame);
+	CHECK(result == frame);
+	CHECK(framer.Next(result) == Theater::Framer::Incomplete);
+}
+
+/**
+ * @brief Several frames that arrive in one read.
+ */
+static void TestSeveralFrames()
+{
+	Theater::Framer framer;
+	std::vector<std::string> frames = {
+		MakeFrame("CONN", "PROT=2\n"),
+		MakeFrame("USER", "NAME=player\n"),
+		MakeFrame("PING", ""),
+	};
+	std::string data;
+	std::string_view result;
+
+	for(const std::string& frame : frames)
+	{
+		data += frame;
+	}
+
+	// Start of a fourth frame
+	data += MakeFrame("GLST", "LID=1\n").substr(0, 5);
+
+	Feed(framer, data);
+
+	for(const std::string& frame : frames)
+	{
+		CHECK(framer.Next(result) == Theater::Framer::Frame);
+		CHECK(result == frame);
+	}
+
+	CHECK(framer.Next(result) == Theater::Framer::Incomplete);
+
+	Feed(framer, MakeFrame("GLST", "LID=1\n").substr(5));
+
+	CHECK(framer.Next(result) == Theater::Framer::Frame);
+	CHECK(result == MakeFrame("GLST", "LID=1\n"));
+}
+
+/**
+ * @brief Frames that are split over the end of the buffer wrap to the start.
+ */
+static void TestWrap()
+{
+	Theater::Framer framer;
+	std::string frame = MakeFrame("UGAM", std::string(1000, 'x'));
+	std::string_view result;
+
+	// Keep half a frame pending after every read so the tail has to wrap
+	Feed(framer, std::string_view(frame).substr(0, 500));
+
+	for(int i = 0; i < 100; i++)
+	{
+		Feed(framer, frame.substr(500) + frame.substr(0, 500));
+
+		CHECK(framer.Next(result) == Theater::Framer::Frame);
+		CHECK(result == frame);
+		CHECK(framer.Next(result) == Theater::Framer::Incomplete);
+	}
+}
+
+/**
+ * @brief Sizes in the header that can never be valid.
+ */
+static void TestInvalidSize()
+{
+	std::string_view result;
+
+	for(uint32_t size : { 0u, 1u, 11u, static_cast<uint32_t>(Theater::MAX_FRAME_SIZE) + 1, 0xFFFFFFFFu })
+	{
+		Theater::Framer framer;
+
+		Feed(framer, MakeFrame("CGAM", "NAME=x\n", size));
+
+		CHECK(framer.Next(result) == Theater::Framer::Invalid);
+	}
+
+	// The smallest and the largest valid size
+	for(uint32_t size : { 12u, static_cast<uint32_t>(Theater::MAX_FRAME_SIZE) })
+	{
+		Theater::Framer framer;
+
+		Feed(framer, MakeFrame("PING", std::string(size - 12, 'x')));
+
+		CHECK(framer.Next(result) == Theater::Framer::Frame);
+		CHECK(result.size() == size);
+	}
+
+	// An invalid size is only known once the whole header is there
+	Theater::Framer framer;
+
+	Feed(framer, MakeFrame("CGAM", "", 11).substr(0, 11));
+
+	CHECK(framer.Next(result) == Theater::Framer::Incomplete);
+}
+
+int main()
+{
+	TestSplitFrame();
+	TestSeveralFrames();
+	TestWrap();
+	TestInvalidSize();
+
+	return CHECK_RESULT();
+}
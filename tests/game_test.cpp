@@ -0,0 +1,58 @@
+#include <string>
+
+#include <mohrs/game.h>
+#include <mohrs/player.h>
+
+#include "check.h"
+
+/**
+ * @brief Values up to the capacity are stored, longer values are rejected and keep the old value.
+ */
+static void TestLimits()
+{
+	MoHRS::Game game;
+	MoHRS::Player player;
+
+	CHECK(game.SetName(std::string(MoHRS::MAX_GAME_NAME, 'n')));
+	CHECK(game.GetName() == std::string(MoHRS::MAX_GAME_NAME, 'n'));
+	CHECK(game.SetName("Pearl Harbor"));
+	CHECK(!game.SetName(std::string(MoHRS::MAX_GAME_NAME + 1, 'n')));
+	CHECK(game.GetName() == "Pearl Harbor");
+
+	CHECK(game.SetHostPlayer(std::string(MoHRS::MAX_PLAYER_NAME, 'h')));
+	CHECK(!game.SetHostPlayer(std::string(MoHRS::MAX_PLAYER_NAME + 1, 'h')));
+	CHECK(game.GetHostPlayer() == std::string(MoHRS::MAX_PLAYER_NAME, 'h'));
+
+	CHECK(game.SetTheaterSession("255.255.255.255:65535"));
+	CHECK(!game.SetTheaterSession(std::string(MoHRS::MAX_THEATER_SESSION + 1, '1')));
+	CHECK(game.GetTheaterSession() == "255.255.255.255:65535");
+
+	CHECK(player.SetName(std::string(MoHRS::MAX_PLAYER_NAME, 'p')));
+	CHECK(!player.SetName(std::string(MoHRS::MAX_PLAYER_NAME + 1, 'p')));
+	CHECK(player.GetName() == std::string(MoHRS::MAX_PLAYER_NAME, 'p'));
+
+	CHECK(player.SetTicket("1111"));
+	CHECK(!player.SetTicket(std::string(MoHRS::MAX_TICKET + 1, '1')));
+	CHECK(player.GetTicket() == "1111");
+}
+
+/**
+ * @brief The quotes around a value do not count against the capacity.
+ */
+static void TestQuotes()
+{
+	MoHRS::Game game;
+
+	CHECK(game.SetName("\"" + std::string(MoHRS::MAX_GAME_NAME, 'n') + "\""));
+	CHECK(game.GetName() == std::string(MoHRS::MAX_GAME_NAME, 'n'));
+	CHECK(game.SetName("\"My Server\""));
+	CHECK(game.GetName() == "My Server");
+}
+
+int main()
+{
+	TestLimits();
+	TestQuotes();
+
+	return CHECK_RESULT();
+}
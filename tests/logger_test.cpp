@@ -0,0 +1,109 @@
+#include <string>
+
+#include <logger.h>
+
+#include "check.h"
+
+static int g_num_evaluated = 0;
+
+/**
+ * @brief A log argument that counts how often it is evaluated.
+ */
+static std::string Evaluate()
+{
+	g_num_evaluated++;
+
+	return "value";
+}
+
+/**
+ * @brief Debug and transaction messages are only logged in development mode.
+ */
+static void TestModes()
+{
+	g_logger_mode = Logger::Mode::Development;
+
+	CHECK(Logger::IsEnabled(Logger::Level::Debug));
+	CHECK(Logger::IsEnabled(Logger::Level::Transaction));
+	CHECK(Logger::IsEnabled(Logger::Level::Info));
+
+	for(Logger::Mode mode : { Logger::Mode::Production, Logger::Mode::Deployment })
+	{
+		g_logger_mode = mode;
+
+		CHECK(!Logger::IsEnabled(Logger::Level::Debug));
+		CHECK(!Logger::IsEnabled(Logger::Level::Transaction));
+		CHECK(Logger::IsEnabled(Logger::Level::Info));
+		CHECK(Logger::IsEnabled(Logger::Level::Error));
+	}
+}
+
+/**
+ * @brief The arguments of a level that the mode does not log are never evaluated.
+ */
+static void TestDisabledByMode()
+{
+	g_logger_mode = Logger::Mode::Production;
+	g_num_evaluated = 0;
+
+	LOG_DEBUG("debug ", Evaluate());
+	LOG_TRANSACTION(Server::Type::Theater, false, "127.0.0.1:1234 --> ", Evaluate());
+	CHECK(g_num_evaluated == 0);
+
+	LOG_INFO(Server::Type::Theater, false, "info ", Evaluate());
+	CHECK(g_num_evaluated == 1);
+}
+
+/**
+ * @brief Levels below MOHRS_LOG_LEVEL are compiled out, also in development mode.
+ */
+static void TestDisabledByBuild()
+{
+	g_logger_mode = Logger::Mode::Development;
+	g_num_evaluated = 0;
+
+	LOG_DEBUG("debug ", Evaluate());
+	LOG_TRANSACTION(Server::Type::Theater, false, "127.0.0.1:1234 --> ", Evaluate());
+
+	CHECK(g_num_evaluated == (MOHRS_LOG_LEVEL <= 0) + (MOHRS_LOG_LEVEL <= 1));
+}
+
+/**
+ * @brief The message is formatted by the writer thread, not by the caller.
+ */
+static void TestFormatDeferred()
+{
+	int num_formatted = 0;
+
+	// No writer thread is started, so the queued record is never formatted
+	Logger::Push(Logger::Level::Info, "", false, [&num_formatted]()
+	{
+		num_formatted++;
+
+		return std::string("message");
+	});
+
+	CHECK(num_formatted == 0);
+}
+
+/**
+ * @brief Flush does not wait for a writer thread that was never started.
+ */
+static void TestFlushWithoutWriter()
+{
+	Logger::info("queued", Server::Type::Theater, false);
+	Logger::Flush();
+
+	CHECK(Logger::GetNumDropped() == 0);
+}
+
+int main()
+{
+	TestModes();
+	TestDisabledByMode();
+	TestDisabledByBuild();
+	TestFormatDeferred();
+	TestFlushWithoutWriter();
+
+	return CHECK_RESULT();
+}
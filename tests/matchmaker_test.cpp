@@ -0,0 +1,88 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+
+#include <globals.h>
+#include <mohrs/event_bus.h>
+#include <mohrs/matchmaker.h>
+#include <theater/client.h>
+#include <theater/parameter_view.h>
+
+#include "check.h"
+
+/**
+ * @brief Create a game server client, never destroyed since disconnecting needs the theater server.
+ */
+static Theater::Client* MakeClient(uint16_t port)
+{
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(0x0A000001);
+	address.sin_port = htons(port);
+
+	return new Theater::Client(-1, address);
+}
+
+/**
+ * @brief Wait till the applier committed a number of writes.
+ */
+static void WaitForWrites(const MoHRS::Matchmaker& matchmaker, uint64_t num_writes)
+{
+	while(matchmaker.GetNumWrites() < num_writes)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/**
+ * @brief A new game that reuses the slot of a removed one is still listed after the older games.
+ */
+static void TestSnapshotOrder(MoHRS::Matchmaker& matchmaker)
+{
+	std::vector<Theater::Client*> clients;
+
+	for(uint16_t port = 1000; port < 1004; port++)
+	{
+		clients.push_back(MakeClient(port));
+	}
+
+	for(size_t i = 0; i < 3; i++)
+	{
+		std::string cgam = "REGION-ID=1 NAME=\"Game " + std::to_string(i) + "\" MAX-PLAYERS=8 HOST-PLAYER=\"Host\"";
+
+		CHECK(matchmaker.createGame(*clients[i], Theater::ParameterView(cgam), [](const MoHRS::Game&) {}));
+		WaitForWrites(matchmaker, i + 1);
+	}
+
+	matchmaker.removeGame(std::string(clients[0]->GetAddress()));
+	WaitForWrites(matchmaker, 4);
+
+	CHECK(matchmaker.createGame(*clients[3], Theater::ParameterView("REGION-ID=1 NAME=\"Game 3\" MAX-PLAYERS=8 HOST-PLAYER=\"Host\""), [](const MoHRS::Game&) {}));
+	WaitForWrites(matchmaker, 5);
+
+	std::shared_ptr<const MoHRS::RegionSnapshot> snapshot = matchmaker.GetSnapshot(MoHRS::Regions::Europe);
+
+	CHECK(snapshot->games.size() == 3);
+
+	if(snapshot->games.size() == 3)
+	{
+		CHECK(snapshot->games[0]->GetName() == "Game 1");
+		CHECK(snapshot->games[1]->GetName() == "Game 2");
+		CHECK(snapshot->games[2]->GetName() == "Game 3");
+		CHECK(snapshot->games[0]->GetId() < snapshot->games[1]->GetId());
+		CHECK(snapshot->games[1]->GetId() < snapshot->games[2]->GetId());
+	}
+}
+
+int main()
+{
+	g_event_bus = new MoHRS::EventBus();
+
+	// The applier threads are detached, the matchmaker is never destroyed
+	MoHRS::Matchmaker* matchmaker = new MoHRS::Matchmaker();
+
+	TestSnapshotOrder(*matchmaker);
+
+	return CHECK_RESULT();
+}
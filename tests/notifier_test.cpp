@@ -0,0 +1,257 @@
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <service/notifier.h>
+
+#include "check.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static constexpr std::chrono::milliseconds SEND_INTERVAL{50};
+static constexpr std::chrono::milliseconds RATE_LIMITED_INTERVAL{300};
+
+/**
+ * @brief Stands in for Discord, records what was sent and when.
+ */
+struct Recorder
+{
+	std::mutex                       mutex;
+	std::vector<std::string>         messages;
+	std::vector<Clock::time_point>   times;
+	bool                             rate_limit_first = false;
+	Service::Notifier*               notifier = nullptr;
+
+	void Send(const std::string& message)
+	{
+		std::lock_guard<std::mutex> guard(this->mutex); // recorder lock
+
+		this->messages.push_back(message);
+		this->times.push_back(Clock::now());
+
+		// Answer the first message with 429 Too Many Requests
+		if(this->rate_limit_first && this->messages.size() == 1)
+		{
+			this->notifier->RateLimited();
+		}
+	}
+
+	/**
+	 * @brief Wait till a number of messages was sent.
+	 * @return False when they were not sent within a few seconds.
+	 */
+	bool WaitFor(size_t num_messages)
+	{
+		Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+
+		while(Clock::now() < deadline)
+		{
+			{
+				std::lock_guard<std::mutex> guard(this->mutex); // recorder lock
+
+				if(this->messages.size() >= num_messages)
+				{
+					return true;
+				}
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+
+		return false;
+	}
+};
+
+/**
+ * @brief Create a notifier that sends to a recorder, both live till the test ends.
+ */
+static Service::Notifier* MakeNotifier(Recorder& recorder)
+{
+	recorder.notifier = new Service::Notifier([&recorder](const std::string& message) { recorder.Send(message); },
+	                                          Service::Notifier::Poller(), SEND_INTERVAL, RATE_LIMITED_INTERVAL);
+
+	return recorder.notifier;
+}
+
+/**
+ * @brief Messages queued while waiting are joined into messages of at most 2000 characters, in order.
+ */
+static void TestCoalesce()
+{
+	Recorder* recorder = new Recorder();
+	Service::Notifier* notifier = MakeNotifier(*recorder);
+	std::vector<std::string> queued;
+
+	// 49 characters each, 40 of them and their line breaks fill 1999 characters
+	for(size_t i = 0; i < 100; i++)
+	{
+		queued.push_back("Player \"Soldier\" created server called \"Game " + std::to_string(100 + i) + "\"");
+		CHECK(queued.back().size() == 49);
+
+		notifier->Send(queued.back());
+	}
+
+	notifier->Start();
+	notifier->SetReady(true);
+
+	CHECK(recorder->WaitFor(3));
+
+	std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+	std::string joined;
+
+	CHECK(recorder->messages.size() == 3);
+
+	for(const std::string& message : recorder->messages)
+	{
+		CHECK(message.size() <= Service::Notifier::MAX_MESSAGE);
+
+		joined += (joined.empty() ? "" : "\n") + message;
+	}
+
+	std::string expected;
+
+	for(const std::string& message : queued)
+	{
+		expected += (expected.empty() ? "" : "\n") + message;
+	}
+
+	CHECK(joined == expected);
+	CHECK(!recorder->messages.empty() && recorder->messages[0].size() == 40 * 49 + 39);
+	CHECK(notifier->GetNumSent() == 3);
+	CHECK(notifier->GetNumCoalesced() == 97);
+
+	// Sends are paced
+	for(size_t i = 1; i < recorder->times.size(); i++)
+	{
+		CHECK(recorder->times[i] - recorder->times[i - 1] >= SEND_INTERVAL);
+	}
+}
+
+/**
+ * @brief A message longer than a Discord message is cut, the next one is sent on its own.
+ */
+static void TestLongMessage()
+{
+	Recorder* recorder = new Recorder();
+	Service::Notifier* notifier = MakeNotifier(*recorder);
+
+	notifier->Send(std::string(3000, 'x'));
+	notifier->Send("short");
+	notifier->Start();
+	notifier->SetReady(true);
+
+	CHECK(recorder->WaitFor(2));
+
+	std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+
+	CHECK(recorder->messages.size() == 2);
+
+	if(recorder->messages.size() == 2)
+	{
+		CHECK(recorder->messages[0] == std::string(Service::Notifier::MAX_MESSAGE, 'x'));
+		CHECK(recorder->messages[1] == "short");
+	}
+}
+
+/**
+ * @brief A message sent right after another waits for the send interval.
+ */
+static void TestPacing()
+{
+	Recorder* recorder = new Recorder();
+	Service::Notifier* notifier = MakeNotifier(*recorder);
+
+	notifier->Start();
+	notifier->SetReady(true);
+
+	notifier->Send("first");
+	CHECK(recorder->WaitFor(1));
+	notifier->Send("second");
+	notifier->Send("third");
+	CHECK(recorder->WaitFor(2));
+
+	std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+
+	CHECK(recorder->messages.size() == 2);
+
+	if(recorder->messages.size() == 2)
+	{
+		CHECK(recorder->messages[1] == "second\nthird");
+		CHECK(recorder->times[1] - recorder->times[0] >= SEND_INTERVAL);
+	}
+}
+
+/**
+ * @brief After a 429 nothing is sent for the rate limited interval, the held messages are kept.
+ */
+static void TestRateLimited()
+{
+	Recorder* recorder = new Recorder();
+	Service::Notifier* notifier = MakeNotifier(*recorder);
+
+	recorder->rate_limit_first = true;
+
+	notifier->Start();
+	notifier->SetReady(true);
+
+	notifier->Send("first");
+	CHECK(recorder->WaitFor(1));
+	notifier->Send("second");
+	CHECK(recorder->WaitFor(2));
+
+	std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+
+	CHECK(recorder->messages.size() == 2);
+
+	if(recorder->messages.size() == 2)
+	{
+		CHECK(recorder->messages[1] == "second");
+		CHECK(recorder->times[1] - recorder->times[0] >= RATE_LIMITED_INTERVAL);
+	}
+}
+
+/**
+ * @brief Messages wait till the notifier is ready, a full queue drops the newest messages.
+ */
+static void TestReadyAndDrop()
+{
+	Recorder* recorder = new Recorder();
+	Service::Notifier* notifier = MakeNotifier(*recorder);
+
+	notifier->Start();
+
+	for(size_t i = 0; i < Service::Notifier::MAX_QUEUE + 10; i++)
+	{
+		notifier->Send("message " + std::to_string(i));
+	}
+
+	std::this_thread::sleep_for(3 * Service::Notifier::POLL_INTERVAL);
+
+	{
+		std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+
+		CHECK(recorder->messages.empty());
+	}
+
+	CHECK(notifier->GetNumDropped() == 10);
+
+	notifier->SetReady(true);
+	CHECK(recorder->WaitFor(1));
+
+	std::lock_guard<std::mutex> guard(recorder->mutex); // recorder lock
+
+	CHECK(!recorder->messages.empty() && recorder->messages[0].compare(0, 10, "message 0\n") == 0);
+}
+
+int main()
+{
+	TestCoalesce();
+	TestLongMessage();
+	TestPacing();
+	TestRateLimited();
+	TestReadyAndDrop();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,99 @@
+#include <string>
+#include <string_view>
+
+#include <theater/parameter_view.h>
+
+#include "check.h"
+
+/**
+ * @brief Plain values end at a space, repeated keys return the last value.
+ */
+static void TestPlainValues()
+{
+	Theater::ParameterView parameter("TID=5  REGION-ID=1 FLAG BROKEN= MAX-PLAYERS=8 REGION-ID=2");
+
+	CHECK(parameter.size() == 5);
+	CHECK(parameter.Get("TID") == "5");
+	CHECK(parameter.Get("REGION-ID") == "2");
+	CHECK(parameter.Get("MAX-PLAYERS") == "8");
+	CHECK(parameter.Has("BROKEN"));
+	CHECK(parameter.Get("BROKEN").empty());
+	CHECK(!parameter.Has("FLAG"));
+	CHECK(!parameter.Has("NAME"));
+}
+
+/**
+ * @brief Quoted values keep their spaces, escapes and quotes.
+ */
+static void TestQuotedValues()
+{
+	Theater::ParameterView parameter(
+		"NAME=\"My Server\" HOST-PLAYER=\"Private \\\"Ryan\\\"\" MAP=\"C:\\\\maps\\\\pearl harbor\" "
+		"EMPTY=\"\" SPACES=\"  a  b  \" PORT=20004");
+
+	CHECK(parameter.size() == 6);
+	CHECK(parameter.Get("NAME") == "\"My Server\"");
+	CHECK(parameter.Get("HOST-PLAYER") == "\"Private \\\"Ryan\\\"\"");
+	CHECK(parameter.Get("MAP") == "\"C:\\\\maps\\\\pearl harbor\"");
+	CHECK(parameter.Get("EMPTY") == "\"\"");
+	CHECK(parameter.Get("SPACES") == "\"  a  b  \"");
+	CHECK(parameter.Get("PORT") == "20004");
+}
+
+/**
+ * @brief A quote inside a plain value does not start a quoted value.
+ */
+static void TestQuoteInsidePlainValue()
+{
+	Theater::ParameterView parameter("A=x\"y z\" B=1");
+
+	CHECK(parameter.Get("A") == "x\"y");
+	CHECK(parameter.Get("B") == "1");
+}
+
+/**
+ * @brief Data that ends in the middle of a quoted value or an escape.
+ */
+static void TestUnterminatedQuote()
+{
+	Theater::ParameterView unterminated("NAME=\"My Server B=1");
+
+	CHECK(unterminated.size() == 1);
+	CHECK(unterminated.Get("NAME") == "\"My Server B=1");
+
+	Theater::ParameterView escape("NAME=\"abc\\");
+
+	CHECK(escape.size() == 1);
+	CHECK(escape.Get("NAME") == "\"abc\\");
+}
+
+/**
+ * @brief Pairs beyond MAX_PARAMETERS are ignored.
+ */
+static void TestMaxParameters()
+{
+	std::string data;
+
+	for(size_t i = 0; i < Theater::ParameterView::MAX_PARAMETERS + 4; i++)
+	{
+		data += "K" + std::to_string(i) + "=" + std::to_string(i) + " ";
+	}
+
+	Theater::ParameterView parameter(data);
+
+	CHECK(parameter.size() == Theater::ParameterView::MAX_PARAMETERS);
+	CHECK(parameter.Get("K0") == "0");
+	CHECK(parameter.Has("K" + std::to_string(Theater::ParameterView::MAX_PARAMETERS - 1)));
+	CHECK(!parameter.Has("K" + std::to_string(Theater::ParameterView::MAX_PARAMETERS)));
+}
+
+int main()
+{
+	TestPlainValues();
+	TestQuotedValues();
+	TestQuoteInsidePlainValue();
+	TestUnterminatedQuote();
+	TestMaxParameters();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,173 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <settings.h>
+
+#include "check.h"
+
+/**
+ * @brief Parse settings from a JSON text.
+ */
+static bool Parse(const std::string& text, Settings& settings, std::string& error)
+{
+	Json::CharReaderBuilder builder;
+	Json::Value json;
+	std::istringstream stream(text);
+
+	if(!parseFromStream(builder, stream, &json, &error))
+	{
+		return false;
+	}
+
+	return Settings::FromJson(json, settings, error);
+}
+
+/**
+ * @brief Check that a settings file fails with an error.
+ */
+static void CheckInvalid(const std::string& text, const std::string& expected_error)
+{
+	Settings settings;
+	std::string error;
+
+	CHECK(!Parse(text, settings, error));
+
+	if(error != expected_error)
+	{
+		std::cerr << text << ": error \"" << error << "\", expected \"" << expected_error << "\"" << std::endl;
+	}
+
+	CHECK(error == expected_error);
+}
+
+/**
+ * @brief Missing keys keep their defaults.
+ */
+static void TestDefaults()
+{
+	Settings settings;
+	std::string error;
+
+	CHECK(Parse("{}", settings, error));
+	CHECK(Parse("{ \"theater\": {}, \"webserver\": {}, \"discord\": {} }", settings, error));
+
+	CHECK(settings.theater.port == 14300);
+	CHECK(settings.theater.threads == 2);
+	CHECK(settings.theater.send_queue_limit == 256 * 1024);
+	CHECK(settings.theater.connection_time_out == 60);
+	CHECK(!settings.theater.binary_log);
+	CHECK(settings.theater.binary_log_segment_size == 64 * 1024 * 1024);
+	CHECK(settings.webserver.port == 8080);
+	CHECK(settings.webserver.threads == 1);
+	CHECK(settings.webserver.password.empty());
+	CHECK(settings.discord.channel == "mohrs-matchmaker");
+	CHECK(!settings.show_client_connect);
+}
+
+/**
+ * @brief Every key is read into its field.
+ */
+static void TestValues()
+{
+	Settings settings;
+	std::string error;
+
+	CHECK(Parse(R"({
+		"theater": { "port": 1, "threads": 256, "send_queue_limit": 2147483647, "connection_time_out": 86400,
+		             "show_requests": true, "show_responses": true, "binary_log": true, "binary_log_segment_size": 4294967295 },
+		"webserver": { "port": 65535, "threads": 3, "send_queue_limit": 1, "connection_time_out": 1, "password": "secret" },
+		"discord": { "token": "abc", "channel": "lobby" },
+		"show_client_connect": true,
+		"show_client_disconnect": true
+	})", settings, error));
+
+	CHECK(error.empty());
+	CHECK(settings.theater.port == 1);
+	CHECK(settings.theater.threads == 256);
+	CHECK(settings.theater.send_queue_limit == INT32_MAX);
+	CHECK(settings.theater.connection_time_out == 86400);
+	CHECK(settings.theater.show_requests);
+	CHECK(settings.theater.show_responses);
+	CHECK(settings.theater.binary_log);
+	CHECK(settings.theater.binary_log_segment_size == UINT32_MAX);
+	CHECK(settings.webserver.port == 65535);
+	CHECK(settings.webserver.threads == 3);
+	CHECK(settings.webserver.send_queue_limit == 1);
+	CHECK(settings.webserver.connection_time_out == 1);
+	CHECK(!settings.webserver.show_requests);
+	CHECK(settings.webserver.password == "secret");
+	CHECK(settings.discord.token == "abc");
+	CHECK(settings.discord.channel == "lobby");
+	CHECK(settings.show_client_connect);
+	CHECK(settings.show_client_disconnect);
+}
+
+/**
+ * @brief Wrong types and values out of range name the key.
+ */
+static void TestInvalid()
+{
+	CheckInvalid("[]", "settings must be an object");
+	CheckInvalid("{ \"theater\": 5 }", "theater must be an object");
+	CheckInvalid("{ \"discord\": \"token\" }", "discord must be an object");
+
+	const std::string port_error = "theater.port must be a number from 1 till 65535";
+
+	CheckInvalid("{ \"theater\": { \"port\": 0 } }", port_error);
+	CheckInvalid("{ \"theater\": { \"port\": -1 } }", port_error);
+	CheckInvalid("{ \"theater\": { \"port\": 65536 } }", port_error);
+	CheckInvalid("{ \"theater\": { \"port\": 1.5 } }", port_error);
+	CheckInvalid("{ \"theater\": { \"port\": \"14300\" } }", port_error);
+	CheckInvalid("{ \"theater\": { \"port\": 18446744073709551615 } }", port_error);
+
+	CheckInvalid("{ \"webserver\": { \"threads\": 257 } }", "webserver.threads must be a number from 1 till 256");
+	CheckInvalid("{ \"webserver\": { \"send_queue_limit\": 2147483648 } }", "webserver.send_queue_limit must be a number from 1 till 2147483647");
+	CheckInvalid("{ \"theater\": { \"connection_time_out\": 86401 } }", "theater.connection_time_out must be a number from 1 till 86400");
+	CheckInvalid("{ \"theater\": { \"binary_log_segment_size\": 1048575 } }",
+	             "theater.binary_log_segment_size must be a number from 1048576 till 4294967295");
+	CheckInvalid("{ \"theater\": { \"binary_log_segment_size\": 4294967296 } }",
+	             "theater.binary_log_segment_size must be a number from 1048576 till 4294967295");
+
+	CheckInvalid("{ \"theater\": { \"show_requests\": 1 } }", "theater.show_requests must be true or false");
+	CheckInvalid("{ \"show_client_connect\": \"yes\" }", "settings.show_client_connect must be true or false");
+	CheckInvalid("{ \"webserver\": { \"password\": 1234 } }", "webserver.password must be a string");
+	CheckInvalid("{ \"discord\": { \"channel\": null } }", "discord.channel must be a string");
+}
+
+/**
+ * @brief The example settings file is valid.
+ */
+static void TestExample(const char* path)
+{
+	std::ifstream file(path);
+	std::stringstream text;
+	Settings settings;
+	std::string error;
+
+	CHECK(file.is_open());
+
+	text << file.rdbuf();
+
+	CHECK(Parse(text.str(), settings, error));
+
+	if(!error.empty())
+	{
+		std::cerr << path << ": " << error << std::endl;
+	}
+}
+
+int main(int argc, char const* argv[])
+{
+	TestDefaults();
+	TestValues();
+	TestInvalid();
+
+	// Usage: test_settings [settings.example.json]
+	if(argc > 1)
+	{
+		TestExample(argv[1]);
+	}
+
+	return CHECK_RESULT();
+}
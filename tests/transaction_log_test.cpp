@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <csignal>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include <theater/transaction_log.h>
+
+#include "check.h"
+
+using namespace Theater::TransactionLogFormat;
+
+/**
+ * @brief A record read back from a segment.
+ */
+struct Record
+{
+	uint64_t    connection;
+	Direction   direction;
+	std::string action;
+	std::string frame;
+};
+
+/**
+ * @brief Read the records of a segment like mohrs-logdump does.
+ */
+static std::vector<Record> ReadSegment(const std::filesystem::path& path, uint64_t& sequence)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::vector<Record> records;
+	SegmentHeader segment;
+
+	CHECK(data.size() >= sizeof(segment));
+
+	if(data.size() < sizeof(segment))
+	{
+		return records;
+	}
+
+	std::memcpy(&segment, data.data(), sizeof(segment));
+
+	CHECK(std::memcmp(segment.magic, MAGIC, sizeof(MAGIC)) == 0);
+	CHECK(segment.version == VERSION);
+	CHECK(segment.header_size == sizeof(segment));
+
+	sequence = segment.sequence;
+
+	size_t offset = segment.header_size;
+	bool ended = false;
+
+	while(offset + sizeof(RecordHeader) <= data.size())
+	{
+		RecordHeader header;
+		std::memcpy(&header, data.data() + offset, sizeof(header));
+
+		if(header.size == 0)
+		{
+			ended = true;
+			break;
+		}
+
+		CHECK(offset + GetRecordSize(header.size) <= data.size());
+
+		if(offset + GetRecordSize(header.size) > data.size())
+		{
+			break;
+		}
+
+		Record record;
+		record.connection = header.connection;
+		record.direction = static_cast<Direction>(header.direction);
+		record.action = std::string(header.action, sizeof(header.action));
+		record.frame = std::string(data.data() + offset + sizeof(header), header.size);
+
+		// The padding is zero
+		for(size_t i = sizeof(header) + header.size; i < GetRecordSize(header.size); i++)
+		{
+			CHECK(data[offset + i] == 0);
+		}
+
+		records.push_back(record);
+		offset += GetRecordSize(header.size);
+	}
+
+	CHECK(ended);
+
+	return records;
+}
+
+/**
+ * @brief Read every segment in a directory in sequence order.
+ */
+static std::vector<Record> ReadSegments(const std::filesystem::path& directory, size_t& num_segments)
+{
+	std::vector<std::filesystem::path> paths;
+	std::vector<Record> records;
+
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+	{
+		paths.push_back(entry.path());
+	}
+
+	// The sequence number is the end of the name
+	std::sort(paths.begin(), paths.end());
+
+	for(size_t i = 0; i < paths.size(); i++)
+	{
+		uint64_t sequence = 0;
+		std::vector<Record> segment = ReadSegment(paths[i], sequence);
+
+		CHECK(sequence == i);
+		records.insert(records.end(), segment.begin(), segment.end());
+	}
+
+	num_segments = paths.size();
+
+	return records;
+}
+
+/**
+ * @brief Create an empty directory for the segments.
+ */
+static std::filesystem::path MakeDirectory(const std::string& name)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / ("mohrs-" + name + "-" + std::to_string(getpid()));
+
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	return directory;
+}
+
+/**
+ * @brief Frames come back with their connection, direction and action, in order.
+ */
+static void TestRoundTrip()
+{
+	std::filesystem::path directory = MakeDirectory("txl-round-trip");
+	std::vector<Record> expected =
+	{
+		{ 1, Direction::Request,  "CONN", std::string("CONN\x40\0\0\0\0\0\0\x1a", 12) + "TID=1 PROT=2" },
+		{ 1, Direction::Response, "CONN", std::string("CONN\0\0\0\0\0\0\0\x0c", 12) },
+		{ 7, Direction::Request,  "CGAM", std::string("CGAM\x40\0\0\0\0\0\0\x25", 12) + "NAME=\"Pearl Harbor\" \xff\x01" },
+		{ 7, Direction::Request,  "UG",   "UG" },
+	};
+
+	Theater::TransactionLog* log = new Theater::TransactionLog(directory.string(), 0);
+
+	for(const Record& record : expected)
+	{
+		log->Append(record.connection, record.direction, record.frame);
+	}
+
+	// A segment that was not closed cleanly ends in zeros
+	size_t num_segments = 0;
+	std::vector<Record> records = ReadSegments(directory, num_segments);
+
+	CHECK(num_segments == 1);
+	CHECK(records.size() == expected.size());
+
+	delete log;
+
+	// A closed segment is cut after its end marker
+	records = ReadSegments(directory, num_segments);
+
+	CHECK(num_segments == 1);
+	CHECK(records.size() == expected.size());
+
+	for(size_t i = 0; i < std::min(records.size(), expected.size()); i++)
+	{
+		CHECK(records[i].connection == expected[i].connection);
+		CHECK(records[i].direction == expected[i].direction);
+		CHECK(records[i].frame == expected[i].frame);
+		CHECK(records[i].action.compare(0, expected[i].action.size(), expected[i].action) == 0);
+	}
+
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+	{
+		CHECK(entry.file_size() == sizeof(SegmentHeader) + GetRecordSize(12 + 12) + GetRecordSize(12) +
+		                           GetRecordSize(12 + 22) + GetRecordSize(2) + sizeof(RecordHeader));
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief A full segment is closed and the records go on in the next one.
+ */
+static void TestSegments()
+{
+	std::filesystem::path directory = MakeDirectory("txl-segments");
+	Theater::TransactionLog* log = new Theater::TransactionLog(directory.string(), Theater::TransactionLog::MIN_SEGMENT_SIZE);
+	const size_t num_frames = 100;
+
+	for(size_t i = 0; i < num_frames; i++)
+	{
+		log->Append(i, Direction::Request, "UGAM" + std::string(30000, static_cast<char>('a' + i % 26)));
+	}
+
+	CHECK(log->GetNumRecords() == num_frames);
+	CHECK(log->GetNumDropped() == 0);
+	CHECK(log->GetNumSegments() == 3);
+
+	// Too big for any segment
+	log->Append(0, Direction::Request, std::string(Theater::TransactionLog::MIN_SEGMENT_SIZE, 'x'));
+	CHECK(log->GetNumDropped() == 1);
+
+	delete log;
+
+	size_t num_segments = 0;
+	std::vector<Record> records = ReadSegments(directory, num_segments);
+
+	CHECK(num_segments == 3);
+	CHECK(records.size() == num_frames);
+
+	for(size_t i = 0; i < records.size(); i++)
+	{
+		CHECK(records[i].connection == i);
+		CHECK(records[i].frame.size() == 4 + 30000);
+		CHECK(records[i].frame.back() == static_cast<char>('a' + i % 26));
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief The blocks of a segment are reserved, a segment that does not fit drops the records.
+ */
+static void TestReserve()
+{
+	std::filesystem::path directory = MakeDirectory("txl-reserve");
+	Theater::TransactionLog* log = new Theater::TransactionLog(directory.string(), Theater::TransactionLog::MIN_SEGMENT_SIZE);
+
+	log->Append(1, Direction::Request, "UGAM");
+
+	// Not a sparse file, writing into the mapping never needs a new block
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+	{
+		struct stat status;
+
+		CHECK(stat(entry.path().c_str(), &status) == 0);
+		CHECK(static_cast<size_t>(status.st_blocks) * 512 >= Theater::TransactionLog::MIN_SEGMENT_SIZE);
+	}
+
+	delete log;
+	std::filesystem::remove_all(directory);
+
+	directory = MakeDirectory("txl-no-space");
+	rlimit limit;
+
+	// Files may not grow past half a segment, like a disk that is almost full
+	std::signal(SIGXFSZ, SIG_IGN);
+	getrlimit(RLIMIT_FSIZE, &limit);
+
+	rlimit small = limit;
+	small.rlim_cur = Theater::TransactionLog::MIN_SEGMENT_SIZE / 2;
+	CHECK(setrlimit(RLIMIT_FSIZE, &small) == 0);
+
+	log = new Theater::TransactionLog(directory.string(), Theater::TransactionLog::MIN_SEGMENT_SIZE);
+
+	log->Append(1, Direction::Request, "UGAM");
+	log->Append(1, Direction::Request, "UGAM");
+
+	CHECK(log->GetNumRecords() == 0);
+	CHECK(log->GetNumDropped() == 2);
+	CHECK(log->GetNumSegments() == 0);
+	CHECK(std::filesystem::is_empty(directory));
+
+	delete log;
+
+	setrlimit(RLIMIT_FSIZE, &limit);
+	std::signal(SIGXFSZ, SIG_DFL);
+
+	std::filesystem::remove_all(directory);
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestSegments();
+	TestReserve();
+
+	return CHECK_RESULT();
+}
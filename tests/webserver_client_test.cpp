@@ -0,0 +1,98 @@
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <globals.h>
+#include <settings.h>
+#include <webserver/client.h>
+
+#include "check.h"
+
+/**
+ * @brief Read the response that is waiting on the socket.
+ */
+static std::string ReadResponse(int socket)
+{
+	char buffer[4096];
+	ssize_t recv_size = recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+	return (recv_size > 0) ? std::string(buffer, recv_size) : std::string();
+}
+
+/**
+ * @brief Send a request in parts, only the last part completes it.
+ * @return True if the client answered the request after the last part and not before.
+ */
+static bool SendInParts(const std::vector<std::string>& parts)
+{
+	int sockets[2];
+
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+	CHECK(fcntl(sockets[0], F_SETFL, O_NONBLOCK) == 0);
+
+	// Never destroyed, disconnecting needs the webserver
+	Webserver::Client* client = new Webserver::Client(sockets[0], sockaddr_in());
+	bool answered_early = false;
+
+	for(size_t i = 0; i + 1 < parts.size(); i++)
+	{
+		CHECK(write(sockets[1], parts[i].data(), parts[i].size()) == static_cast<ssize_t>(parts[i].size()));
+
+		// An incomplete request keeps the connection and is not answered
+		CHECK(client->onReadable());
+
+		answered_early |= !ReadResponse(sockets[1]).empty();
+	}
+
+	CHECK(write(sockets[1], parts.back().data(), parts.back().size()) == static_cast<ssize_t>(parts.back().size()));
+
+	client->onReadable();
+
+	std::string response = ReadResponse(sockets[1]);
+
+	close(sockets[1]);
+
+	return !answered_early && response.compare(0, 12, "HTTP/1.1 200") == 0;
+}
+
+int main()
+{
+	Settings settings;
+
+	g_settings.store(&settings);
+
+	// Complete in a single read
+	CHECK(SendInParts({ "GET /favicon.ico HTTP/1.1\r\nHost: localhost\r\n\r\n" }));
+
+	// The header arrives in several reads
+	CHECK(SendInParts({ "GET /favicon.ico HT", "TP/1.1\r\nHost: local", "host\r\n\r", "\n" }));
+
+	// The body given by Content-Length arrives after the header
+	CHECK(SendInParts({ "GET /favicon.ico HTTP/1.1\r\ncontent-length: 4\r\n\r\n", "ab", "cd" }));
+
+	// A request larger than the limit closes the connection
+	int sockets[2];
+
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+	CHECK(fcntl(sockets[0], F_SETFL, O_NONBLOCK) == 0);
+
+	Webserver::Client* client = new Webserver::Client(sockets[0], sockaddr_in());
+	std::string header = "GET /favicon.ico HTTP/1.1\r\nContent-Length: 1000000\r\n\r\n";
+
+	CHECK(write(sockets[1], header.data(), header.size()) == static_cast<ssize_t>(header.size()));
+	CHECK(!client->onReadable());
+
+	// A client that closes before its request is complete is disconnected
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+	CHECK(fcntl(sockets[0], F_SETFL, O_NONBLOCK) == 0);
+
+	client = new Webserver::Client(sockets[0], sockaddr_in());
+
+	CHECK(write(sockets[1], "GET / HTTP/1.1\r\n", 16) == 16);
+	CHECK(shutdown(sockets[1], SHUT_WR) == 0);
+	CHECK(!client->onReadable());
+
+	return CHECK_RESULT();
+}
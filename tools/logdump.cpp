@@ -0,0 +1,283 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <charconv>
+
+#include <theater/transaction_log.h>
+
+using namespace Theater::TransactionLogFormat;
+
+/**
+ * @brief Which records to print and how.
+ */
+struct Options
+{
+	bool        json = false;           /**< One JSON object per line instead of text. */
+	bool        has_connection = false;
+	uint64_t    connection = 0;         /**< Only records of this connection. */
+	std::string action;                 /**< Only records with this FourCC, empty for all. */
+	int         direction = -1;         /**< Only records in this direction, -1 for both. */
+};
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: mohrs-logdump [options] <segment.txl>...\n"
+	          << "Decodes binary Theater transaction log segments.\n"
+	          << "\n"
+	          << "  --json                  Print one JSON object per record\n"
+	          << "  --connection <handle>   Only records of a connection\n"
+	          << "  --action <FOURCC>       Only records of an action, e.g. CGAM\n"
+	          << "  --direction <in|out>    Only requests (in) or responses (out)\n";
+}
+
+/**
+ * @brief Parse a whole argument as a decimal number.
+ * @return False if it is empty, not a number, out of range or followed by other characters.
+ */
+static bool ParseNumber(std::string_view str, uint64_t& value)
+{
+	std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value);
+
+	return !str.empty() && result.ec == std::errc() && result.ptr == str.data() + str.size();
+}
+
+/**
+ * @brief Format nanoseconds since the epoch as UTC date and time with microseconds.
+ */
+static std::string FormatTime(uint64_t time)
+{
+	std::time_t seconds = static_cast<std::time_t>(time / 1000000000);
+	std::tm time_info;
+	char buffer[32];
+	char result[48];
+
+	gmtime_r(&seconds, &time_info);
+	std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &time_info);
+	std::snprintf(result, sizeof(result), "%s.%06lluZ", buffer, static_cast<unsigned long long>((time % 1000000000) / 1000));
+
+	return result;
+}
+
+/**
+ * @brief Escape a frame so every byte can be recovered.
+ * @param json Use JSON escapes instead of C escapes.
+ */
+static std::string Escape(std::string_view data, bool json)
+{
+	std::string result;
+	char buffer[8];
+
+	result.reserve(data.size());
+
+	for(unsigned char c : data)
+	{
+		if(c == '\\' || (json && c == '"'))
+		{
+			result += '\\';
+			result += static_cast<char>(c);
+		}
+		else if(c >= 0x20 && c < 0x7F)
+		{
+			result += static_cast<char>(c);
+		}
+		else
+		{
+			std::snprintf(buffer, sizeof(buffer), json ? "\\u%04x" : "\\x%02x", c);
+			result += buffer;
+		}
+	}
+
+	return result;
+}
+
+static bool Matches(const RecordHeader& record, const Options& options)
+{
+	if(options.has_connection && record.connection != options.connection)
+	{
+		return false;
+	}
+
+	if(!options.action.empty() && std::string_view(record.action, sizeof(record.action)) != options.action)
+	{
+		return false;
+	}
+
+	if(options.direction != -1 && record.direction != options.direction)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+static void Print(const RecordHeader& record, std::string_view frame, const Options& options)
+{
+	std::string action = Escape(std::string_view(record.action, sizeof(record.action)), options.json);
+	bool request = (record.direction == static_cast<uint8_t>(Direction::Request));
+
+	if(options.json)
+	{
+		std::cout << "{\"time\":\"" << FormatTime(record.time) << "\""
+		          << ",\"connection\":" << record.connection
+		          << ",\"direction\":\"" << (request ? "request" : "response") << "\""
+		          << ",\"action\":\"" << action << "\""
+		          << ",\"size\":" << record.size
+		          << ",\"payload\":\"" << Escape(frame, true) << "\"}\n";
+	}
+	else
+	{
+		std::cout << FormatTime(record.time) << " #" << record.connection << " "
+		          << (request ? "-->" : "<--") << " " << action << " " << Escape(frame, false) << '\n';
+	}
+}
+
+/**
+ * @brief Print the matching records of a segment.
+ * @return False if the file is not a valid segment.
+ */
+static bool Dump(const std::string& path, const Options& options)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if(!file.is_open())
+	{
+		std::cerr << path << ": can't open file\n";
+		return false;
+	}
+
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	SegmentHeader segment;
+
+	if(data.size() < sizeof(segment))
+	{
+		std::cerr << path << ": not a transaction log segment\n";
+		return false;
+	}
+
+	std::memcpy(&segment, data.data(), sizeof(segment));
+
+	if(std::memcmp(segment.magic, MAGIC, sizeof(MAGIC)) != 0 || segment.header_size < sizeof(segment))
+	{
+		std::cerr << path << ": not a transaction log segment\n";
+		return false;
+	}
+
+	if(segment.version != VERSION)
+	{
+		std::cerr << path << ": unsupported version " << segment.version << "\n";
+		return false;
+	}
+
+	size_t offset = segment.header_size;
+
+	while(offset + sizeof(RecordHeader) <= data.size())
+	{
+		RecordHeader record;
+		std::memcpy(&record, data.data() + offset, sizeof(record));
+
+		// End of the segment
+		if(record.size == 0)
+		{
+			break;
+		}
+
+		if(offset + GetRecordSize(record.size) > data.size())
+		{
+			std::cerr << path << ": truncated record at offset " << offset << "\n";
+			return false;
+		}
+
+		if(Matches(record, options))
+		{
+			Print(record, std::string_view(data.data() + offset + sizeof(record), record.size), options);
+		}
+
+		offset += GetRecordSize(record.size);
+	}
+
+	return true;
+}
+
+int main(int argc, char const* argv[])
+{
+	Options options;
+	std::vector<std::string> paths;
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+
+		if(arg == "--json")
+		{
+			options.json = true;
+		}
+		else if(arg == "--connection" && has_value)
+		{
+			options.has_connection = true;
+
+			if(!ParseNumber(argv[++i], options.connection))
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		else if(arg == "--action" && has_value)
+		{
+			options.action = argv[++i];
+		}
+		else if(arg == "--direction" && has_value)
+		{
+			std::string direction = argv[++i];
+
+			if(direction == "in")
+			{
+				options.direction = static_cast<int>(Direction::Request);
+			}
+			else if(direction == "out")
+			{
+				options.direction = static_cast<int>(Direction::Response);
+			}
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		else if(arg.size() > 1 && arg[0] == '-')
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+		else
+		{
+			paths.push_back(arg);
+		}
+	}
+
+	if(paths.empty())
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	int result = EXIT_SUCCESS;
+
+	for(const std::string& path : paths)
+	{
+		if(!Dump(path, options))
+		{
+			result = EXIT_FAILURE;
+		}
+	}
+
+	return result;
+}